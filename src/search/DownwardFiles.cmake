@@ -75,12 +75,13 @@ fast_downward_plugin(
         search_progress
         search_space
         search_statistics
+        sharded_state_registry
         state_id
         state_registry
         task_id
         task_proxy
 
-    DEPENDS CAUSAL_GRAPH INT_HASH_SET INT_PACKER ORDERED_SET SEGMENTED_VECTOR SUBSCRIBER SUCCESSOR_GENERATOR TASK_PROPERTIES
+    DEPENDS CAUSAL_GRAPH COMPILED_EFFECTS INT_HASH_SET INT_PACKER ORDERED_SET SEGMENTED_VECTOR SUBSCRIBER SUCCESSOR_GENERATOR TASK_PROPERTIES ZOBRIST_HASH
     CORE_PLUGIN
 )
 
@@ -363,6 +364,14 @@ fast_downward_plugin(
     DEPENDS EAGER_SEARCH SEARCH_COMMON
 )
 
+fast_downward_plugin(
+    NAME PARALLEL_EAGER_SEARCH
+    HELP "Hash distributed parallel A* search"
+    SOURCES
+        search_engines/parallel_eager_search
+    DEPENDS NULL_PRUNING_METHOD SEARCH_COMMON SUCCESSOR_GENERATOR
+)
+
 fast_downward_plugin(
     NAME PLUGIN_EAGER
     HELP "Eager (i.e., normal) best-first search"
@@ -419,6 +428,14 @@ fast_downward_plugin(
     DEPENDS G_EVALUATOR ORDERED_SET PREF_EVALUATOR SEARCH_COMMON SUCCESSOR_GENERATOR
 )
 
+fast_downward_plugin(
+    NAME REGISTRY_BENCHMARK
+    HELP "Throughput benchmark for the sharded state registry"
+    SOURCES
+        search_engines/registry_benchmark
+    DEPENDS SUCCESSOR_GENERATOR
+)
+
 fast_downward_plugin(
     NAME ITERATED_SEARCH
     HELP "Iterated search algorithm"
@@ -572,6 +589,15 @@ fast_downward_plugin(
     DEPENDENCY_ONLY
 )
 
+fast_downward_plugin(
+    NAME COMPILED_EFFECTS
+    HELP "Operator effects compiled to packed-state writes"
+    SOURCES
+        task_utils/compiled_effects
+    DEPENDS INT_PACKER TASK_PROPERTIES
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME SUCCESSOR_GENERATOR
     HELP "Successor generator"
@@ -591,6 +617,15 @@ fast_downward_plugin(
     DEPENDENCY_ONLY
 )
 
+fast_downward_plugin(
+    NAME ZOBRIST_HASH
+    HELP "Zobrist hashing of packed states"
+    SOURCES
+        task_utils/zobrist_hash
+    DEPENDS INT_PACKER TASK_PROPERTIES
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME VARIABLE_ORDER_FINDER
     HELP "Variable order finder"
@@ -768,11 +803,21 @@ fast_downward_plugin(
         real_time/solve_all
         real_time/astar_solve_all
         real_time/rt_solve_all
+        real_time/sample_file
+        real_time/sample_writer
+        real_time/hstar_histogram
+        real_time/hstar_sampler
         real_time/debiased_heuristic
         real_time/decision
         real_time/scalar_decider
         real_time/dist_decider
+        real_time/flat_index_map
+        real_time/indexed_heap
+        real_time/lookahead_arena
         real_time/learning
+        real_time/async_worker
+        real_time/parallel_for
+        real_time/parallel_evaluation
         real_time/dijkstra_backup
         real_time/nancy_backup
         real_time/expansion_delay
@@ -781,8 +826,10 @@ fast_downward_plugin(
         real_time/lookhead_search
         real_time/bound
         real_time/max_expansions
-        real_time/lap_timer
         real_time/max_time
+        real_time/deadline_checker
+        real_time/latency_histogram
+        real_time/step_timeline
         real_time/search_ctrl
         real_time/state_collector
         real_time/real_time_search
@@ -791,10 +838,15 @@ fast_downward_plugin(
         real_time/rts_step
         real_time/util
 	real_time/vec_stats
+        real_time/mapped_file
         real_time/belief_data
+        real_time/belief_pool
         real_time/belief_store
         real_time/DiscreteDistribution
+        real_time/compact_belief
         real_time/tlas
+        real_time/risk_kernel
+        real_time/risk_kernel_benchmark
         real_time/risk_search
 	real_time/online_risk_search
 	real_time/online_nancy_decider
@@ -120,7 +120,7 @@ class IntHashSet {
         buckets.resize(new_capacity);
         for (const Bucket &bucket : old_buckets) {
             if (bucket.full()) {
-                insert(bucket.key, bucket.hash);
+                insert_hashed(bucket.key, bucket.hash);
             }
         }
         utils::unused_variable(num_entries_before);
@@ -201,10 +201,10 @@ class IntHashSet {
 
       For the return type, see the public insert() method.
 
-      Note that the private insert() may call enlarge() and therefore rehash(),
-      which itself calls the private insert() again.
+      Note that insert_hashed() may call enlarge() and therefore rehash(),
+      which itself calls insert_hashed() again.
     */
-    std::pair<KeyType, bool> insert(KeyType key, HashType hash) {
+    std::pair<KeyType, bool> insert_hashed(KeyType key, HashType hash) {
         assert(hasher(key) == hash);
 
         /* If the hash set already contains the key, return the key and a
@@ -256,7 +256,7 @@ class IntHashSet {
                 /* Free bucket could not be moved close enough to ideal bucket.
                    -> Enlarge and try inserting again. */
                 enlarge();
-                return insert(key, hash);
+                return insert_hashed(key, hash);
             }
         }
         assert(utils::in_bounds(free_index, buckets));
@@ -310,6 +310,28 @@ public:
         return insert(key, hasher(key));
     }
 
+    /*
+      Like insert(key), for callers that already computed the hash of the
+      key. The hash must be the one the hasher would compute.
+    */
+    std::pair<KeyType, bool> insert(KeyType key, HashType hash) {
+        assert(key >= 0);
+        return insert_hashed(key, hash);
+    }
+
+    /*
+      Hint that a key with the given hash will be inserted or looked up
+      soon. Inserting a batch of keys after prefetching all of their
+      buckets overlaps the cache misses on the buckets.
+    */
+    void prefetch(HashType hash) const {
+#ifdef __GNUC__
+        __builtin_prefetch(&buckets[get_bucket(hash)]);
+#else
+        utils::unused_variable(hash);
+#endif
+    }
+
     void dump() const {
         int num_buckets = capacity();
         std::cout << "[";
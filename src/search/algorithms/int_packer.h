@@ -34,6 +34,11 @@ public:
 	~VariableInfo();
 	int get(const Bin *buffer) const;
 	void set(Bin *buffer, int value) const;
+
+	int get_bin_index() const {return bin_index;}
+	int get_shift() const {return shift;}
+	Bin get_read_mask() const {return read_mask;}
+	Bin get_clear_mask() const {return clear_mask;}
 };
 
 class IntPacker {
@@ -58,6 +63,14 @@ public:
     void set(Bin *buffer, int var, int value) const;
 
     int get_num_bins() const {return num_bins;}
+
+    /*
+      Where the variable lives in the packed buffer, for code that
+      manipulates whole bins instead of going through get and set.
+    */
+    const VariableInfo &get_variable_info(int var) const {
+        return var_infos[var];
+    }
 };
 }
 
@@ -3,6 +3,8 @@
 
 #include "../utils/collections.h"
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <iostream>
 #include <queue>
@@ -12,7 +14,9 @@
 /*
   We define three priority queue classes here: HeapQueue (heap-based),
   BucketQueue (bucket-based), and AdaptiveQueue (starts out bucket-based,
-  transforms into heap-based if that seems to make sense).
+  transforms into heap-based if that seems to make sense). In addition,
+  RadixHeap is a monotone queue for Dijkstra-like algorithms with
+  non-negative integer keys that can be very large.
 
   More precisely, an AdaptiveQueue is converted from a BucketQueue to
   a HeapQueue when the number of required buckets exceeds both
@@ -267,6 +271,105 @@ public:
         wrapped_queue->add_virtual_pushes(num_extra_pushes);
     }
 };
+
+
+/*
+  Monotone radix heap (Ahuja, Mehlhorn, Orlin and Tarjan, 1990).
+
+  Keys must be non-negative and no smaller than the key that was popped
+  last (since the last clear()), which holds for Dijkstra-like
+  algorithms with non-negative costs. Entries are kept in one bucket per
+  bit position: bucket 0 holds the entries whose key equals the last
+  popped key, and bucket i > 0 those whose key first differs from it in
+  bit i - 1. Each entry moves to a lower bucket at most once per bit, so
+  push is O(1) and pop is amortized O(log C) for keys up to C, without
+  any comparisons on push. Unlike BucketQueue, the memory does not grow
+  with the size of the keys.
+
+  Entries with equal keys are popped in an unspecified order.
+*/
+template<typename Value>
+class RadixHeap {
+public:
+    typedef std::pair<int, Value> Entry;
+private:
+    static const int NUM_BUCKETS = 33;
+
+    std::array<std::vector<Entry>, NUM_BUCKETS> buckets;
+    unsigned int last_key;
+    int num_entries;
+
+    int get_bucket(unsigned int key) const {
+        unsigned int differing_bits = key ^ last_key;
+        if (differing_bits == 0)
+            return 0;
+#ifdef __GNUC__
+        return 32 - __builtin_clz(differing_bits);
+#else
+        int bucket = 0;
+        for (; differing_bits != 0; differing_bits >>= 1)
+            ++bucket;
+        return bucket;
+#endif
+    }
+
+    void refill_first_bucket() {
+        int bucket_no = 1;
+        while (buckets[bucket_no].empty())
+            ++bucket_no;
+        std::vector<Entry> &bucket = buckets[bucket_no];
+        last_key = bucket.front().first;
+        for (const Entry &entry : bucket)
+            last_key = std::min(last_key, static_cast<unsigned int>(entry.first));
+        /*
+          All entries now differ from the new last key in a lower bit
+          than before, so none of them ends up in this bucket again.
+        */
+        for (const Entry &entry : bucket)
+            buckets[get_bucket(entry.first)].push_back(entry);
+        bucket.clear();
+    }
+
+    // Forbid assigning or copying -- would need to implement them properly.
+    RadixHeap &operator=(const RadixHeap<Value> &);
+    RadixHeap(const RadixHeap<Value> &);
+public:
+    RadixHeap() : last_key(0), num_entries(0) {
+    }
+
+    void push(int key, const Value &value) {
+        assert(key >= 0);
+        assert(static_cast<unsigned int>(key) >= last_key);
+        buckets[get_bucket(key)].emplace_back(key, value);
+        ++num_entries;
+    }
+
+    Entry pop() {
+        assert(num_entries > 0);
+        if (buckets[0].empty())
+            refill_first_bucket();
+        Entry result = buckets[0].back();
+        buckets[0].pop_back();
+        --num_entries;
+        return result;
+    }
+
+    bool empty() const {
+        return num_entries == 0;
+    }
+
+    int size() const {
+        return num_entries;
+    }
+
+    // Keeps the memory of the buckets.
+    void clear() {
+        for (std::vector<Entry> &bucket : buckets)
+            bucket.clear();
+        last_key = 0;
+        num_entries = 0;
+    }
+};
 }
 
 #endif
@@ -85,6 +85,16 @@ public:
           the_size(0) {
     }
 
+	// Swaps the contents, so the entries of this vector are freed
+	// along with sv.
+	SegmentedVector &operator=(SegmentedVector<Entry> &&sv)
+	{
+		std::swap(entry_allocator, sv.entry_allocator);
+		segments.swap(sv.segments);
+		std::swap(the_size, sv.the_size);
+		return *this;
+	}
+
     ~SegmentedVector() {
         for (size_t i = 0; i < the_size; ++i) {
             entry_allocator.destroy(&operator[](i));
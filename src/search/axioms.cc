@@ -49,7 +49,8 @@ public:
     }
 };
 
-AxiomEvaluator::AxiomEvaluator(const TaskProxy &task_proxy) {
+AxiomEvaluator::AxiomEvaluator(const TaskProxy &task_proxy)
+    : current_stamp(0) {
     task_has_axioms = task_properties::has_axioms(task_proxy);
     if (task_has_axioms) {
         VariablesProxy variables = task_proxy.get_variables();
@@ -78,6 +79,7 @@ AxiomEvaluator::AxiomEvaluator(const TaskProxy &task_proxy) {
                 int val = condition.get_value();
                 AxiomRule *rule = &rules[axiom.get_id()];
                 axiom_literals[var_id][val].condition_of.push_back(rule);
+                rule->conditions.emplace_back(var_id, val);
             }
         }
 
@@ -109,6 +111,67 @@ AxiomEvaluator::AxiomEvaluator(const TaskProxy &task_proxy) {
             else
                 default_values.emplace_back(-1);
         }
+
+        compute_affected_variables(task_proxy);
+    }
+}
+
+void AxiomEvaluator::compute_affected_variables(const TaskProxy &task_proxy) {
+    VariablesProxy variables = task_proxy.get_variables();
+    int num_variables = variables.size();
+    int num_derived_variables = 0;
+    axiom_layers.reserve(num_variables);
+    for (VariableProxy var : variables) {
+        axiom_layers.push_back(var.get_axiom_layer());
+        if (var.is_derived())
+            ++num_derived_variables;
+    }
+
+    rules_by_effect_var.resize(num_variables);
+    // The derived variables with a rule conditioned on each variable.
+    vector<vector<int>> dependents(num_variables);
+    for (AxiomRule &rule : rules) {
+        rules_by_effect_var[rule.effect_var].push_back(&rule);
+        for (const FactPair &condition : rule.conditions)
+            dependents[condition.var].push_back(rule.effect_var);
+    }
+
+    /*
+      If an operator affects most derived variables, checking which of
+      them it affects costs more than it saves.
+    */
+    size_t max_affected = num_derived_variables / 2;
+    affected_stamps.assign(num_variables, 0);
+    OperatorsProxy operators = task_proxy.get_operators();
+    affected_variables.resize(operators.size());
+    needs_full_evaluation.resize(operators.size(), false);
+    vector<int> stack;
+    for (OperatorProxy op : operators) {
+        vector<int> &affected = affected_variables[op.get_id()];
+        ++current_stamp;
+        for (EffectProxy effect : op.get_effects()) {
+            stack.push_back(effect.get_fact().get_variable().get_id());
+            while (!stack.empty() && affected.size() <= max_affected) {
+                int var = stack.back();
+                stack.pop_back();
+                for (int dependent : dependents[var]) {
+                    if (affected_stamps[dependent] != current_stamp) {
+                        affected_stamps[dependent] = current_stamp;
+                        affected.push_back(dependent);
+                        stack.push_back(dependent);
+                    }
+                }
+            }
+            stack.clear();
+        }
+        if (affected.size() > max_affected) {
+            needs_full_evaluation[op.get_id()] = true;
+            vector<int>().swap(affected);
+        } else {
+            sort(affected.begin(), affected.end(), [this](int lhs, int rhs) {
+                    return make_pair(axiom_layers[lhs], lhs) < make_pair(axiom_layers[rhs], rhs);
+                });
+        }
     }
 }
 
@@ -122,6 +185,18 @@ void AxiomEvaluator::evaluate(PackedStateBin *buffer,
     evaluate_aux(buffer, PackedStateAccessor(state_packer));
 }
 
+void AxiomEvaluator::evaluate(PackedStateBin *buffer,
+                              const int_packer::IntPacker &state_packer,
+                              int op_id) {
+    if (!task_has_axioms)
+        return;
+    if (needs_full_evaluation[op_id])
+        evaluate_aux(buffer, PackedStateAccessor(state_packer));
+    else
+        evaluate_affected(buffer, PackedStateAccessor(state_packer),
+                          affected_variables[op_id]);
+}
+
 template<typename Values, typename Accessor>
 inline void AxiomEvaluator::evaluate_aux(Values &values, const Accessor &accessor) {
     if (!task_has_axioms)
@@ -197,4 +272,73 @@ inline void AxiomEvaluator::evaluate_aux(Values &values, const Accessor &accesso
     }
 }
 
+/*
+  Works like evaluate_aux, restricted to the affected variables: they are
+  reset to their defaults and derived again by their rules, while all
+  other variables keep their values. The rules of the affected variables
+  start out with the number of conditions that are false or on affected
+  variables, so only literals of affected variables go through the queue.
+*/
+template<typename Values, typename Accessor>
+void AxiomEvaluator::evaluate_affected(
+    Values &values, const Accessor &accessor, const vector<int> &affected) {
+    if (affected.empty())
+        return;
+
+    ++current_stamp;
+    for (int var_no : affected) {
+        affected_stamps[var_no] = current_stamp;
+        accessor.set(values, var_no, default_values[var_no]);
+    }
+
+    assert(queue.empty());
+    for (int var_no : affected) {
+        for (AxiomRule *rule : rules_by_effect_var[var_no]) {
+            int unsatisfied_conditions = 0;
+            for (const FactPair &condition : rule->conditions) {
+                if (affected_stamps[condition.var] == current_stamp ||
+                    accessor.get(values, condition.var) != condition.value)
+                    ++unsatisfied_conditions;
+            }
+            rule->unsatisfied_conditions = unsatisfied_conditions;
+            if (unsatisfied_conditions == 0 &&
+                accessor.get(values, var_no) != rule->effect_val) {
+                accessor.set(values, var_no, rule->effect_val);
+                queue.push_back(rule->effect_literal);
+            }
+        }
+    }
+
+    size_t next_affected = 0;
+    for (size_t layer_no = 0; layer_no < nbf_info_by_layer.size(); ++layer_no) {
+        // Apply Horn rules. All rules conditioned on an affected variable
+        // derive an affected variable themselves.
+        while (!queue.empty()) {
+            const AxiomLiteral *curr_literal = queue.back();
+            queue.pop_back();
+            for (AxiomRule *rule : curr_literal->condition_of) {
+                assert(affected_stamps[rule->effect_var] == current_stamp);
+                if (--rule->unsatisfied_conditions == 0) {
+                    int var_no = rule->effect_var;
+                    int val = rule->effect_val;
+                    if (accessor.get(values, var_no) != val) {
+                        accessor.set(values, var_no, val);
+                        queue.push_back(rule->effect_literal);
+                    }
+                }
+            }
+        }
+
+        // Apply negation by failure rules of the affected variables.
+        for (; next_affected < affected.size() &&
+             axiom_layers[affected[next_affected]] == static_cast<int>(layer_no);
+             ++next_affected) {
+            int var_no = affected[next_affected];
+            if (layer_no != nbf_info_by_layer.size() - 1 &&
+                accessor.get(values, var_no) == default_values[var_no])
+                queue.push_back(&axiom_literals[var_no][default_values[var_no]]);
+        }
+    }
+}
+
 PerTaskInformation<AxiomEvaluator> g_axiom_evaluators;
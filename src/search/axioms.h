@@ -23,6 +23,7 @@ class AxiomEvaluator {
         int effect_var;
         int effect_val;
         AxiomLiteral *effect_literal;
+        std::vector<FactPair> conditions;
         AxiomRule(int cond_count, int eff_var, int eff_val, AxiomLiteral *eff_literal)
             : condition_count(cond_count), unsatisfied_conditions(cond_count),
               effect_var(eff_var), effect_val(eff_val), effect_literal(eff_literal) {
@@ -59,13 +60,46 @@ class AxiomEvaluator {
     */
     std::vector<const AxiomLiteral *> queue;
 
+    /*
+      Data for evaluating the axioms incrementally after applying an
+      operator. A derived variable depends on the variables in the
+      conditions of the rules deriving it, and transitively on their
+      dependencies. Its value can only change if one of the variables
+      it depends on changes, so after applying an operator, only the
+      derived variables depending on its effects need to be derived
+      again. For every operator, affected_variables lists them, sorted
+      by layer. Operators that affect most derived variables are
+      evaluated from scratch and have no entry here.
+    */
+    std::vector<int> axiom_layers;
+    std::vector<std::vector<AxiomRule *>> rules_by_effect_var;
+    std::vector<std::vector<int>> affected_variables;
+    std::vector<bool> needs_full_evaluation;
+    // affected_stamps[var] == current_stamp marks the affected variables
+    // of the running evaluation.
+    std::vector<int> affected_stamps;
+    int current_stamp;
+
+    void compute_affected_variables(const TaskProxy &task_proxy);
+
     template<typename Values, typename Accessor>
     void evaluate_aux(Values &values, const Accessor &accessor);
+    template<typename Values, typename Accessor>
+    void evaluate_affected(Values &values, const Accessor &accessor,
+                           const std::vector<int> &affected);
 public:
     explicit AxiomEvaluator(const TaskProxy &task_proxy);
 
     void evaluate(PackedStateBin *buffer, const int_packer::IntPacker &state_packer);
     void evaluate(std::vector<int> &state);
+    /*
+      Like evaluate, but buffer must hold the values of a state whose
+      derived variables have been evaluated, after applying the operator
+      with the given ID to it. Only the derived variables depending on
+      the effects of the operator are evaluated again.
+    */
+    void evaluate(PackedStateBin *buffer, const int_packer::IntPacker &state_packer,
+                  int op_id);
 };
 
 extern PerTaskInformation<AxiomEvaluator> g_axiom_evaluators;
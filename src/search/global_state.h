@@ -14,6 +14,7 @@ using PackedStateBin = int_packer::Bin;
 // states see the file state_registry.h.
 class GlobalState {
     friend class StateRegistry;
+    friend class ShardedStateRegistry;
     template<typename Entry>
     friend class PerStateInformation;
     template<typename>
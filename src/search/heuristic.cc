@@ -108,3 +108,10 @@ int Heuristic::get_cached_estimate(const GlobalState &state) const {
     assert(is_estimate_cached(state));
     return heuristic_cache[state].h;
 }
+
+void Heuristic::set_cached_estimate(const GlobalState &state, int h) {
+    if (!cache_evaluator_values)
+        return;
+    assert(h == EvaluationResult::INFTY || h >= 0);
+    heuristic_cache[state] = HEntry(h == EvaluationResult::INFTY ? DEAD_END : h, false);
+}
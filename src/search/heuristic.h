@@ -91,6 +91,14 @@ public:
     virtual bool does_cache_estimates() const override;
     virtual bool is_estimate_cached(const GlobalState &state) const override;
     virtual int get_cached_estimate(const GlobalState &state) const override;
+
+    /*
+      Store an estimate for the state that was computed elsewhere, e.g.
+      by a copy of this heuristic on another thread, so that evaluating
+      the state does not compute it again. Does nothing if the heuristic
+      does not cache its estimates.
+    */
+    void set_cached_estimate(const GlobalState &state, int h);
 };
 
 #endif
@@ -98,7 +98,7 @@ DiscreteDistribution::DiscreteDistribution(int maxSamples, double d)
 DiscreteDistribution::DiscreteDistribution(DiscreteDistribution const &other)
 	:maxSamples(other.maxSamples)
 {
-	for (ProbabilityNode const &n : other.distribution) {
+	for (ProbabilityNode const &n : other) {
 		distribution.emplace_back(n.cost, n.probability);
 	}
 }
@@ -111,7 +111,7 @@ DiscreteDistribution::DiscreteDistribution(DiscreteDistribution const &other, in
 DiscreteDistribution::DiscreteDistribution(DiscreteDistribution const &other, double shift)
 	:maxSamples(other.maxSamples)
 {
-	for (ProbabilityNode const &n : other.distribution) {
+	for (ProbabilityNode const &n : other) {
 		distribution.emplace_back(n.cost + shift, n.probability);
 	}
 }
@@ -131,8 +131,15 @@ DiscreteDistribution::DiscreteDistribution(DiscreteDistribution const *other, do
 {
 }
 
+DiscreteDistribution::DiscreteDistribution(int maxSamples, ProbabilityNode const *first, ProbabilityNode const *last)
+	: maxSamples(maxSamples), view_first(first), view_last(last)
+{
+	assert(first != nullptr && first < last);
+}
+
 DiscreteDistribution& DiscreteDistribution::squish(double f)
 {
+	assert(!is_view());
 	const double mean = expectedCost();
 
 	if (f == 1.0)
@@ -148,7 +155,7 @@ double DiscreteDistribution::expectedCost() const
 {
 	double E = 0.0;
 
-	for (auto const &n : distribution) {
+	for (auto const &n : *this) {
 		E += n.cost * n.probability;
 	}
 
@@ -199,33 +206,35 @@ DiscreteDistribution& DiscreteDistribution::operator=(const DiscreteDistribution
 		return *this;
 	}
 
-	distribution.clear();
-
-	distribution = rhs.distribution;
+	distribution.assign(rhs.begin(), rhs.end());
 	maxSamples = rhs.maxSamples;
+	view_first = nullptr;
+	view_last = nullptr;
 
 	return *this;
 }
 
 std::vector<ProbabilityNode>::iterator DiscreteDistribution::begin()
 {
+	assert(!is_view());
 	return distribution.begin();
 }
 
 std::vector<ProbabilityNode>::iterator DiscreteDistribution::end()
 {
+	assert(!is_view());
 	return distribution.end();
 }
 
 
-std::vector<ProbabilityNode>::const_iterator DiscreteDistribution::begin() const
+ProbabilityNode const *DiscreteDistribution::begin() const
 {
-	return distribution.begin();
+	return is_view() ? view_first : distribution.data();
 }
 
-std::vector<ProbabilityNode>::const_iterator DiscreteDistribution::end() const
+ProbabilityNode const *DiscreteDistribution::end() const
 {
-	return distribution.end();
+	return is_view() ? view_last : distribution.data() + distribution.size();
 }
 
 double ShiftedDistribution::expected_cost() const
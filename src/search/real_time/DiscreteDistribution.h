@@ -44,6 +44,11 @@ class DiscreteDistribution
 {
 	std::vector<ProbabilityNode> distribution;
 	int maxSamples;
+	// if set, the nodes are not owned by this distribution but live
+	// in a precomputed belief pool (see belief_pool.h).  Views are
+	// read-only, copies of a view own their nodes.
+	ProbabilityNode const *view_first = nullptr;
+	ProbabilityNode const *view_last = nullptr;
 
 	double probabilityDensityFunction(double x, double mu, double var);
 
@@ -64,9 +69,14 @@ public:
 	DiscreteDistribution(DiscreteDistribution const *other);
 	DiscreteDistribution(DiscreteDistribution const *other, int shift);
 	DiscreteDistribution(DiscreteDistribution const *other, double shift);
+	// Creates a read-only view of nodes owned by someone else
+	DiscreteDistribution(int maxSamples, ProbabilityNode const *first, ProbabilityNode const *last);
 
 	static const DiscreteDistribution dead_distribution;
 
+	bool is_view() const { return view_first != nullptr; }
+	size_t size() const { return static_cast<size_t>(end() - begin()); }
+
 	DiscreteDistribution& squish(double factor);
 	double expectedCost() const;
 
@@ -75,8 +85,8 @@ public:
 
 	std::vector<ProbabilityNode>::iterator begin();
 	std::vector<ProbabilityNode>::iterator end();
-	std::vector<ProbabilityNode>::const_iterator begin() const;
-	std::vector<ProbabilityNode>::const_iterator end() const;
+	ProbabilityNode const *begin() const;
+	ProbabilityNode const *end() const;
 };
 
 
@@ -33,8 +33,10 @@ AStarSolveAll::AStarSolveAll(const Options &opts)
       weight(opts.get<int>("w")),
       preferred_operator_evaluators(opts.get_list<shared_ptr<Evaluator>>("preferred")),
       pruning_method(opts.get<shared_ptr<PruningMethod>>("pruning")),
-      hstar_file(opts.get<std::string>("hstar_file")),
-      successors_file(opts.get<std::string>("successors_file")),
+      hstar_writer(opts.get<std::string>("hstar_file"), real_time::get_sample_format(opts),
+                   real_time::HStarSamples, opts.get<bool>("collect_parent_h")),
+      successors_writer(opts.get<std::string>("successors_file"), real_time::get_sample_format(opts),
+                        real_time::SuccessorSamples),
       find_early_solutions(opts.get<bool>("find_early_solutions")),
       collect_parent_h(opts.get<bool>("collect_parent_h")),
       best_solution_state(StateID::no_state),
@@ -123,8 +125,7 @@ void AStarSolveAll::print_statistics() const {
 
 SearchStatus AStarSolveAll::step() {
 	if (timer.is_expired()) {
-		dump_hstar_values();
-		compute_and_dump_successors_data();
+		finish_samples();
 		return TIMEOUT;
 	}
 
@@ -153,7 +154,7 @@ SearchStatus AStarSolveAll::step() {
 	if (!computing_initial_solution && find_early_solutions) {
 		const auto solved_states_it = solved_states.find(s.get_id());
 		if (solved_states_it != std::end(solved_states)) {
-			const auto solution_cost = node.get_g() + std::get<2>(solved_states_it->second);
+			const auto solution_cost = node.get_g() + solved_states_it->second;
 			if (best_solution_state == StateID::no_state || solution_cost <= best_solution_cost) {
 				best_solution_cost = solution_cost;
 				best_solution_state = s.get_id();
@@ -280,55 +281,34 @@ SearchStatus AStarSolveAll::step() {
     return IN_PROGRESS;
 }
 
-void AStarSolveAll::dump_hstar_values() const {
-	auto out = std::ofstream(hstar_file);
-	for (const auto &[state_id, h_values] : solved_states) {
-		const auto [h, hstar, ph] = h_values;
-		if (collect_parent_h) {
-			out << h << " " << hstar <<  " " << ph << '\n';
-		} else {
-			out << h << " " << hstar << '\n';
-		}
+void AStarSolveAll::write_successors_data(const GlobalState &state, int h) {
+	auto applicable_ops = std::vector<OperatorID>();
+	successor_generator.generate_applicable_ops(state, applicable_ops);
+	assert(!applicable_ops.empty());
+	auto successors = std::vector<std::pair<int, int>>();
+	for (auto op_id : applicable_ops) {
+		auto op = task_proxy.get_operators()[op_id];
+		auto successor = state_registry.get_successor_state(state, op);
+		auto eval_context = EvaluationContext(successor);
+		if (!eval_context.is_evaluator_value_infinite(evaluator.get()))
+			successors.emplace_back(get_adjusted_cost(op), eval_context.get_evaluator_value(evaluator.get()));
 	}
-	out.close();
-	std::cout << "dumped h* values to " << hstar_file << std::endl;
+	successors_writer.write_successors(h, successors);
 }
 
-void AStarSolveAll::compute_and_dump_successors_data() {
-	auto out = std::ofstream(successors_file);
-	const auto dump_successors_data = [&out, this](const auto &state) {
-		auto applicable_ops = std::vector<OperatorID>();
-		successor_generator.generate_applicable_ops(state, applicable_ops);
-		assert(!applicable_ops.empty());
-		for (auto op_id : applicable_ops) {
-			auto op = task_proxy.get_operators()[op_id];
-			auto successor = state_registry.get_successor_state(state, op);
-			auto eval_context = EvaluationContext(successor);
-			if (!eval_context.is_evaluator_value_infinite(evaluator.get()))
-				out << " " << get_adjusted_cost(op) << " " << eval_context.get_evaluator_value(evaluator.get());
-		}
-	};
-	for (const auto &[state_id, h_values] : solved_states) {
-		auto state = state_registry.lookup_state(state_id);
-		const auto [h, hstar, ph] = h_values;
-		if (task_properties::is_goal_state(task_proxy, state) || hstar == EvaluationResult::INFTY)
-			continue;
-		out << h;
-		dump_successors_data(state);
-		out << '\n';
-	}
+void AStarSolveAll::finish_samples() {
+	// the successors data of the solved states is already written
 	for (const auto &state_id : expanded_states) {
 		auto state = state_registry.lookup_state(state_id);
 		auto eval_context = EvaluationContext(state);
 		if (task_properties::is_goal_state(task_proxy, state) || eval_context.is_evaluator_value_infinite(evaluator.get()))
 			continue;
-		const auto h = eval_context.get_evaluator_value(evaluator.get());
-		out << h;
-		dump_successors_data(state);
-		out << '\n';
+		write_successors_data(state, eval_context.get_evaluator_value(evaluator.get()));
 	}
-	out.close();
-	std::cout << "dumped successors data to " << successors_file << std::endl;
+	hstar_writer.flush();
+	successors_writer.flush();
+	std::cout << "dumped h* values to " << hstar_writer.get_file_name() << std::endl;
+	std::cout << "dumped successors data to " << successors_writer.get_file_name() << std::endl;
 }
 
 auto AStarSolveAll::update_hstar_from_state(const SearchNode &node, int hstar) -> SearchStatus {
@@ -354,7 +334,10 @@ auto AStarSolveAll::update_hstar_from_state(const SearchNode &node, int hstar) -
 				}
 				assert(solved_states.find(current_state.get_id()) == std::end(solved_states));
 				assert(eval_context.get_evaluator_value(evaluator.get()) <= hstar);
-				solved_states.emplace(current_state.get_id(), std::make_tuple(h, hstar, ph));
+				solved_states.emplace(current_state.get_id(), hstar);
+				hstar_writer.write_hstar(h, hstar, ph);
+				if (!task_properties::is_goal_state(task_proxy, current_state))
+					write_successors_data(current_state, h);
 			}
 
 			if (!has_parent)
@@ -369,13 +352,12 @@ auto AStarSolveAll::update_hstar_from_state(const SearchNode &node, int hstar) -
 
 	if (expanded_states.empty()) {
 		set_plan(initial_plan);
-		dump_hstar_values();
-		compute_and_dump_successors_data();
+		finish_samples();
 		return SOLVED;
 	}
 
 	open_list->clear();
-	current_search_space = std::make_unique<SearchSpace>(state_registry);
+	current_search_space->reset();
 	const auto next_initial_state_id = *std::begin(expanded_states);
 	const auto next_initial_state = state_registry.lookup_state(next_initial_state_id);
 	auto initial_node = current_search_space->get_node(next_initial_state);
@@ -482,6 +464,7 @@ static shared_ptr<SearchEngine> _parse(options::OptionParser &parser) {
 	parser.add_option<double>("reserved_time", "reserved time to dump data", "0", Bounds("0", ""));
 	parser.add_option<bool>("find_early_solutions", "stop when finding an optimal solution through a node with known h* value", "false");
 	parser.add_option<bool>("collect_parent_h", "also collect and print the parent h for each state", "false");
+	real_time::add_sample_format_option(parser);
 
 	SearchEngine::add_pruning_option(parser);
 	SearchEngine::add_options_to_parser(parser);
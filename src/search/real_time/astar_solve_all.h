@@ -1,6 +1,8 @@
 #ifndef REAL_TIME_ASTAR_SOLVE_ALL_H
 #define REAL_TIME_ASTAR_SOLVE_ALL_H
 
+#include "sample_writer.h"
+
 #include "../open_list.h"
 #include "../search_engine.h"
 #include "../utils/countdown_timer.h"
@@ -32,14 +34,15 @@ class AStarSolveAll : public SearchEngine {
 
     std::shared_ptr<PruningMethod> pruning_method;
 
-	const std::string hstar_file;
-	void dump_hstar_values() const;
-
-	const std::string successors_file;
-	void compute_and_dump_successors_data();
+	// samples are written as soon as the states are solved
+	real_time::SampleWriter hstar_writer;
+	real_time::SampleWriter successors_writer;
+	void write_successors_data(const GlobalState &state, int h);
+	void finish_samples();
 
 	std::unordered_set<StateID> expanded_states;
-	std::unordered_map<StateID, std::tuple<int, int, int>> solved_states;
+	// h* values, the remaining sample data is only in the sample files
+	std::unordered_map<StateID, int> solved_states;
 
 	const bool find_early_solutions;
 	const bool collect_parent_h;
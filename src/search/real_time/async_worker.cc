@@ -0,0 +1,62 @@
+#include "async_worker.h"
+
+#include <cassert>
+
+namespace real_time
+{
+
+AsyncWorker::AsyncWorker()
+	: busy(false),
+	  shutting_down(false)
+{
+	thread = std::thread([this]() { worker_main(); });
+}
+
+AsyncWorker::~AsyncWorker()
+{
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		job_done.wait(lock, [this]() { return !busy; });
+		shutting_down = true;
+	}
+	job_ready.notify_one();
+	thread.join();
+}
+
+void AsyncWorker::start(std::function<void()> new_job)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		assert(!busy);
+		job = std::move(new_job);
+		busy = true;
+	}
+	job_ready.notify_one();
+}
+
+bool AsyncWorker::wait()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (!busy)
+		return false;
+	job_done.wait(lock, [this]() { return !busy; });
+	return true;
+}
+
+void AsyncWorker::worker_main()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	for (;;) {
+		job_ready.wait(lock, [this]() { return busy || shutting_down; });
+		if (shutting_down)
+			return;
+		lock.unlock();
+		job();
+		lock.lock();
+		job = nullptr;
+		busy = false;
+		job_done.notify_one();
+	}
+}
+
+}
@@ -0,0 +1,43 @@
+#ifndef REAL_TIME_ASYNC_WORKER_H
+#define REAL_TIME_ASYNC_WORKER_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace real_time
+{
+
+// Runs one job at a time on a thread of its own, so the calling thread
+// can go on with other work in the meantime.  The thread is started
+// once and sleeps in between jobs.  Only one thread may call start()
+// and wait().
+class AsyncWorker
+{
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable job_ready;
+	std::condition_variable job_done;
+	std::function<void()> job;
+	bool busy;
+	bool shutting_down;
+
+	void worker_main();
+public:
+	AsyncWorker();
+	// waits for the current job
+	~AsyncWorker();
+
+	AsyncWorker(AsyncWorker const &) = delete;
+	AsyncWorker &operator=(AsyncWorker const &) = delete;
+
+	// the previous job must be finished, see wait()
+	void start(std::function<void()> new_job);
+	// returns once no job is running; returns whether it had to block
+	bool wait();
+};
+
+}
+
+#endif
@@ -1,11 +1,17 @@
 #include "belief_data.h"
 
+#include "util.h"
+
+#include <cstring>
+#include <type_traits>
+
 namespace real_time
 {
 
+const char hstar_file_magic[8] = {'N', 'A', 'N', 'C', 'Y', 'H', 'S', '\0'};
+
 DataFeature::DataFeature(int h) : kind(JustH), h(h) {}
 DataFeature::DataFeature(int h, int ph) : kind(WithParentH), h(h), ph(ph) {}
-DataFeature::DataFeature(DataFeature const &x) : kind(x.kind), h(x.h), ph(x.ph) {}
 DataFeature::DataFeature(DataFeatureKind k, int h, int ph) : kind(k), h(h), ph(ph) {}
 
 DataFeature read_data_feat(std::stringstream &s, DataFeatureKind k)
@@ -49,6 +55,13 @@ bool DataFeature::operator==(DataFeature const &other) const
 	utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
 }
 
+std::uint64_t DataFeature::key() const
+{
+	// ph is not set for features of just h
+	auto const p = kind == WithParentH ? ph : 0;
+	return static_cast<std::uint64_t>(static_cast<std::uint32_t>(h)) << 32 | static_cast<std::uint32_t>(p);
+}
+
 int DataFeature::operator-(DataFeature const &o) const
 {
 	assert(kind == o.kind);
@@ -79,4 +92,141 @@ std::ostream &operator<<(std::ostream &out, DataFeature const &x)
 	return out;
 }
 
+template<typename CountT>
+HStarData<CountT>::HStarData(std::string const &file_name, DataFeatureKind const kind)
+{
+	char magic[sizeof(hstar_file_magic)] = {};
+	{
+		std::ifstream f(file_name, std::ios::binary);
+		if (!f) {
+			std::cerr << "error: could not open " << file_name << std::endl;
+			utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+		}
+		f.read(magic, sizeof(magic));
+	}
+	if (std::memcmp(magic, hstar_file_magic, sizeof(magic)) == 0)
+		read_binary(file_name, kind);
+	else
+		read_text(file_name, kind);
+
+	assert(data.size() > 0);
+}
+
+template<typename CountT>
+void HStarData<CountT>::add_entry(DataFeature const &feat, CountT value_count,
+				  HStarSample<CountT> const *first, HStarSample<CountT> const *last)
+{
+	int const h = feat.h;
+	if (h < 0) {
+		std::cerr << "error: negative h in data " << feat << std::endl;
+		utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+	}
+	if (static_cast<size_t>(h) >= data.size())
+		data.resize(h+1);
+	auto &bin = data[h];
+
+	if (!feature_keys.insert(feat.key()).second) {
+		std::cerr << "error: duplicate feat from data " << feat << std::endl;
+		utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+	}
+
+	bin.features.push_back(feat);
+	bin.values.emplace_back(value_count, first, last);
+}
+
+template<typename CountT>
+void HStarData<CountT>::read_text(std::string const &file_name, DataFeatureKind const kind)
+{
+	std::ifstream f(file_name);
+	std::string line;
+	int hs;
+	CountT valueCount, hsCount;
+
+	// the spans can only be set once the pool is complete
+	struct Pending
+	{
+		DataFeature feat;
+		CountT value_count;
+		size_t first;
+		size_t last;
+	};
+	std::vector<Pending> pending;
+
+	// Note: this could be made a little more efficient with a custom
+	// parser.  Use the binary format if startup time matters.
+	while (std::getline(f, line)) {
+		std::stringstream ss(line);
+		DataFeature const feat = read_data_feat(ss, kind);
+		ss >> valueCount;
+
+		if (0 == valueCount) {
+			// this can happen.  the post expansion belief script sometimes
+			// generates empty distributions
+			continue;
+		}
+
+		size_t const first = sample_pool.size();
+		while (!ss.eof()) {
+			ss >> hs;
+			ss >> hsCount;
+			sample_pool.emplace_back(hs, hsCount);
+		}
+		pending.push_back(Pending{feat, valueCount, first, sample_pool.size()});
+	}
+	f.close();
+
+	for (auto const &p : pending)
+		add_entry(p.feat, p.value_count, sample_pool.data() + p.first, sample_pool.data() + p.last);
+}
+
+template<typename CountT>
+void HStarData<CountT>::read_binary(std::string const &file_name, DataFeatureKind const kind)
+{
+	using Sample = HStarSample<CountT>;
+	static_assert(sizeof(HStarFileHeader) % 8 == 0, "header must keep the samples aligned");
+	static_assert(sizeof(HStarFileFeature) % 8 == 0, "features must keep the samples aligned");
+	static_assert(std::is_trivially_copyable<Sample>::value, "samples are used in place");
+
+	mapped_file = std::make_unique<MappedFile>(file_name);
+	char const *base = mapped_file->data();
+	size_t const file_size = mapped_file->size();
+
+	auto const fail = [&file_name](char const *what) {
+		std::cerr << "error: " << file_name << ": " << what << std::endl;
+		utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+	};
+
+	if (file_size < sizeof(HStarFileHeader))
+		fail("truncated header");
+	HStarFileHeader header;
+	std::memcpy(&header, base, sizeof(header));
+	if (header.version != hstar_file_version)
+		fail("unsupported version");
+	if (header.feature_kind != static_cast<std::uint32_t>(kind))
+		fail("feature kind does not match the requested one");
+	if (header.count_size != sizeof(CountT) || header.sample_size != sizeof(Sample))
+		fail("sample layout does not match (h* data uses 4 byte counts, post expansion data 8 byte counts)");
+
+	size_t const features_offset = sizeof(HStarFileHeader);
+	size_t const samples_offset = features_offset + header.num_features * sizeof(HStarFileFeature);
+	if (file_size != samples_offset + header.num_samples * sizeof(Sample))
+		fail("file size does not match the header");
+
+	auto const *features = reinterpret_cast<HStarFileFeature const *>(base + features_offset);
+	auto const *samples = reinterpret_cast<Sample const *>(base + samples_offset);
+	for (std::uint64_t i = 0; i < header.num_features; ++i) {
+		auto const &record = features[i];
+		if (record.first_sample + record.num_samples > header.num_samples)
+			fail("sample range out of bounds");
+		if (record.value_count == 0)
+			continue;
+		auto const feat = DataFeature(kind, record.h, record.ph);
+		auto const *first = samples + record.first_sample;
+		add_entry(feat, static_cast<CountT>(record.value_count), first, first + record.num_samples);
+	}
+}
+
+template struct HStarData<int>;
+template struct HStarData<long long>;
+
 }
@@ -5,8 +5,13 @@
 #include <sstream>
 #include <fstream>
 #include <cassert>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
 #include <vector>
 
+#include "flat_index_map.h"
+#include "mapped_file.h"
 #include "../utils/system.h"
 
 namespace real_time
@@ -28,28 +33,30 @@ enum Constants
 };
 
 // the struct to collect all possible feature values.  think of it
-// like a row in a database.
+// like a row in a database.  It is trivially copyable, so tables of
+// features are plain arrays.
 struct DataFeature
 {
 	enum DataFeatureKind kind;
 	int h;
 	int ph;
-	DataFeature();
+	DataFeature() = default;
 	// constructor to use just h
 	DataFeature(int h);
 	// constructor to use the parent h too
 	DataFeature(int h, int ph);
-	// copy constructor
-	DataFeature(DataFeature const&);
 	// full constructor specifying everything
 	DataFeature(DataFeatureKind k, int h, int ph);
-	virtual ~DataFeature() = default;
 
 	bool operator==(DataFeature const &other) const;
 	int operator-(DataFeature const &o) const;
-	size_t hash() const;
+	// the feature values packed into one integer, so that two
+	// features of the same kind are equal iff their keys are
+	std::uint64_t key() const;
 };
 
+static_assert(std::is_trivially_copyable<DataFeature>::value, "features are copied around as plain data");
+
 std::ostream &operator<<(std::ostream &os, DataFeature const &a);
 DataFeature read_data_feat(std::stringstream &s, DataFeatureKind k);
 DataFeature goal_feature(DataFeatureKind k);
@@ -61,16 +68,28 @@ struct HStarSample
 	int hstar_value;
 	CountT count;
 	HStarSample(int a, CountT b) : hstar_value(a), count(b) {}
-	~HStarSample() {}
+};
+
+// A contiguous range of samples.  The samples either live in the
+// sample pool of HStarData (text files) or directly in the mapped
+// binary file.
+template<typename T>
+struct SampleSpan
+{
+	T const *first;
+	T const *last;
+	T const *begin() const { return first; }
+	T const *end() const { return last; }
+	size_t size() const { return static_cast<size_t>(last - first); }
 };
 
 template<typename CountT = int>
 struct HStarEntry
 {
 	CountT value_count;
-	std::vector<HStarSample<CountT>> hstar_values;
-	HStarEntry(int vc) : value_count(vc) {}
-	~HStarEntry() {}
+	SampleSpan<HStarSample<CountT>> hstar_values;
+	HStarEntry(CountT vc, HStarSample<CountT> const *first, HStarSample<CountT> const *last)
+		: value_count(vc), hstar_values{first, last} {}
 };
 
 template<typename CountT = int>
@@ -82,55 +101,65 @@ struct HStarEntries
 	size_t size() const { assert(features.size() == values.size()); return features.size(); }
 };
 
+// The binary h* format written by training/convert_hstar_data.py.
+// Values are stored in native (little endian) byte order.  The file
+// consists of
+// - a header,
+// - num_features feature records, sorted by h,
+// - num_samples samples, laid out exactly like HStarSample<CountT>.
+// The samples of a feature are contiguous.  Since the header and the
+// feature records are multiples of 8 bytes long, the samples are
+// properly aligned in the mapped file and are used in place.
+struct HStarFileHeader
+{
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t feature_kind;
+	// sizeof(CountT) and sizeof(HStarSample<CountT>)
+	std::uint32_t count_size;
+	std::uint32_t sample_size;
+	std::uint64_t num_features;
+	std::uint64_t num_samples;
+};
+
+struct HStarFileFeature
+{
+	std::int32_t h;
+	std::int32_t ph;
+	std::int64_t value_count;
+	std::uint64_t first_sample;
+	std::uint64_t num_samples;
+};
+
+extern const char hstar_file_magic[8];
+constexpr std::uint32_t hstar_file_version = 1;
+
+// h* data, grouped by the h value of the features.  The file is
+// either in the text format produced by the combine_*.py scripts or
+// in the binary format, which is detected by its magic number.
 template<typename CountT = int>
 struct HStarData
 {
 	std::vector<HStarEntries<CountT> > data;
-	HStarData(std::string const &file_name, DataFeatureKind const kind)
-	{
-		std::ifstream f(file_name);
-		std::string line;
-		int hs;
-		CountT valueCount, hsCount;
-
-		// Note: this could be made a little more efficient with a custom parser.
-		while (std::getline(f, line)) {
-			std::stringstream ss(line);
-			DataFeature const feat = read_data_feat(ss, kind);
-			int const h = feat.h;
-			ss >> valueCount;
-
-			if (0 == valueCount) {
-				// this can happen.  the post expansion belief script sometimes
-				// generates empty distributions
-				continue;
-			}
-
-			data.resize(h+1);
-			auto &bin = data[h];
-
-			if (vec_find(bin.features, feat).second) {
-				std::cerr << "error: duplicate feat from data " << feat << std::endl;
-				utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
-			}
-
-			bin.features.push_back(feat);
-			bin.values.push_back(valueCount);
-			auto &samples_for_feat = bin.values.back().hstar_values;
-			while (!ss.eof()) {
-				ss >> hs;
-				ss >> hsCount;
-				samples_for_feat.emplace_back(hs, hsCount);
-			}
-		}
-		f.close();
-
-		assert(data.size() > 0);
-	}
+
+	HStarData(std::string const &file_name, DataFeatureKind const kind);
 
 	size_t size() const { return data.size(); }
 	HStarEntries<CountT> &operator[](size_t idx) { return data[idx]; }
 	HStarEntries<CountT> const &operator[](size_t idx) const { return data[idx]; }
+
+private:
+	// owns the samples read from a text file
+	std::vector<HStarSample<CountT>> sample_pool;
+	// keeps a binary file mapped for as long as the spans point to it
+	std::unique_ptr<MappedFile> mapped_file;
+	// the keys of all features, to detect duplicates while reading
+	FlatIndexMap<std::uint64_t> feature_keys;
+
+	void add_entry(DataFeature const &feat, CountT value_count,
+		       HStarSample<CountT> const *first, HStarSample<CountT> const *last);
+	void read_text(std::string const &file_name, DataFeatureKind kind);
+	void read_binary(std::string const &file_name, DataFeatureKind kind);
 };
 
 }
@@ -0,0 +1,206 @@
+#include "belief_pool.h"
+
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+namespace real_time
+{
+
+namespace
+{
+
+const char pool_magic[8] = {'N', 'A', 'N', 'C', 'Y', 'B', 'P', '\0'};
+constexpr std::uint32_t pool_version = 1;
+
+static_assert(sizeof(BeliefPoolHeader) % 8 == 0, "header must keep the nodes aligned");
+static_assert(sizeof(BeliefPoolRecord) % 8 == 0, "records must keep the nodes aligned");
+static_assert(sizeof(ProbabilityNode) == 2 * sizeof(double), "nodes are used in place");
+static_assert(std::is_trivially_copyable<ProbabilityNode>::value, "nodes are used in place");
+
+int record_ph(DataFeature const &df)
+{
+	return df.kind == WithParentH ? df.ph : 0;
+}
+
+bool record_less(BeliefPoolRecord const &a, BeliefPoolRecord const &b)
+{
+	return a.h < b.h || (a.h == b.h && a.ph < b.ph);
+}
+
+// FNV-1a over the shape of the data: the features, their value counts
+// and their number of samples.  The samples themselves are not hashed
+// to keep startup cheap, so a pool has to be rebuilt by hand when
+// only sample values change.
+template<typename CountT>
+std::uint64_t fingerprint(HStarData<CountT> const *data)
+{
+	if (data == nullptr)
+		return 0;
+	std::uint64_t hash = 14695981039346656037ULL;
+	auto const mix = [&hash](std::uint64_t v) {
+		for (int i = 0; i < 8; ++i) {
+			hash ^= (v >> (8 * i)) & 0xff;
+			hash *= 1099511628211ULL;
+		}
+	};
+	mix(sizeof(CountT));
+	for (size_t h = 0; h < data->size(); ++h) {
+		auto const &bin = (*data)[h];
+		for (size_t i = 0; i < bin.size(); ++i) {
+			mix(bin.features[i].kind);
+			mix(h);
+			mix(static_cast<std::uint64_t>(record_ph(bin.features[i])));
+			mix(static_cast<std::uint64_t>(bin.values[i].value_count));
+			mix(bin.values[i].hstar_values.size());
+		}
+	}
+	return hash;
+}
+
+template<typename CountT>
+void collect(HStarData<CountT> const *data,
+	     std::vector<BeliefPoolRecord> &records,
+	     std::vector<ProbabilityNode> &nodes)
+{
+	if (data == nullptr)
+		return;
+	for (size_t h = 0; h < data->size(); ++h) {
+		auto const &bin = (*data)[h];
+		for (size_t i = 0; i < bin.size(); ++i) {
+			DiscreteDistribution const d(MAX_SAMPLES, bin.values[i]);
+			records.push_back(BeliefPoolRecord{static_cast<std::int32_t>(h),
+							   record_ph(bin.features[i]),
+							   nodes.size(),
+							   d.size()});
+			nodes.insert(nodes.end(), d.begin(), d.end());
+		}
+	}
+	std::sort(records.begin(), records.end(), record_less);
+}
+
+template<typename T>
+void write_array(std::ofstream &out, std::vector<T> const &v)
+{
+	out.write(reinterpret_cast<char const *>(v.data()), static_cast<std::streamsize>(v.size() * sizeof(T)));
+}
+
+}
+
+BeliefPool::BeliefPool(std::string const &file_name,
+		       HStarData<int> const *hstar_data,
+		       HStarData<long long> const *post_expansion_belief_data)
+	: records{nullptr, nullptr},
+	  num_records{0, 0},
+	  nodes(nullptr)
+{
+	std::uint64_t const fingerprints[2] = {fingerprint(hstar_data), fingerprint(post_expansion_belief_data)};
+	if (load(file_name, fingerprints))
+		return;
+
+	std::cout << "building belief pool " << file_name << std::endl;
+	std::vector<BeliefPoolRecord> table_records[2];
+	std::vector<ProbabilityNode> all_nodes;
+	collect(hstar_data, table_records[HSTAR], all_nodes);
+	collect(post_expansion_belief_data, table_records[POST_EXPANSION], all_nodes);
+
+	BeliefPoolHeader header;
+	std::memcpy(header.magic, pool_magic, sizeof(pool_magic));
+	header.version = pool_version;
+	header.max_samples = MAX_SAMPLES;
+	for (int t = 0; t < 2; ++t) {
+		header.fingerprints[t] = fingerprints[t];
+		header.num_records[t] = table_records[t].size();
+	}
+	header.num_nodes = all_nodes.size();
+
+	// write to a private file first and rename it, so concurrent
+	// processes either see no pool or a complete one
+	std::string const tmp_name = file_name + ".tmp." + std::to_string(utils::get_process_id());
+	{
+		std::ofstream out(tmp_name, std::ios::binary | std::ios::trunc);
+		out.write(reinterpret_cast<char const *>(&header), sizeof(header));
+		write_array(out, table_records[HSTAR]);
+		write_array(out, table_records[POST_EXPANSION]);
+		write_array(out, all_nodes);
+		if (!out) {
+			std::cerr << "error: could not write belief pool " << tmp_name << std::endl;
+			std::remove(tmp_name.c_str());
+			utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+		}
+	}
+	if (std::rename(tmp_name.c_str(), file_name.c_str()) != 0) {
+		std::cerr << "error: could not move belief pool to " << file_name << std::endl;
+		std::remove(tmp_name.c_str());
+		utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+	}
+
+	if (!load(file_name, fingerprints)) {
+		std::cerr << "error: could not read back belief pool " << file_name << std::endl;
+		utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+	}
+}
+
+bool BeliefPool::load(std::string const &file_name, std::uint64_t const fingerprints[2])
+{
+	if (!std::ifstream(file_name))
+		return false;
+
+	file = std::make_unique<MappedFile>(file_name);
+	char const *base = file->data();
+	auto const fail = [&file_name](char const *what) {
+		std::cerr << "error: belief pool " << file_name << ": " << what << std::endl;
+		utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+	};
+
+	if (file->size() < sizeof(BeliefPoolHeader))
+		fail("truncated header");
+	BeliefPoolHeader header;
+	std::memcpy(&header, base, sizeof(header));
+	if (std::memcmp(header.magic, pool_magic, sizeof(pool_magic)) != 0 || header.version != pool_version)
+		fail("not a belief pool of this version");
+	if (header.max_samples != MAX_SAMPLES
+	    || header.fingerprints[HSTAR] != fingerprints[HSTAR]
+	    || header.fingerprints[POST_EXPANSION] != fingerprints[POST_EXPANSION])
+		fail("built from different data, delete it to rebuild");
+
+	size_t const records_offset = sizeof(BeliefPoolHeader);
+	size_t const nodes_offset = records_offset
+		+ (header.num_records[HSTAR] + header.num_records[POST_EXPANSION]) * sizeof(BeliefPoolRecord);
+	if (file->size() != nodes_offset + header.num_nodes * sizeof(ProbabilityNode))
+		fail("file size does not match the header");
+
+	records[HSTAR] = reinterpret_cast<BeliefPoolRecord const *>(base + records_offset);
+	records[POST_EXPANSION] = records[HSTAR] + header.num_records[HSTAR];
+	num_records[HSTAR] = header.num_records[HSTAR];
+	num_records[POST_EXPANSION] = header.num_records[POST_EXPANSION];
+	nodes = reinterpret_cast<ProbabilityNode const *>(base + nodes_offset);
+
+	for (int t = 0; t < 2; ++t) {
+		for (std::uint64_t i = 0; i < num_records[t]; ++i) {
+			auto const &r = records[t][i];
+			if (r.num_nodes == 0 || r.first_node + r.num_nodes > header.num_nodes)
+				fail("node range out of bounds");
+		}
+	}
+	return true;
+}
+
+DiscreteDistribution *BeliefPool::make_view(Table table, DataFeature const &df) const
+{
+	auto const *first = records[table];
+	auto const *last = first + num_records[table];
+	BeliefPoolRecord const key{df.h, record_ph(df), 0, 0};
+	auto const *it = std::lower_bound(first, last, key, record_less);
+	if (it == last || it->h != key.h || it->ph != key.ph)
+		return nullptr;
+	return new DiscreteDistribution(MAX_SAMPLES, nodes + it->first_node, nodes + it->first_node + it->num_nodes);
+}
+
+}
@@ -0,0 +1,87 @@
+#ifndef REAL_TIME_BELIEF_POOL_H
+#define REAL_TIME_BELIEF_POOL_H
+
+#include "belief_data.h"
+#include "DiscreteDistribution.h"
+#include "mapped_file.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace real_time
+{
+
+// Layout of a belief pool file.  Like the binary h* data, values are
+// stored in native byte order and every section is a multiple of 8
+// bytes long, so the nodes can be used in place when the file is
+// mapped.  The file consists of
+// - a header,
+// - the records of the h* table, sorted by (h, ph),
+// - the records of the post expansion table, sorted by (h, ph),
+// - the nodes of all distributions.
+struct BeliefPoolHeader
+{
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t max_samples;
+	// identifies the data the pool was built from
+	std::uint64_t fingerprints[2];
+	std::uint64_t num_records[2];
+	std::uint64_t num_nodes;
+};
+
+struct BeliefPoolRecord
+{
+	std::int32_t h;
+	std::int32_t ph;
+	std::uint64_t first_node;
+	std::uint64_t num_nodes;
+};
+
+// The downsampled distributions for all features in the h* and post
+// expansion belief data, precomputed once and shared by all planner
+// processes that use the same pool file.  The file is mapped
+// read-only, so the operating system keeps a single copy of it in
+// memory no matter how many processes use it.
+//
+// If the pool file does not exist yet, it is built from the data and
+// written atomically, so processes that start concurrently never see
+// a partially written pool.
+//
+// Only distributions that depend on nothing but the data are pooled.
+// Extrapolated copies for features missing from the data and the
+// gaussian and squished fallbacks depend on the search and are still
+// built per process.
+class BeliefPool
+{
+public:
+	enum Table
+	{
+		HSTAR = 0,
+		POST_EXPANSION = 1,
+	};
+
+	BeliefPool(std::string const &file_name,
+		   HStarData<int> const *hstar_data,
+		   HStarData<long long> const *post_expansion_belief_data);
+
+	// returns a view of the pooled distribution for the feature or
+	// nullptr if the pool does not contain it.  The caller owns the
+	// returned object, the nodes stay in the pool.
+	DiscreteDistribution *make_view(Table table, DataFeature const &df) const;
+
+	std::uint64_t size(Table table) const { return num_records[table]; }
+
+private:
+	std::unique_ptr<MappedFile> file;
+	BeliefPoolRecord const *records[2];
+	std::uint64_t num_records[2];
+	ProbabilityNode const *nodes;
+
+	bool load(std::string const &file_name, std::uint64_t const fingerprints[2]);
+};
+
+}
+
+#endif
@@ -4,90 +4,96 @@ namespace real_time
 {
 
 template<typename CountT>
-BeliefStore<CountT>::BeliefStore(DataFeatureKind kind, HStarData<CountT> *data)
-	: data(data)
+BeliefStore<CountT>::BeliefStore(DataFeatureKind kind, HStarData<CountT> *data,
+				 BeliefPool const *pool, BeliefPool::Table pool_table)
+	: data(data),
+	  pool(pool),
+	  pool_table(pool_table)
 {
-	raws.emplace_back();
-	raws.back().features.emplace_back(goal_feature(kind));
-	raws.back().distributions.push_back(new DiscreteDistribution(1, 0.0));
-
-	if (nullptr == data)
-		return;
-
-	for (HStarEntries<CountT> const &entries : data->data) {
-		for (size_t i = 0; i < entries.size(); ++i) {
-			int h = entries.features[i].h;
-			ensure_size(h+1);
-			auto &hbin = raws[h];
-			hbin.features.push_back(entries.features[i]);
-			hbin.distributions.push_back(new DiscreteDistribution(MAX_SAMPLES, entries.values[i]));
-		}
-	}
+	// the distributions for the data are only built once a feature
+	// is actually looked up (see get_distribution)
+	remember(goal_feature(kind), new DiscreteDistribution(1, 0.0));
 }
 
 template<typename CountT>
 BeliefStore<CountT>::~BeliefStore() {}
 
 template<typename CountT>
-void BeliefStore<CountT>::ensure_size(size_t s)
+size_t BeliefStore<CountT>::size() const
 {
-	if (s >= raws.size()) raws.resize(s+1);
+	return distributions.size();
 }
 
 template<typename CountT>
-size_t BeliefStore<CountT>::size() const
+DiscreteDistribution *BeliefStore<CountT>::find(DataFeature const &df) const
 {
-	return raws.size();
+	auto const i = index.find(df.key());
+	return i == FlatIndexMap<std::uint64_t>::no_index ? nullptr : distributions[i];
 }
 
-
 template<typename CountT>
-void BeliefStore<CountT>::remember(BeliefEntries &bin, DataFeature const &df, DiscreteDistribution *d)
+void BeliefStore<CountT>::remember(DataFeature const &df, DiscreteDistribution *d)
 {
-	bin.features.emplace_back(df);
-	bin.distributions.push_back(d);
+	auto const [i, inserted] = index.insert(df.key());
+	assert(inserted);
+	assert(static_cast<size_t>(i) == distributions.size());
+	(void)i;
+	(void)inserted;
+	distributions.push_back(d);
 }
 
 template<typename CountT>
-void BeliefStore<CountT>::remember(DataFeature const &df, DiscreteDistribution *d)
+DiscreteDistribution *BeliefStore<CountT>::get_distribution(DataFeature const &df_in)
 {
-	assert(raws.size() >= static_cast<size_t>(df.h));
-	auto &bin = raws[df.h];
-	remember(bin, df, d);
+#ifdef BELIEF_STORE_STATISTICS
+	// only the lookup itself is timed, not the building of missing
+	// distributions
+	auto const start = std::chrono::steady_clock::now();
+	auto res = find(df_in);
+	lookup_time += std::chrono::steady_clock::now() - start;
+	++num_lookups;
+	if (!res) {
+		++num_misses;
+		res = build_distribution(df_in);
+	}
+	return res;
+#else
+	auto res = find(df_in);
+	return res ? res : build_distribution(df_in);
+#endif
 }
 
+template<typename CountT>
+void BeliefStore<CountT>::print_statistics(char const *name) const
+{
+	std::cout << name << " distributions: " << size() << "\n";
+#ifdef BELIEF_STORE_STATISTICS
+	std::cout << name << " lookups: " << num_lookups << " (" << num_misses << " built)";
+	if (num_lookups > 0)
+		std::cout << ", " << static_cast<double>(lookup_time.count()) / num_lookups << "ns per lookup";
+	std::cout << "\n";
+#endif
+}
 
 // This is the function to get a fresh belief distribution based
-// on some feature.  It takes care of the following cases:
-// - If the distribution for this feature has been computed before,
-//   then we have cached it, and can simply return it.
-// - Else we know we don't have an exact data match.  So we look for
-//   the next lower h value for which we have data.  In the bucket for
-//   this h, we look for the feature that matches the input most
-//   closely.  The distribution for this closest match is copied,
-//   extrapolated, and cached for the input feature.
+// on some feature the store has not seen before (get_distribution
+// returns the cached ones).  It takes care of the following cases:
+// - We look for the next lower (or equal) h value for which we
+//   have data.  In the bucket for this h, we look for the feature
+//   that matches the input most closely.  The distribution for this
+//   closest match is built from the data the first time it is needed.
+//   On an exact match, that distribution is returned directly.
+//   Otherwise, it is copied, extrapolated, and cached for the input
+//   feature.
 // - If no data is available in the first place, we return null
 //   here.
 template<typename CountT>
-DiscreteDistribution *BeliefStore<CountT>::get_distribution(DataFeature const &df_in)
+DiscreteDistribution *BeliefStore<CountT>::build_distribution(DataFeature const &df_in)
 {
 	DiscreteDistribution *res = nullptr;
 	DiscreteDistribution *raw;
 	int h_in = df_in.h;
-
 	assert(h_in >= 0);
-	ensure_size(static_cast<size_t>(h_in));
-	if (!(raws.size() > static_cast<size_t>(h_in))) {
-		std::cout << raws.size() << ", " << h_in << "\n";
-	}
-	assert(raws.size() > static_cast<size_t>(h_in));
-	BeliefEntries &bin = raws[h_in];
-
-	// first check if we have this distribution already.
-	auto in_raws = vec_find(bin.features, df_in);
-	if (in_raws.second) {
-		return bin.distributions[in_raws.first];
-	}
 
 	// check if we even have data.  if we don't, we can't go on here,
 	// and the search has to use the gauss fallback.
@@ -118,19 +124,25 @@ DiscreteDistribution *BeliefStore<CountT>::get_distribution(DataFeature const &d
 			}
 
 			assert(min_idx < data_bin.features.size());
-			assert(static_cast<size_t>(h_adj) < raws.size());
 			DataFeature const &min_df = data_bin.features[min_idx];
-			auto &adj_bin = raws[h_adj];
 			int const shift = h_in - h_adj;
 			assert(shift >= 0);
 
-			auto adj_in_raws = vec_find(adj_bin.features,min_df);
-			assert(adj_in_raws.second);
-			raw = adj_bin.distributions[adj_in_raws.first];
+			raw = find(min_df);
+			if (!raw) {
+				raw = pool ? pool->make_view(pool_table, min_df) : nullptr;
+				if (!raw)
+					raw = new DiscreteDistribution(MAX_SAMPLES, data_bin.values[min_idx]);
+				remember(min_df, raw);
+				if (min_df == df_in) {
+					res = raw;
+					break;
+				}
+			}
 
 			// copy the distribution for the closest match.
 			res = new DiscreteDistribution(raw, shift);
-			remember(bin, df_in, res);
+			remember(df_in, res);
 			break;
 		} else {
 			--h_adj;
@@ -1,39 +1,60 @@
 #ifndef REAL_TIME_BELIEF_STORE_H
 #define REAL_TIME_BELIEF_STORE_H
 
+#include <chrono>
+#include <cstdint>
 #include <vector>
 
 #include "belief_data.h"
+#include "belief_pool.h"
 #include "DiscreteDistribution.h"
+#include "flat_index_map.h"
 
+// Configuring with -DBELIEF_STORE_STATISTICS=ON defines
+// BELIEF_STORE_STATISTICS, which counts and times the lookups in
+// get_distribution.  This reads the clock twice per lookup, which
+// costs about as much as the lookup itself, so it is off by default.
 
 namespace real_time
 {
 
-struct BeliefEntries
-{
-	std::vector<DataFeature> features;
-	std::vector<DiscreteDistribution*> distributions;
-	BeliefEntries() {}
-	~BeliefEntries() {}
-};
-
+// The distributions handed out so far, found by the key of their
+// feature in a flat hash table.  Looking up a known feature thus takes
+// constant time, no matter how many features share its h.
 template<typename CountT = int>
 struct BeliefStore
 {
-	std::vector<BeliefEntries> raws;
+	FlatIndexMap<std::uint64_t> index;
+	std::vector<DiscreteDistribution*> distributions;
 	HStarData<CountT> const *data;
+	// if set, distributions for the data are taken from the pool
+	// instead of being built here
+	BeliefPool const *pool;
+	BeliefPool::Table pool_table;
+
+#ifdef BELIEF_STORE_STATISTICS
+	// debug statistics on get_distribution
+	long long num_lookups = 0;
+	long long num_misses = 0;
+	std::chrono::nanoseconds lookup_time{0};
+#endif
 
-	BeliefStore(DataFeatureKind kind, HStarData<CountT> *data);
+	BeliefStore(DataFeatureKind kind, HStarData<CountT> *data,
+		    BeliefPool const *pool = nullptr,
+		    BeliefPool::Table pool_table = BeliefPool::HSTAR);
 	~BeliefStore();
 
-	void ensure_size(size_t s);
 	size_t size() const;
 
-	void remember(BeliefEntries &bin, DataFeature const &df, DiscreteDistribution *d);
+	DiscreteDistribution *find(DataFeature const &df) const;
 	void remember(DataFeature const &df, DiscreteDistribution *d);
 
 	DiscreteDistribution *get_distribution(DataFeature const &df_in);
+
+	void print_statistics(char const *name) const;
+
+private:
+	DiscreteDistribution *build_distribution(DataFeature const &df_in);
 };
 
 }
@@ -3,6 +3,8 @@
 
 #include "lookhead_search.h"
 
+#include <chrono>
+
 namespace real_time
 {
 
@@ -10,9 +12,32 @@ struct Bound
 {
 	virtual ~Bound() = default;
 	virtual bool lookahead_ok() = 0;
-	virtual bool learning_ok() const = 0;
+	virtual bool learning_ok() = 0;
 	virtual void initialize(LookaheadSearch const &ls) = 0;
-	virtual void print_surplus() const = 0;
+
+	// The search control reports the phases of each step, so that
+	// time bounds can measure them.  A step starts before catching
+	// up on learning, its lookahead starts with initialize(), and
+	// the decision (including the post-processing of the lookahead)
+	// lasts until the learning phase starts.
+	virtual void start_step() {}
+	virtual void lookahead_finished() {}
+	virtual void learning_started() {}
+	virtual void learning_finished() {}
+	// Whether catching up on the learning of the last step, after
+	// start_step(), may go on.  What is left of it once this fails
+	// is abandoned.
+	virtual bool catch_up_ok() { return true; }
+	// Committing to more than one action per lookahead: the step has
+	// taken another action, and whether it is behind its schedule
+	// (which time bounds then make up for by committing to more).
+	virtual void action_committed() {}
+	virtual bool behind_schedule() const { return false; }
+	// the schedule stood still for the given time, because the agent
+	// was executing actions
+	virtual void pause(std::chrono::steady_clock::duration) {}
+
+	virtual void print_statistics() const {}
 };
 
 }
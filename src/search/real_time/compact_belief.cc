@@ -0,0 +1,40 @@
+#include "compact_belief.h"
+
+#include <cassert>
+#include <limits>
+
+namespace real_time
+{
+
+std::uint32_t DistributionTable::add(DiscreteDistribution const *distribution)
+{
+	assert(distribution);
+	auto const [it, inserted] = ids.emplace(distribution, static_cast<std::uint32_t>(distributions.size()));
+	if (inserted) {
+		assert(distributions.size() < CompactBelief::no_distribution);
+		distributions.push_back(distribution);
+		expected_costs.push_back(distribution->expectedCost());
+	}
+	return it->second;
+}
+
+double DistributionTable::expected_cost(CompactBelief belief) const
+{
+	assert(belief.is_known());
+	if (belief.is_infinite())
+		return std::numeric_limits<double>::infinity();
+	return expected_costs[belief.get_distribution()] + belief.shift;
+}
+
+ShiftedDistribution DistributionTable::expand(CompactBelief belief) const
+{
+	auto res = ShiftedDistribution();
+	if (!belief.is_known())
+		return res;
+	res.distribution = distributions[belief.get_distribution()];
+	res.shift = belief.shift;
+	res.expected_value = expected_cost(belief);
+	return res;
+}
+
+}
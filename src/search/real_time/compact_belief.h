@@ -0,0 +1,61 @@
+#ifndef REAL_TIME_COMPACT_BELIEF_H
+#define REAL_TIME_COMPACT_BELIEF_H
+
+#include "DiscreteDistribution.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace real_time
+{
+
+// The belief of a state as it is kept for every registered state: the
+// index of the raw distribution in a DistributionTable and the shift,
+// 8 bytes instead of the 24 of a ShiftedDistribution.  The expected
+// cost is not stored but looked up in the table.  The learning marks
+// beliefs as infinite without losing the distribution and the shift,
+// like it sets the expected value of a ShiftedDistribution to
+// infinity, so that flag takes the top bit of the index.
+struct CompactBelief
+{
+	static constexpr std::uint32_t infinite_flag = std::uint32_t(1) << 31;
+	static constexpr std::uint32_t no_distribution = infinite_flag - 1;
+
+	std::uint32_t bits;
+	std::int32_t shift;
+
+	CompactBelief() : bits(no_distribution), shift(0) {}
+	CompactBelief(std::uint32_t distribution, int shift) : bits(distribution), shift(shift) {}
+
+	std::uint32_t get_distribution() const { return bits & ~infinite_flag; }
+	bool is_known() const { return get_distribution() != no_distribution; }
+	bool is_infinite() const { return (bits & infinite_flag) != 0; }
+	void set_infinite() { bits |= infinite_flag; }
+
+	// the same distribution, shifted further (and finite)
+	CompactBelief shifted(int by) const { return CompactBelief(get_distribution(), shift + by); }
+};
+
+static_assert(sizeof(CompactBelief) == 8, "compact beliefs are meant to be 8 bytes");
+
+// Numbers the raw distributions the compact beliefs refer to and
+// keeps their expected costs.  A distribution gets its number the
+// first time it is added and keeps it; the table does not own it.
+class DistributionTable
+{
+	std::vector<DiscreteDistribution const *> distributions;
+	std::vector<double> expected_costs;
+	std::unordered_map<DiscreteDistribution const *, std::uint32_t> ids;
+public:
+	std::uint32_t add(DiscreteDistribution const *distribution);
+
+	double expected_cost(CompactBelief belief) const;
+	ShiftedDistribution expand(CompactBelief belief) const;
+
+	std::size_t size() const { return distributions.size(); }
+};
+
+}
+
+#endif
@@ -0,0 +1,57 @@
+#include "deadline_checker.h"
+
+#include <algorithm>
+
+namespace real_time
+{
+
+DeadlineChecker::DeadlineChecker()
+	: units(0),
+	  units_at_last_read(0),
+	  next_read(1),
+	  unit_cost(-1),
+	  total_units(0),
+	  total_reads(0)
+{
+}
+
+void DeadlineChecker::start(Clock::time_point deadline, Clock::time_point now)
+{
+	this->deadline = deadline;
+	last_read = now;
+	units = 0;
+	// the units counted before a read are done after it
+	units_at_last_read = 1;
+	next_read = 1;
+}
+
+bool DeadlineChecker::ok(double reserve, double reserve_per_unit)
+{
+	++units;
+	++total_units;
+	if (units < next_read)
+		return true;
+
+	auto const now = Clock::now();
+	++total_reads;
+	auto const done = units - units_at_last_read;
+	if (done > 0) {
+		double const sample = std::chrono::duration<double, std::nano>(now - last_read).count() / done;
+		unit_cost = unit_cost < 0 ? sample : unit_cost + (sample - unit_cost) / 8;
+	}
+	last_read = now;
+	units_at_last_read = units;
+
+	double const left = std::chrono::duration<double, std::nano>(deadline - now).count()
+		- reserve - reserve_per_unit * units;
+	double const needed = std::max(unit_cost, 0.0) + reserve_per_unit;
+	if (left < needed) {
+		next_read = units + 1;
+		return false;
+	}
+	auto const interval = needed > 0 ? static_cast<long long>(left / 4 / needed) : 1;
+	next_read = units + std::clamp(interval, 1LL, max_interval);
+	return true;
+}
+
+}
@@ -0,0 +1,51 @@
+#ifndef REAL_TIME_DEADLINE_CHECKER_H
+#define REAL_TIME_DEADLINE_CHECKER_H
+
+#include <chrono>
+
+namespace real_time
+{
+
+// Tells whether another unit of work (an expansion, a learning step)
+// still fits before a deadline, without reading the clock for every
+// unit.  The clock is read on the first call after start() and then
+// again after as many units as fit into a quarter of the time that is
+// left, going by the average cost of a unit measured so far, and at
+// least every max_interval units.  Checking more often than that only
+// pays off if single units can take much longer than average.  The
+// cost estimate is kept across deadlines.
+class DeadlineChecker
+{
+public:
+	using Clock = std::chrono::steady_clock;
+private:
+	static constexpr long long max_interval = 1024;
+
+	Clock::time_point deadline;
+	Clock::time_point last_read;
+	long long units;
+	long long units_at_last_read;
+	long long next_read;
+	// moving average of the time per unit in nanoseconds, negative
+	// until the first measurement
+	double unit_cost;
+	long long total_units;
+	long long total_reads;
+public:
+	DeadlineChecker();
+
+	void start(Clock::time_point deadline, Clock::time_point now);
+	// Counts another unit and tells whether it can be done.  reserve
+	// (in nanoseconds) has to be left over at the deadline, plus
+	// reserve_per_unit for each unit counted since start().
+	bool ok(double reserve, double reserve_per_unit);
+
+	long long get_units() const { return units; }
+	double get_unit_cost() const { return unit_cost; }
+	long long get_total_units() const { return total_units; }
+	long long get_total_reads() const { return total_reads; }
+};
+
+}
+
+#endif
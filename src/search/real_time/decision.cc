@@ -1,5 +1,7 @@
 #include "decision.h"
 
+#include <cassert>
+
 namespace real_time
 {
 
@@ -8,4 +10,12 @@ Decision::Decision(StateRegistry const &sr)
 {
 }
 
+OperatorID Decision::follow_target_path()
+{
+	assert(!target_path.empty());
+	auto const next_action = target_path.back();
+	target_path.pop_back();
+	return next_action;
+}
+
 }
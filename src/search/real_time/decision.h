@@ -15,11 +15,18 @@ namespace real_time
 struct Decision
 {
 	StateRegistry const &state_registry;
+	// the remaining actions on the path to the frontier state the
+	// last decision aimed for, in reverse order (the next action is at
+	// the back)
+	std::vector<OperatorID> target_path;
 
 	Decision(StateRegistry const &sr);
 	virtual ~Decision() = default;
 
 	virtual OperatorID decide(std::vector<StateID> const &frontier, SearchSpace &ss) = 0;
+	// takes the next action on the target path, for committing to
+	// more than one action per lookahead
+	virtual OperatorID follow_target_path();
 };
 
 }
@@ -1,50 +1,163 @@
 #include "dijkstra_backup.h"
 #include "../evaluation_context.h"
 
+#include <algorithm>
+
 namespace real_time
 {
 
-DijkstraBackup::DijkstraBackup(const StateRegistry &state_registry, SearchEngine const *search_engine, std::shared_ptr<LearningEvaluator> learning_evaluator, std::shared_ptr<LearningEvaluator> distance_learning_evaluator, bool h_before)
-	:Learning(state_registry, search_engine), learning_evaluator(learning_evaluator), distance_learning_evaluator(distance_learning_evaluator), h_before(h_before)
+DijkstraBackup::DijkstraBackup(const StateRegistry &state_registry, SearchEngine const *search_engine, std::shared_ptr<LearningEvaluator> learning_evaluator, std::shared_ptr<LearningEvaluator> distance_learning_evaluator, bool h_before, LearningQueue queue_kind)
+	:Learning(state_registry, search_engine), learning_evaluator(learning_evaluator), distance_learning_evaluator(distance_learning_evaluator), h_before(h_before), queue_kind(queue_kind), use_snapshot(false), snapshot_index(StateID::no_state), snapshot_num_closed(0)
 {
 }
 
-void DijkstraBackup::initialize(const std::unordered_map<StateID, std::vector<std::pair<StateID, OperatorProxy>>> &predecessors_,
-	const std::vector<StateID> &frontier,
-	std::unordered_set<StateID> &closed_)
+void DijkstraBackup::initialize(LookaheadArena &arena_,
+	const std::vector<StateID> &frontier)
 {
-	predecessors = &predecessors_;
-	closed = &closed_;
-	initial_effort = closed->size();
+	arena = &arena_;
+	use_snapshot = false;
+	initial_effort = arena->get_num_closed();
 
-	if (h_before) {
-		// ensure the heuristic values are cached for all states
-		const auto evaluate = [this](const auto &state_id) {
-			auto state = state_registry.lookup_state(state_id);
-			auto eval_context = EvaluationContext(state);
-			learning_evaluator->compute_result(eval_context);
-			if (distance_learning_evaluator)
-				distance_learning_evaluator->compute_result(eval_context);
-		};
-		for (const auto &state_id : frontier)
-			evaluate(state_id);
-		for (const auto &state_id : (*closed))
-			evaluate(state_id);
-	}
+	cache_estimates(frontier);
 
+	previous_h.clear();
+	for (const auto &state_id : arena->get_closed_states()) {
+		auto state = state_registry.lookup_state(state_id);
+		previous_h.push_back(learning_evaluator->is_estimate_cached(state)
+				     ? learning_evaluator->get_cached_estimate(state)
+				     : LearningEvaluator::NO_VALUE);
+		learning_evaluator->update_value(state, EvaluationResult::INFTY);
+	}
 
-	for (const auto &state_id : (*closed))
-		learning_evaluator->update_value(state_registry.lookup_state(state_id), EvaluationResult::INFTY);
+	// a new backup starts over from the smallest h, which the radix
+	// heap only allows after a clear.  Entries left over from an
+	// unfinished backup belong to the previous arena anyway.
+	radix_queue.clear();
 
 	for (const auto &state_id : frontier) {
 		auto state = state_registry.lookup_state(state_id);
 		assert(learning_evaluator->is_estimate_cached(state));
-		learning_queue.emplace(learning_evaluator->get_cached_estimate(state), state_id);
+		push(learning_evaluator->get_cached_estimate(state), state_id);
 		//closed->erase(state_id);
 	}
 }
 
 
+void DijkstraBackup::cache_estimates(const std::vector<StateID> &frontier)
+{
+	if (!h_before)
+		return;
+	// ensure the heuristic values are cached for all states
+	const auto evaluate = [this](const auto &state_id) {
+		auto state = state_registry.lookup_state(state_id);
+		auto eval_context = EvaluationContext(state);
+		learning_evaluator->compute_result(eval_context);
+		if (distance_learning_evaluator)
+			distance_learning_evaluator->compute_result(eval_context);
+	};
+	for (const auto &state_id : frontier)
+		evaluate(state_id);
+	for (const auto &state_id : arena->get_closed_states())
+		evaluate(state_id);
+}
+
+int DijkstraBackup::add_to_snapshot(StateID state_id, int h)
+{
+	const auto [index, inserted] = snapshot_index.insert(state_id);
+	if (inserted) {
+		auto state = state_registry.lookup_state(state_id);
+		if (h == LearningEvaluator::NO_VALUE) {
+			assert(learning_evaluator->is_estimate_cached(state));
+			h = learning_evaluator->get_cached_estimate(state);
+		}
+		snapshot_states.push_back(state_id);
+		snapshot_h.push_back(h);
+		snapshot_base_h.push_back(learning_evaluator->is_base_estimate_cached(state) ? learning_evaluator->get_base_estimate(state) : 0);
+	}
+	return index;
+}
+
+int DijkstraBackup::get_h(StateID state_id) const
+{
+	if (use_snapshot) {
+		const auto index = snapshot_index.find(state_id);
+		assert(index != FlatIndexMap<StateID>::no_index);
+		return snapshot_h[index];
+	}
+	auto state = state_registry.lookup_state(state_id);
+	assert(learning_evaluator->is_estimate_cached(state));
+	return learning_evaluator->get_cached_estimate(state);
+}
+
+void DijkstraBackup::set_h(StateID state_id, int h)
+{
+	if (use_snapshot) {
+		const auto index = snapshot_index.find(state_id);
+		assert(index != FlatIndexMap<StateID>::no_index);
+		snapshot_h[index] = std::max(h, snapshot_base_h[index]);
+		return;
+	}
+	// NOTE: the base evaluator should not need to be checked for consistent heuristics
+	learning_evaluator->update_value(state_registry.lookup_state(state_id), h, true);
+}
+
+void DijkstraBackup::snapshot(LookaheadArena const &arena_,
+	const std::vector<StateID> &frontier)
+{
+	// the arena of the lookahead is reused by the next lookahead
+	snapshot_arena = arena_;
+	arena = &snapshot_arena;
+	use_snapshot = true;
+	initial_effort = arena->get_num_closed();
+
+	cache_estimates(frontier);
+
+	snapshot_index.clear();
+	snapshot_states.clear();
+	snapshot_h.clear();
+	snapshot_base_h.clear();
+	for (const auto &state_id : arena->get_closed_states())
+		add_to_snapshot(state_id, EvaluationResult::INFTY);
+	snapshot_num_closed = snapshot_index.size();
+
+	assert(done());
+	radix_queue.clear();
+	for (const auto &state_id : frontier) {
+		const auto index = add_to_snapshot(state_id, LearningEvaluator::NO_VALUE);
+		push(snapshot_h[index], state_id);
+	}
+}
+
+void DijkstraBackup::run()
+{
+	while (!done())
+		step();
+}
+
+void DijkstraBackup::publish()
+{
+	assert(use_snapshot && done());
+	for (int i = 0; i < snapshot_num_closed; ++i)
+		learning_evaluator->update_value(state_registry.lookup_state(snapshot_states[i]), snapshot_h[i]);
+}
+
+void DijkstraBackup::push(int h, StateID state_id)
+{
+	if (queue_kind == LearningQueue::HEAP)
+		learning_queue.emplace(h, state_id);
+	else if (h != EvaluationResult::INFTY)
+		radix_queue.push(h, state_id);
+}
+
+auto DijkstraBackup::pop() -> QueueEntry
+{
+	if (queue_kind == LearningQueue::RADIX)
+		return radix_queue.pop();
+	auto const top = learning_queue.top();
+	learning_queue.pop();
+	return top;
+}
+
 void DijkstraBackup::step()
 {
 	assert(!done());
@@ -52,44 +165,31 @@ void DijkstraBackup::step()
  get_entry:
 	if (done())
 		return;
-	auto [h, state_id] = learning_queue.top();
-	learning_queue.pop();
-	auto state = state_registry.lookup_state(state_id);
-	assert(learning_evaluator->is_estimate_cached(state));
-	if (learning_evaluator->get_cached_estimate(state) != h)
+	auto [h, state_id] = pop();
+	if (get_h(state_id) != h)
 		goto get_entry;
 	if (h == EvaluationResult::INFTY)
 		goto get_entry;
 
-	auto cls = closed->find(state_id);
-	if (cls != std::end(*closed))
-		closed->erase(cls);
+	arena->remove_closed(state_id);
 
-	assert(closed->find(state_id) == std::end(*closed));
-
-	auto predecessors_pos = predecessors->find(state_id);
-	if (predecessors_pos == std::end(*predecessors))
-		return; // state is the root state of the current lookahead search
-
-	for (const auto &[predecessor_id, op] : predecessors_pos->second) {
-		cls = closed->find(predecessor_id);
-		if (cls == std::end(*closed))
+	// the root state of the current lookahead search has no predecessors
+	for (const auto &edge : arena->get_predecessors(state_id)) {
+		const auto predecessor_id = edge.state;
+		if (!arena->is_closed(predecessor_id))
 			continue;
-		auto predecessor = state_registry.lookup_state(predecessor_id);
-		assert(learning_evaluator->is_estimate_cached(predecessor));
-		const auto predecessor_h = learning_evaluator->get_cached_estimate(predecessor);
-		const auto new_h = h + search_engine->get_adjusted_cost(op);
+		const auto predecessor_h = get_h(predecessor_id);
+		const auto new_h = h + search_engine->get_adjusted_cost(search_engine->get_operators()[edge.op]);
 		if (predecessor_h > new_h) {
-			// NOTE: the base evaluator should not need to be checked for consistent heuristics
-			learning_evaluator->update_value(predecessor, new_h, true);
-			learning_queue.emplace(new_h, predecessor_id);
+			set_h(predecessor_id, new_h);
+			push(new_h, predecessor_id);
 		}
 	}
 }
 
 bool DijkstraBackup::done()
 {
-	return learning_queue.empty();
+	return queue_kind == LearningQueue::RADIX ? radix_queue.empty() : learning_queue.empty();
 }
 
 size_t DijkstraBackup::effort()
@@ -99,7 +199,21 @@ size_t DijkstraBackup::effort()
 
 size_t DijkstraBackup::remaining()
 {
-	return closed->size();
+	return arena->get_num_closed();
+}
+
+void DijkstraBackup::abandon()
+{
+	assert(!use_snapshot);
+	// the states still closed were not popped, so their values are
+	// either infinite or not final yet
+	const auto &closed_states = arena->get_closed_states();
+	for (size_t i = 0; i < closed_states.size(); ++i) {
+		if (arena->is_closed(closed_states[i]))
+			learning_evaluator->update_value(state_registry.lookup_state(closed_states[i]), previous_h[i]);
+	}
+	radix_queue.clear();
+	learning_queue = decltype(learning_queue)();
 }
 
 
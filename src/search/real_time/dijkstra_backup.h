@@ -3,8 +3,10 @@
 
 #include <queue>
 
+#include "kinds.h"
 #include "learning.h"
 #include "learning_evaluator.h"
+#include "../algorithms/priority_queues.h"
 
 namespace real_time
 {
@@ -24,21 +26,59 @@ struct DijkstraBackup : public Learning
 	std::shared_ptr<LearningEvaluator> learning_evaluator;
 	std::shared_ptr<LearningEvaluator> distance_learning_evaluator;
 	const bool h_before;
+	const LearningQueue queue_kind;
 
-	// created by us during initialize
+	// created by us during initialize.  Only one of them is used,
+	// depending on queue_kind.  h values only decrease during the
+	// backup, so the keys popped from the queue never decrease and
+	// the radix heap applies.  Entries whose state got a smaller h
+	// since they were pushed are skipped when popped.  The radix heap
+	// does not take entries with infinite h at all, since they would
+	// be skipped as well.
 	std::priority_queue<QueueEntry, std::vector<QueueEntry>, QueueComp> learning_queue;
+	priority_queues::RadixHeap<StateID> radix_queue;
 
-	DijkstraBackup(const StateRegistry &state_registry, SearchEngine const *search_engine, std::shared_ptr<LearningEvaluator> learning_evaluator, std::shared_ptr<LearningEvaluator> distance_learning_evaluator, bool h_before);
+	void push(int h, StateID state_id);
+	QueueEntry pop();
+
+	// the values of the closed states before initialize(), in the
+	// order of the arena's closed states, for abandon()
+	std::vector<int> previous_h;
+
+	// copies taken by snapshot().  use_snapshot tells whether step()
+	// works on them or on the arena and the evaluator.
+	bool use_snapshot;
+	LookaheadArena snapshot_arena;
+	FlatIndexMap<StateID> snapshot_index;
+	std::vector<StateID> snapshot_states;
+	std::vector<int> snapshot_h;
+	std::vector<int> snapshot_base_h;
+	// the closed states come first in the snapshot
+	int snapshot_num_closed;
+
+	void cache_estimates(const std::vector<StateID> &frontier);
+	// h is NO_VALUE to take the value of the evaluator
+	int add_to_snapshot(StateID state_id, int h);
+	int get_h(StateID state_id) const;
+	// never goes below the value of the base evaluator
+	void set_h(StateID state_id, int h);
+
+	DijkstraBackup(const StateRegistry &state_registry, SearchEngine const *search_engine, std::shared_ptr<LearningEvaluator> learning_evaluator, std::shared_ptr<LearningEvaluator> distance_learning_evaluator, bool h_before, LearningQueue queue_kind);
 	~DijkstraBackup() = default;
 
-	void initialize(const std::unordered_map<StateID, std::vector<std::pair<StateID, OperatorProxy>>> &predecessors,
-			const std::vector<StateID> &frontier,
-			std::unordered_set<StateID> &closed) final;
+	void initialize(LookaheadArena &arena,
+			const std::vector<StateID> &frontier) final;
 
 	void step() final;
 	bool done() final;
 	size_t effort() final;
 	size_t remaining() final;
+	void abandon() final;
+
+	void snapshot(LookaheadArena const &arena,
+		      const std::vector<StateID> &frontier) final;
+	void run() final;
+	void publish() final;
 };
 
 }
@@ -88,16 +88,20 @@ OperatorID DistributionDecider::decide(std::vector<StateID> const &frontier, Sea
 	} else {
 		// follow path
 		assert(!target_path.empty());
-		OperatorID next_action = target_path.back();
-		assert(std::find(tlas->ops.begin(), tlas->ops.end(), next_action) != tlas->ops.end());
-		target_path.pop_back();
+		assert(std::find(tlas->ops.begin(), tlas->ops.end(), target_path.back()) != tlas->ops.end());
 		if (min_h < target_h_hat)
 			target_h_hat = min_h;
-		target_f_hat -= engine.get_adjusted_cost(engine.get_operators()[next_action]);
-		return next_action;
+		return follow_target_path();
 	}
 }
 
+OperatorID DistributionDecider::follow_target_path()
+{
+	auto const next_action = Decision::follow_target_path();
+	target_f_hat -= engine.get_adjusted_cost(engine.get_operators()[next_action]);
+	return next_action;
+}
+
 
 
 }
@@ -16,7 +16,6 @@ struct DistributionDecider : public Decision
 
 	double target_h_hat;
 	double target_f_hat;
-	std::vector<OperatorID> target_path;
 	StateID target_state_id;
 
 	DistributionDecider(StateRegistry const &state_registry,
@@ -26,6 +25,7 @@ struct DistributionDecider : public Decision
 	virtual ~DistributionDecider() = default;
 
 	OperatorID decide(std::vector<StateID> const &frontier, SearchSpace &ss) final;
+	OperatorID follow_target_path() final;
 
 };
 
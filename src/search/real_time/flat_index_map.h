@@ -0,0 +1,113 @@
+#ifndef REAL_TIME_FLAT_INDEX_MAP_H
+#define REAL_TIME_FLAT_INDEX_MAP_H
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace real_time
+{
+
+// Maps keys to dense indices 0, 1, 2, ... in insertion order.  The
+// table uses open addressing with linear probing over a single array
+// of slots.  Every slot remembers the generation it was written in, so
+// clear() only bumps the generation and leaves the memory alone.
+// Erasing single keys is not supported.
+template<typename Key, typename Hash = std::hash<Key>>
+class FlatIndexMap
+{
+	struct Slot
+	{
+		Key key;
+		int index;
+		std::uint32_t generation;
+	};
+
+	// fills unused slots.  Its value does not matter since slots
+	// are told apart by their generation.
+	Key empty_key;
+	std::vector<Slot> slots;
+	std::size_t mask;
+	std::uint32_t generation;
+	int num_entries;
+
+	std::size_t home(Key const &key) const
+	{
+		// the std::hash of most of our keys is the identity, so
+		// spread it before masking
+		auto h = static_cast<std::uint64_t>(Hash()(key));
+		return static_cast<std::size_t>((h * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+	}
+
+	void grow()
+	{
+		std::vector<Slot> old;
+		old.swap(slots);
+		slots.assign(old.empty() ? 64 : 2 * old.size(), Slot{empty_key, -1, 0});
+		mask = slots.size() - 1;
+		auto const old_generation = generation;
+		generation = 1;
+		for (auto const &slot : old) {
+			if (slot.generation != old_generation)
+				continue;
+			std::size_t i = home(slot.key);
+			while (slots[i].generation == generation)
+				i = (i + 1) & mask;
+			slots[i] = Slot{slot.key, slot.index, generation};
+		}
+	}
+
+public:
+	static constexpr int no_index = -1;
+
+	explicit FlatIndexMap(Key const &empty_key = Key())
+		: empty_key(empty_key), mask(0), generation(1), num_entries(0)
+	{
+	}
+
+	// O(1) unless the generation counter wraps around.
+	void clear()
+	{
+		num_entries = 0;
+		if (++generation == 0) {
+			for (auto &slot : slots)
+				slot.generation = 0;
+			generation = 1;
+		}
+	}
+
+	int size() const { return num_entries; }
+	bool empty() const { return num_entries == 0; }
+
+	int find(Key const &key) const
+	{
+		if (slots.empty())
+			return no_index;
+		for (std::size_t i = home(key); slots[i].generation == generation; i = (i + 1) & mask) {
+			if (slots[i].key == key)
+				return slots[i].index;
+		}
+		return no_index;
+	}
+
+	// Returns the index of key, assigning the next free index if the
+	// key is new.  The second member is true iff the key was inserted.
+	std::pair<int, bool> insert(Key const &key)
+	{
+		// keep the load factor below 1/2
+		if (2 * (static_cast<std::size_t>(num_entries) + 1) > slots.size())
+			grow();
+		std::size_t i = home(key);
+		for (; slots[i].generation == generation; i = (i + 1) & mask) {
+			if (slots[i].key == key)
+				return {slots[i].index, false};
+		}
+		slots[i] = Slot{key, num_entries, generation};
+		return {num_entries++, true};
+	}
+};
+
+}
+
+#endif
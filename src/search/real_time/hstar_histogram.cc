@@ -0,0 +1,74 @@
+#include "hstar_histogram.h"
+
+#include "../utils/system.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace real_time
+{
+
+HStarHistogram::HStarHistogram(DataFeatureKind kind)
+	: kind(kind), total(0)
+{
+}
+
+void HStarHistogram::add(int h, int ph, int hstar, long long count)
+{
+	counts[std::make_pair(h, kind == WithParentH ? ph : 0)][hstar] += count;
+	total += count;
+}
+
+void HStarHistogram::read(std::string const &file_name)
+{
+	std::ifstream f(file_name);
+	if (!f) {
+		std::cerr << "error: could not read " << file_name << std::endl;
+		utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+	}
+	std::string line;
+	while (std::getline(f, line)) {
+		std::stringstream ss(line);
+		DataFeature const feat = read_data_feat(ss, kind);
+		long long value_count;
+		ss >> value_count;
+		int hstar;
+		long long count;
+		while (ss >> hstar >> count)
+			add(feat.h, feat.ph, hstar, count);
+	}
+}
+
+void HStarHistogram::write(std::string const &file_name) const
+{
+	std::string const tmp_name = file_name + ".tmp." + std::to_string(utils::get_process_id());
+	{
+		std::ofstream out(tmp_name, std::ios::trunc);
+		for (auto const &entry : counts) {
+			long long value_count = 0;
+			for (auto const &sample : entry.second)
+				value_count += sample.second;
+			out << entry.first.first;
+			if (kind == WithParentH)
+				out << " " << entry.first.second;
+			out << " " << value_count;
+			for (auto const &sample : entry.second)
+				out << " " << sample.first << " " << sample.second;
+			out << "\n";
+		}
+		if (!out) {
+			std::cerr << "error: could not write " << tmp_name << std::endl;
+			std::remove(tmp_name.c_str());
+			utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+		}
+	}
+	if (std::rename(tmp_name.c_str(), file_name.c_str()) != 0) {
+		std::cerr << "error: could not move " << tmp_name << " to " << file_name << std::endl;
+		std::remove(tmp_name.c_str());
+		utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+	}
+}
+
+}
@@ -0,0 +1,42 @@
+#ifndef REAL_TIME_HSTAR_HISTOGRAM_H
+#define REAL_TIME_HSTAR_HISTOGRAM_H
+
+#include "belief_data.h"
+
+#include <map>
+#include <string>
+#include <utility>
+
+namespace real_time
+{
+
+// Counts of h* values per feature, i.e. the aggregated text format
+// read by HStarData.  Each line of that format holds the feature (h,
+// or h and ph), the total number of samples, and pairs of h* value and
+// count, both in ascending order.  This replaces the aggregation done
+// by combine_hstar.py and combine_phstar.py.  Not thread-safe.
+class HStarHistogram
+{
+	DataFeatureKind kind;
+	// ph is 0 for JustH features
+	std::map<std::pair<int, int>, std::map<int, long long>> counts;
+	long long total;
+public:
+	explicit HStarHistogram(DataFeatureKind kind);
+
+	void add(int h, int ph, int hstar, long long count = 1);
+
+	// adds the samples of an aggregated file of the same kind
+	void read(std::string const &file_name);
+
+	// writes to a private file first and renames it, so the file is
+	// always either the previous or the new complete histogram
+	void write(std::string const &file_name) const;
+
+	long long get_num_samples() const { return total; }
+	size_t get_num_features() const { return counts.size(); }
+};
+
+}
+
+#endif
@@ -0,0 +1,422 @@
+#include "hstar_sampler.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../open_list_factory.h"
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../algorithms/int_packer.h"
+#include "../search_engines/search_common.h"
+#include "../task_utils/sampling.h"
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/rng.h"
+
+#include <fstream>
+#include <limits>
+#include <thread>
+#include <unordered_set>
+
+namespace real_time
+{
+
+HStarCache::HStarCache(int num_shards)
+{
+	for (int i = 0; i < num_shards; ++i)
+		shards.push_back(std::make_unique<Shard>());
+}
+
+HStarCache::Shard &HStarCache::get_shard(std::vector<PackedStateBin> const &state) const
+{
+	// the maps hash the same key, so use other bits to pick the shard
+	return *shards[(utils::get_hash64(state) >> 32) % shards.size()];
+}
+
+int HStarCache::lookup(std::vector<PackedStateBin> const &state) const
+{
+	Shard &shard = get_shard(state);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	auto const it = shard.hstar_values.find(state);
+	return it == shard.hstar_values.end() ? -1 : it->second;
+}
+
+bool HStarCache::insert(std::vector<PackedStateBin> const &state, int hstar)
+{
+	Shard &shard = get_shard(state);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	return shard.hstar_values.emplace(state, hstar).second;
+}
+
+size_t HStarCache::size() const
+{
+	size_t total = 0;
+	for (auto const &shard : shards) {
+		std::lock_guard<std::mutex> lock(shard->mutex);
+		total += shard->hstar_values.size();
+	}
+	return total;
+}
+
+HStarSampler::Worker::Worker()
+	: num_short_cuts(0)
+{
+}
+
+HStarSampler::Worker::~Worker()
+{
+	// the search space refers to the registry
+	space.reset();
+}
+
+HStarSampler::HStarSampler(options::Options const &opts, options::Registry &registry,
+			   options::Predefinitions const &predefinitions)
+	: SearchEngine(opts),
+	  eval_config(opts.get<options::ParseTree>("eval")),
+	  registry(registry),
+	  predefinitions(predefinitions),
+	  num_threads(opts.get<int>("threads")),
+	  num_samples(opts.get<int>("samples")),
+	  random_seed(opts.get<int>("random_seed")),
+	  collect_parent_h(opts.get<bool>("collect_parent_h")),
+	  hstar_file(opts.get<std::string>("hstar_file")),
+	  append(opts.get<bool>("append")),
+	  checkpoint_interval(opts.get<int>("checkpoint_interval")),
+	  cache(64),
+	  initial_h(0),
+	  next_sample(0),
+	  timed_out(false),
+	  histogram(collect_parent_h ? WithParentH : JustH),
+	  num_solved(0),
+	  num_unsolvable(0)
+{
+	if (opts.contains("sample_file"))
+		sample_writer = std::make_unique<SampleWriter>(
+			opts.get<std::string>("sample_file"), get_sample_format(opts), HStarSamples, collect_parent_h);
+	// the registries of all threads share the axiom evaluator of the task
+	task_properties::verify_no_axioms(task_proxy);
+}
+
+HStarSampler::~HStarSampler()
+{
+}
+
+void HStarSampler::initialize()
+{
+	std::cout << "Sampling " << num_samples << " h* values with " << num_threads << " threads" << std::endl;
+
+	// evaluators are not thread-safe, so each thread parses its own
+	for (int thread = 0; thread < num_threads; ++thread) {
+		auto worker = std::make_unique<Worker>();
+		options::OptionParser parser(eval_config, registry, predefinitions, false);
+		worker->evaluator = parser.start_parsing<std::shared_ptr<Evaluator>>();
+		if (!workers.empty() && workers.front()->evaluator == worker->evaluator) {
+			std::cerr << "sample_hstar needs one evaluator per thread, "
+				  << "so the evaluator must not be a predefined one" << std::endl;
+			utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+		}
+		options::Options open_opts;
+		open_opts.set("eval", worker->evaluator);
+		auto open_and_f = search_common::create_astar_open_list_factory_and_f_eval(open_opts);
+		worker->open_list = open_and_f.first->create_state_open_list();
+		worker->f_evaluator = open_and_f.second;
+		worker->rng = std::make_unique<utils::RandomNumberGenerator>(random_seed + thread);
+		worker->sampler = std::make_unique<sampling::RandomWalkSampler>(task_proxy, *worker->rng);
+		worker->buffer.resize(state_registry.get_bins_per_state());
+		workers.push_back(std::move(worker));
+	}
+
+	EvaluationContext eval_context(state_registry.get_initial_state(), 0, true, &statistics);
+	if (eval_context.is_evaluator_value_infinite(workers.front()->evaluator.get())) {
+		std::cerr << "error: the initial state is a dead end" << std::endl;
+		utils::exit_with(utils::ExitCode::SEARCH_UNSOLVABLE);
+	}
+	initial_h = eval_context.get_evaluator_value(workers.front()->evaluator.get());
+
+	if (append && std::ifstream(hstar_file)) {
+		histogram.read(hstar_file);
+		std::cout << "appending to " << histogram.get_num_samples() << " samples in " << hstar_file << std::endl;
+	}
+}
+
+SearchStatus HStarSampler::step()
+{
+	deadline = std::chrono::steady_clock::now()
+		+ std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			std::chrono::duration<double>(std::min(max_time, 1e9)));
+
+	std::vector<std::thread> threads;
+	for (int thread = 1; thread < num_threads; ++thread)
+		threads.emplace_back(&HStarSampler::work, this, thread);
+	work(0);
+	for (auto &t : threads)
+		t.join();
+
+	for (auto const &worker : workers) {
+		statistics.inc_expanded(worker->statistics.get_expanded());
+		statistics.inc_evaluated_states(worker->statistics.get_evaluated_states());
+		statistics.inc_evaluations(worker->statistics.get_evaluations());
+		statistics.inc_generated(worker->statistics.get_generated());
+		statistics.inc_reopened(worker->statistics.get_reopened());
+	}
+
+	histogram.write(hstar_file);
+	std::cout << "wrote " << histogram.get_num_samples() << " h* samples to " << hstar_file << std::endl;
+	if (sample_writer) {
+		sample_writer->flush();
+		std::cout << "streamed " << sample_writer->get_num_records() << " h* samples to "
+			  << sample_writer->get_file_name() << std::endl;
+	}
+	if (timed_out)
+		return TIMEOUT;
+	// the data is written, but there is no plan
+	std::cout << "sampling done, no plan was searched for" << std::endl;
+	return FAILED;
+}
+
+void HStarSampler::work(int thread)
+{
+	Worker &worker = *workers[thread];
+	std::vector<PackedStateBin> root;
+	while (!timed_out && next_sample++ < num_samples) {
+		pack(worker.sampler->sample_state(initial_h), root);
+		bool const solved = solve(worker, root);
+		if (timed_out)
+			return;
+
+		std::lock_guard<std::mutex> lock(histogram_mutex);
+		if (!solved) {
+			++num_unsolvable;
+			continue;
+		}
+		++num_solved;
+		if (checkpoint_interval > 0 && num_solved % checkpoint_interval == 0) {
+			histogram.write(hstar_file);
+			std::cout << "solved " << num_solved << " samples, " << histogram.get_num_samples() << " h* samples" << std::endl;
+		}
+	}
+}
+
+void HStarSampler::pack(State const &state, std::vector<PackedStateBin> &buffer) const
+{
+	int_packer::IntPacker const &packer = task_properties::g_state_packers[task_proxy];
+	buffer.assign(packer.get_num_bins(), 0);
+	for (size_t var = 0; var < state.size(); ++var)
+		packer.set(buffer.data(), var, state[var].get_value());
+}
+
+bool HStarSampler::solve(Worker &worker, std::vector<PackedStateBin> const &root_data)
+{
+	// a fresh registry per solve keeps the memory bounded by one solve
+	worker.space.reset();
+	worker.registry = std::make_unique<StateRegistry>(task_proxy);
+	worker.space = std::make_unique<SearchSpace>(*worker.registry);
+	worker.open_list->clear();
+	StateRegistry &states = *worker.registry;
+	SearchStatistics &stats = worker.statistics;
+
+	if (cache.lookup(root_data) >= 0)
+		return true;
+
+	GlobalState const root = states.register_state(root_data.data());
+	EvaluationContext root_context(root, 0, true, &stats);
+	stats.inc_evaluated_states();
+	if (worker.open_list->is_dead_end(root_context))
+		return false;
+	worker.space->get_node(root).open_initial();
+	worker.open_list->insert(root_context, root.get_id());
+
+	int best_cost = std::numeric_limits<int>::max();
+	StateID best_state = StateID::no_state;
+	int best_hstar = 0;
+	std::unordered_set<StateID> known_states;
+	int since_time_check = 0;
+
+	while (!worker.open_list->empty()) {
+		if (++since_time_check == 256) {
+			since_time_check = 0;
+			if (std::chrono::steady_clock::now() >= deadline)
+				timed_out = true;
+		}
+		if (timed_out)
+			return false;
+
+		StateID const id = worker.open_list->remove_min();
+		GlobalState const s = states.lookup_state(id);
+		SearchNode node = worker.space->get_node(s);
+		if (node.is_closed())
+			continue;
+
+		EvaluationContext eval_context(s, node.get_g(), false, &stats);
+		if (eval_context.get_evaluator_value_or_infinity(worker.f_evaluator.get()) >= best_cost)
+			break;
+		node.close();
+		stats.inc_expanded();
+
+		if (task_properties::is_goal_state(task_proxy, s)) {
+			best_cost = node.get_g();
+			best_state = id;
+			best_hstar = 0;
+			break;
+		}
+		// every path through a known state costs at least the
+		// solution we already know through it
+		if (known_states.count(id))
+			continue;
+
+		worker.applicable_ops.clear();
+		successor_generator.generate_applicable_ops(s, worker.applicable_ops);
+		for (OperatorID const op_id : worker.applicable_ops) {
+			OperatorProxy const op = task_proxy.get_operators()[op_id];
+			int const succ_g = node.get_g() + get_adjusted_cost(op);
+			if (succ_g >= best_cost)
+				continue;
+
+			states.get_successor_data(s, op, worker.buffer.data());
+			GlobalState const succ_state = states.register_state(worker.buffer.data());
+			stats.inc_generated();
+			SearchNode succ_node = worker.space->get_node(succ_state);
+			if (succ_node.is_dead_end())
+				continue;
+
+			if (succ_node.is_new()) {
+				EvaluationContext succ_context(succ_state, succ_g, false, &stats);
+				stats.inc_evaluated_states();
+				if (worker.open_list->is_dead_end(succ_context)) {
+					succ_node.mark_as_dead_end();
+					stats.inc_dead_ends();
+					continue;
+				}
+				succ_node.open(node, op, get_adjusted_cost(op));
+				worker.open_list->insert(succ_context, succ_state.get_id());
+			} else if (succ_node.get_g() > succ_g) {
+				if (succ_node.is_closed())
+					stats.inc_reopened();
+				succ_node.reopen(node, op, get_adjusted_cost(op));
+				EvaluationContext succ_context(succ_state, succ_g, false, &stats);
+				worker.open_list->insert(succ_context, succ_state.get_id());
+			} else {
+				continue;
+			}
+
+			int const known_hstar = cache.lookup(worker.buffer);
+			if (known_hstar >= 0) {
+				known_states.insert(succ_state.get_id());
+				if (succ_g + known_hstar < best_cost) {
+					best_cost = succ_g + known_hstar;
+					best_state = succ_state.get_id();
+					best_hstar = known_hstar;
+					++worker.num_short_cuts;
+				}
+			}
+		}
+	}
+
+	if (best_state == StateID::no_state)
+		return false;
+	record_path(worker, root, states.lookup_state(best_state), best_hstar);
+	return true;
+}
+
+void HStarSampler::record_path(Worker &worker, GlobalState const &root, GlobalState const &last, int last_hstar)
+{
+	StateRegistry &states = *worker.registry;
+
+	// the path from the root to last, and the h* value of each state
+	std::vector<GlobalState> path{last};
+	std::vector<OperatorID> ops;
+	std::vector<int> hstars{last_hstar};
+	while (path.back().get_id() != root.get_id()) {
+		SearchNode const node = worker.space->get_node(path.back());
+		OperatorID const op = node.get_creating_operator();
+		hstars.push_back(hstars.back() + get_adjusted_cost(task_proxy.get_operators()[op]));
+		ops.push_back(op);
+		path.push_back(states.lookup_state(node.get_parent_state_id()));
+	}
+
+	struct Sample
+	{
+		int h;
+		int ph;
+		int hstar;
+	};
+	std::vector<Sample> samples;
+	int ph = -1;
+	pack(root.unpack(), worker.buffer);
+	for (size_t i = path.size(); i-- > 0;) {
+		if (i + 1 < path.size())
+			states.get_successor_data(path[i + 1], task_proxy.get_operators()[ops[i]], worker.buffer.data());
+		EvaluationContext eval_context(path[i]);
+		int const h = eval_context.get_evaluator_value(worker.evaluator.get());
+		// like compute_hstar, the root is its own parent
+		if (ph < 0)
+			ph = h;
+		assert(h <= hstars[i]);
+		if (cache.insert(worker.buffer, hstars[i]))
+			samples.push_back(Sample{h, ph, hstars[i]});
+		ph = h;
+	}
+
+	std::lock_guard<std::mutex> lock(histogram_mutex);
+	for (Sample const &sample : samples) {
+		histogram.add(sample.h, sample.ph, sample.hstar);
+		if (sample_writer)
+			sample_writer->write_hstar(sample.h, sample.hstar, sample.ph);
+	}
+	if (sample_writer)
+		sample_writer->flush();
+}
+
+void HStarSampler::print_statistics() const
+{
+	statistics.print_detailed_statistics();
+	long long num_short_cuts = 0;
+	for (auto const &worker : workers)
+		num_short_cuts += worker->num_short_cuts;
+	std::cout << "Solved samples: " << num_solved << std::endl;
+	std::cout << "Unsolvable samples: " << num_unsolvable << std::endl;
+	std::cout << "Solved states: " << cache.size() << std::endl;
+	std::cout << "Solutions through known states: " << num_short_cuts << std::endl;
+	std::cout << "h* samples: " << histogram.get_num_samples() << std::endl;
+	std::cout << "h* features: " << histogram.get_num_features() << std::endl;
+}
+
+static std::shared_ptr<SearchEngine> _parse(options::OptionParser &parser)
+{
+	parser.document_synopsis(
+		"Parallel h* sampling",
+		"Samples states with random walks, solves them optimally with A* on "
+		"several threads and writes the aggregated h* histogram read by the "
+		"hstar_data option of real_time. All states on the optimal path of a "
+		"sample contribute a sample. Solutions are shared between threads. "
+		"The samples can be streamed to sample_file as well, one line (or "
+		"record) per sample, flushed after every solved sample. Does not "
+		"search for a plan, so the planner reports that no solution was "
+		"found once the data is written.");
+	parser.add_option<options::ParseTree>("eval", "admissible evaluator for the h-value; parsed once per thread, so it must not be a predefined one");
+	parser.add_option<int>("threads", "number of threads", "1", options::Bounds("1", ""));
+	parser.add_option<int>("samples", "number of states to sample", "1000", options::Bounds("1", ""));
+	parser.add_option<int>("random_seed", "seed for the random walks; thread i uses seed + i", "0");
+	parser.add_option<bool>("collect_parent_h", "use (h, ph) features, where ph is the h of the predecessor on the optimal path", "false");
+	parser.add_option<std::string>("hstar_file", "file to write the aggregated h* values to", "hstar_values.txt");
+	parser.add_option<bool>("append", "add to the samples already in hstar_file", "false");
+	parser.add_option<int>("checkpoint_interval", "rewrite hstar_file after this many solved samples (0: only at the end)", "100", options::Bounds("0", ""));
+	parser.add_option<std::string>("sample_file", "file to stream the single h* samples to as they are collected, in the format of compute_hstar", options::OptionParser::NONE);
+	add_sample_format_option(parser);
+	SearchEngine::add_options_to_parser(parser);
+	options::Options opts = parser.parse();
+
+	if (parser.help_mode()) {
+		return nullptr;
+	} else if (parser.dry_run()) {
+		options::OptionParser eval_parser(opts.get<options::ParseTree>("eval"), parser.get_registry(),
+						  parser.get_predefinitions(), true);
+		eval_parser.start_parsing<std::shared_ptr<Evaluator>>();
+		return nullptr;
+	}
+	return std::make_shared<HStarSampler>(opts, parser.get_registry(), parser.get_predefinitions());
+}
+
+static options::Plugin<SearchEngine> _plugin("sample_hstar", _parse);
+
+}
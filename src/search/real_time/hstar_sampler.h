@@ -0,0 +1,136 @@
+#ifndef REAL_TIME_HSTAR_SAMPLER_H
+#define REAL_TIME_HSTAR_SAMPLER_H
+
+#include "hstar_histogram.h"
+#include "sample_writer.h"
+
+#include "../open_list.h"
+#include "../option_parser_util.h"
+#include "../search_engine.h"
+#include "../search_space.h"
+
+#include "../options/predefinitions.h"
+#include "../options/registries.h"
+#include "../utils/hash.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class Evaluator;
+
+namespace sampling {
+class RandomWalkSampler;
+}
+
+namespace utils {
+class RandomNumberGenerator;
+}
+
+namespace real_time
+{
+
+// h* values of solved states, shared by all threads of the sampler.
+// States are identified by their packed data, since every thread
+// registers states in its own registry.
+class HStarCache
+{
+	struct Shard
+	{
+		std::mutex mutex;
+		utils::HashMap<std::vector<PackedStateBin>, int> hstar_values;
+	};
+	std::vector<std::unique_ptr<Shard>> shards;
+
+	Shard &get_shard(std::vector<PackedStateBin> const &state) const;
+public:
+	explicit HStarCache(int num_shards);
+
+	// returns -1 if the h* value of the state is not known
+	int lookup(std::vector<PackedStateBin> const &state) const;
+	// returns false if the h* value of the state was already known
+	bool insert(std::vector<PackedStateBin> const &state, int hstar);
+	size_t size() const;
+};
+
+// Generates training data without the serial solve loop of
+// compute_hstar.  Each thread samples states with random walks,
+// solves them optimally with A* and adds (h, ph, h*) for every state
+// on the optimal path to a histogram in the format of HStarData.  The
+// samples can also be streamed to a sample file as they are collected.
+// The sampler does not look for a plan, so it never reports one.
+//
+// Solved states go into a shared h* cache.  When A* generates a state
+// whose h* is known, it knows a solution through that state and stops
+// as soon as no open state can lead to a cheaper one, so later solves
+// reuse the solutions of earlier ones.
+class HStarSampler : public SearchEngine
+{
+	struct Worker
+	{
+		std::unique_ptr<StateRegistry> registry;
+		std::unique_ptr<SearchSpace> space;
+		std::shared_ptr<Evaluator> evaluator;
+		std::shared_ptr<Evaluator> f_evaluator;
+		std::unique_ptr<StateOpenList> open_list;
+		std::unique_ptr<utils::RandomNumberGenerator> rng;
+		std::unique_ptr<sampling::RandomWalkSampler> sampler;
+		SearchStatistics statistics;
+		std::vector<OperatorID> applicable_ops;
+		std::vector<PackedStateBin> buffer;
+		long long num_short_cuts;
+
+		Worker();
+		~Worker();
+	};
+
+	const options::ParseTree eval_config;
+	options::Registry registry;
+	options::Predefinitions predefinitions;
+	const int num_threads;
+	const int num_samples;
+	const int random_seed;
+	const bool collect_parent_h;
+	const std::string hstar_file;
+	const bool append;
+	const int checkpoint_interval;
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	HStarCache cache;
+	int initial_h;
+
+	std::atomic<int> next_sample;
+	std::atomic<bool> timed_out;
+	std::chrono::steady_clock::time_point deadline;
+
+	std::mutex histogram_mutex;
+	HStarHistogram histogram;
+	// written as the samples are collected, flushed after every
+	// solved sample; guarded by histogram_mutex as well
+	std::unique_ptr<SampleWriter> sample_writer;
+	int num_solved;
+	int num_unsolvable;
+
+	void work(int thread);
+	void pack(State const &state, std::vector<PackedStateBin> &buffer) const;
+	// returns whether the sample was solved
+	bool solve(Worker &worker, std::vector<PackedStateBin> const &root);
+	void record_path(Worker &worker, GlobalState const &root, GlobalState const &last, int last_hstar);
+
+protected:
+	void initialize() override;
+	SearchStatus step() override;
+
+public:
+	HStarSampler(options::Options const &opts, options::Registry &registry,
+		     options::Predefinitions const &predefinitions);
+	~HStarSampler() override;
+
+	void print_statistics() const override;
+};
+
+}
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef REAL_TIME_INDEXED_HEAP_H
+#define REAL_TIME_INDEXED_HEAP_H
+
+#include <cassert>
+#include <vector>
+
+namespace real_time
+{
+
+// Min-heap over dense indices 0, 1, 2, ... with decrease-key.  Every
+// index is in the heap at most once, so the heap never holds more
+// entries than there are indices, and an index that was already popped
+// is not pushed again unless the caller does so explicitly.  Entries
+// only hold the key and the index; whatever data belongs to an index
+// is looked up by the caller.  The heap is Arity-ary to keep sift-down
+// within few cache lines.
+template<typename Key, int Arity = 4>
+class IndexedHeap
+{
+	static_assert(Arity >= 2, "a heap needs at least two children per node");
+
+	struct Entry
+	{
+		Key key;
+		int index;
+	};
+
+	std::vector<Entry> heap;
+	// position of each index in heap, or not_in_heap
+	std::vector<int> positions;
+
+	static constexpr int not_in_heap = -1;
+
+	void place(int pos, Entry const &entry)
+	{
+		heap[pos] = entry;
+		positions[entry.index] = pos;
+	}
+
+	void sift_up(int pos, Entry const &entry)
+	{
+		while (pos > 0) {
+			int const parent = (pos - 1) / Arity;
+			if (!(entry.key < heap[parent].key))
+				break;
+			place(pos, heap[parent]);
+			pos = parent;
+		}
+		place(pos, entry);
+	}
+
+	void sift_down(int pos, Entry const &entry)
+	{
+		int const n = static_cast<int>(heap.size());
+		for (;;) {
+			int const first = pos * Arity + 1;
+			if (first >= n)
+				break;
+			int const last = first + Arity < n ? first + Arity : n;
+			int best = first;
+			for (int child = first + 1; child < last; ++child) {
+				if (heap[child].key < heap[best].key)
+					best = child;
+			}
+			if (!(heap[best].key < entry.key))
+				break;
+			place(pos, heap[best]);
+			pos = best;
+		}
+		place(pos, entry);
+	}
+
+public:
+	// makes room for the indices 0, ..., size - 1
+	void resize(int size)
+	{
+		assert(heap.empty());
+		positions.assign(size, not_in_heap);
+	}
+
+	int capacity() const { return static_cast<int>(positions.size()); }
+	bool empty() const { return heap.empty(); }
+	int size() const { return static_cast<int>(heap.size()); }
+	bool contains(int index) const { return positions[index] != not_in_heap; }
+
+	// Inserts index, or lowers its key if it is in the heap with a
+	// larger one.  Returns whether the heap changed.
+	bool push_or_decrease(int index, Key const &key)
+	{
+		assert(0 <= index && index < capacity());
+		int const pos = positions[index];
+		if (pos == not_in_heap) {
+			heap.push_back(Entry{key, index});
+			sift_up(static_cast<int>(heap.size()) - 1, Entry{key, index});
+			return true;
+		}
+		if (!(key < heap[pos].key))
+			return false;
+		sift_up(pos, Entry{key, index});
+		return true;
+	}
+
+	Key const &top_key() const
+	{
+		assert(!empty());
+		return heap.front().key;
+	}
+
+	int pop()
+	{
+		assert(!empty());
+		int const index = heap.front().index;
+		positions[index] = not_in_heap;
+		Entry const last = heap.back();
+		heap.pop_back();
+		if (!heap.empty())
+			sift_down(0, last);
+		return index;
+	}
+
+	// O(size()), the positions are kept for reuse
+	void clear()
+	{
+		for (auto const &entry : heap)
+			positions[entry.index] = not_in_heap;
+		heap.clear();
+	}
+};
+
+}
+
+#endif
@@ -37,6 +37,26 @@ enum class BoundKind
 	TIME,
 };
 
+enum class RiskKernel
+{
+	NESTED,
+	CDF,
+};
+
+enum class LearningQueue
+{
+	HEAP,
+	RADIX,
+};
+
+enum class CommitmentPolicy
+{
+	SINGLE,
+	FIXED,
+	TARGET,
+	DYNAMIC,
+};
+
 }
 
 #endif
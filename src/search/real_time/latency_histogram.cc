@@ -0,0 +1,75 @@
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <ostream>
+
+namespace real_time
+{
+
+LatencyHistogram::LatencyHistogram()
+	: counts((64 - sub_bits + 1) * sub_count, 0),
+	  total(0),
+	  max_value(0)
+{
+}
+
+int LatencyHistogram::get_bucket(std::uint64_t value)
+{
+	if (value < sub_count)
+		return static_cast<int>(value);
+#ifdef __GNUC__
+	int const msb = 63 - __builtin_clzll(value);
+#else
+	int msb = 0;
+	for (auto v = value; v > 1; v >>= 1)
+		++msb;
+#endif
+	int const shift = msb - sub_bits;
+	auto const mantissa = value >> shift;
+	return static_cast<int>((shift + 1) * sub_count + (mantissa - sub_count));
+}
+
+std::uint64_t LatencyHistogram::get_bucket_max(int bucket)
+{
+	if (bucket < static_cast<int>(sub_count))
+		return bucket;
+	int const shift = bucket / sub_count - 1;
+	auto const mantissa = sub_count + bucket % sub_count;
+	return ((mantissa + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(std::uint64_t ns)
+{
+	++counts[get_bucket(ns)];
+	++total;
+	max_value = std::max(max_value, ns);
+}
+
+std::uint64_t LatencyHistogram::percentile(double fraction) const
+{
+	assert(0 <= fraction && fraction <= 1);
+	if (total == 0)
+		return 0;
+	auto const rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(fraction * total)));
+	std::uint64_t seen = 0;
+	for (std::size_t bucket = 0; bucket < counts.size(); ++bucket) {
+		seen += counts[bucket];
+		if (seen >= rank)
+			return std::min(get_bucket_max(bucket), max_value);
+	}
+	return max_value;
+}
+
+void LatencyHistogram::print(std::ostream &out) const
+{
+	auto const us = [](std::uint64_t ns) { return ns / 1000.0; };
+	out << "p50 " << us(percentile(0.5)) << "us, "
+	    << "p90 " << us(percentile(0.9)) << "us, "
+	    << "p99 " << us(percentile(0.99)) << "us, "
+	    << "p99.9 " << us(percentile(0.999)) << "us, "
+	    << "max " << us(max_value) << "us";
+}
+
+}
@@ -0,0 +1,46 @@
+#ifndef REAL_TIME_LATENCY_HISTOGRAM_H
+#define REAL_TIME_LATENCY_HISTOGRAM_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace real_time
+{
+
+// Histogram of durations in nanoseconds with log-linear buckets: the
+// values below 2^sub_bits have a bucket each, and every power of two
+// above is split into 2^sub_bits buckets of equal width.  Percentiles
+// are thus off by at most 1/2^sub_bits (about 3%), while recording a
+// value is a few bit operations and the histogram has a fixed size
+// no matter how many values it holds.
+class LatencyHistogram
+{
+	static constexpr int sub_bits = 5;
+	static constexpr std::uint64_t sub_count = std::uint64_t(1) << sub_bits;
+
+	std::vector<std::uint64_t> counts;
+	std::uint64_t total;
+	std::uint64_t max_value;
+
+	static int get_bucket(std::uint64_t value);
+	// largest value that falls into the bucket
+	static std::uint64_t get_bucket_max(int bucket);
+public:
+	LatencyHistogram();
+
+	void record(std::uint64_t ns);
+
+	std::uint64_t size() const { return total; }
+	std::uint64_t max() const { return max_value; }
+	// smallest value such that at least the given fraction of the
+	// recorded values is not larger, up to the bucket width
+	std::uint64_t percentile(double fraction) const;
+
+	// p50, p90, p99, p99.9 and max in microseconds on one line
+	void print(std::ostream &out) const;
+};
+
+}
+
+#endif
@@ -1,10 +1,9 @@
 #ifndef REAL_TIME_LEARNING_H
 #define REAL_TIME_LEARNING_H
 
-#include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
+#include "lookahead_arena.h"
 #include "../state_id.h"
 #include "../search_engine.h"
 #include "../state_registry.h"
@@ -20,22 +19,40 @@ struct Learning
 	SearchEngine const *search_engine; // need this just so I can call get_adjusted_cost
 	size_t initial_effort;
 
-	// passed in each iteration during initialize
-	std::unordered_map<StateID, std::vector<std::pair<StateID, OperatorProxy>>> const *predecessors;
-	std::unordered_set<StateID> *closed; // consumed during learning
+	// passed in each iteration during initialize.  the closed
+	// states are consumed during learning.
+	LookaheadArena *arena;
 
 	Learning(StateRegistry const &state_registry,
 		 SearchEngine const *search_engine);
 	virtual ~Learning() = default;
 
-	virtual void initialize(const std::unordered_map<StateID, std::vector<std::pair<StateID, OperatorProxy>>> &predecessors,
-			const std::vector<StateID> &frontier,
-			std::unordered_set<StateID> &closed) = 0;
+	virtual void initialize(LookaheadArena &arena,
+			const std::vector<StateID> &frontier) = 0;
 
 	virtual void step() = 0;
 	virtual bool done() = 0;
 	virtual size_t effort() = 0;
 	virtual size_t remaining() = 0;
+	// Stops a phase started with initialize() before it is done.
+	// The phase starts the closed states at infinity, which the
+	// lookahead would take for dead ends, so the states it did not
+	// learn a value for yet get back the ones they had before.
+	virtual void abandon() = 0;
+
+	// Asynchronous learning.  Instead of initialize() and step(),
+	// the search thread calls snapshot(), which copies the arena and
+	// the values of all states the backup reads or writes.  run()
+	// then does the whole backup on these copies, so it can run on
+	// another thread while the next lookahead goes on and changes
+	// the registry, the arena and the value tables.  publish() is
+	// called on the search thread once run() returned and writes the
+	// learned values back.  Until then, the search sees the values
+	// from before this learning phase.
+	virtual void snapshot(LookaheadArena const &arena,
+			      const std::vector<StateID> &frontier) = 0;
+	virtual void run() = 0;
+	virtual void publish() = 0;
 };
 
 }
@@ -29,6 +29,8 @@ public:
 	auto does_cache_estimates() const -> bool override { return base_evaluator->does_cache_estimates(); }
 	auto is_estimate_cached(const GlobalState &state) const -> bool override { return updated_values[state] != NO_VALUE || base_evaluator->is_estimate_cached(state); }
 	auto get_cached_estimate(const GlobalState &state) const -> int override { return updated_values[state] != NO_VALUE ? updated_values[state] : base_evaluator->get_cached_estimate(state); }
+	auto is_base_estimate_cached(const GlobalState &state) const -> bool { return base_evaluator->is_estimate_cached(state); }
+	auto get_base_estimate(const GlobalState &state) const -> int { return base_evaluator->get_cached_estimate(state); }
 };
 
 }
@@ -0,0 +1,126 @@
+#include "lookahead_arena.h"
+
+#include <cassert>
+
+namespace real_time
+{
+
+LookaheadArena::LookaheadArena()
+	: index(StateID::no_state),
+	  num_closed(0)
+{
+}
+
+int LookaheadArena::get_or_insert(StateID state_id)
+{
+	auto const [i, inserted] = index.insert(state_id);
+	if (inserted) {
+		assert(i == size());
+		states.push_back(state_id);
+		first_edge.push_back(no_edge);
+		last_edge.push_back(no_edge);
+		insertion_times.push_back(0);
+		owners.push_back(no_owner);
+		closed_flags.push_back(false);
+	}
+	return i;
+}
+
+void LookaheadArena::clear()
+{
+	index.clear();
+	states.clear();
+	first_edge.clear();
+	last_edge.clear();
+	insertion_times.clear();
+	owners.clear();
+	closed_flags.clear();
+	edges.clear();
+	closed_states.clear();
+	num_closed = 0;
+}
+
+void LookaheadArena::reserve(int num_states)
+{
+	states.reserve(num_states);
+	first_edge.reserve(num_states);
+	last_edge.reserve(num_states);
+	insertion_times.reserve(num_states);
+	owners.reserve(num_states);
+	closed_flags.reserve(num_states);
+	edges.reserve(num_states);
+	closed_states.reserve(num_states);
+}
+
+void LookaheadArena::add_predecessor(StateID state_id, StateID predecessor_id, OperatorID op)
+{
+	auto const i = get_or_insert(state_id);
+	auto const e = static_cast<int>(edges.size());
+	edges.push_back(Edge{predecessor_id, op, no_edge});
+	if (last_edge[i] == no_edge)
+		first_edge[i] = e;
+	else
+		edges[last_edge[i]].next = e;
+	last_edge[i] = e;
+}
+
+LookaheadArena::EdgeRange LookaheadArena::get_predecessors(StateID state_id) const
+{
+	auto const i = index.find(state_id);
+	return EdgeRange{edges.data(), i == index.no_index ? no_edge : first_edge[i]};
+}
+
+void LookaheadArena::close(StateID state_id)
+{
+	auto const i = get_or_insert(state_id);
+	if (closed_flags[i])
+		return;
+	closed_flags[i] = true;
+	closed_states.push_back(state_id);
+	++num_closed;
+}
+
+void LookaheadArena::remove_closed(StateID state_id)
+{
+	auto const i = index.find(state_id);
+	if (i != index.no_index)
+		remove_closed_at(i);
+}
+
+void LookaheadArena::remove_closed_at(int i)
+{
+	if (!closed_flags[i])
+		return;
+	closed_flags[i] = false;
+	--num_closed;
+}
+
+bool LookaheadArena::is_closed(StateID state_id) const
+{
+	auto const i = index.find(state_id);
+	return i != index.no_index && closed_flags[i];
+}
+
+void LookaheadArena::set_insertion_time(StateID state_id, int time)
+{
+	insertion_times[get_or_insert(state_id)] = time;
+}
+
+int LookaheadArena::get_insertion_time(StateID state_id) const
+{
+	auto const i = index.find(state_id);
+	return i == index.no_index ? 0 : insertion_times[i];
+}
+
+void LookaheadArena::set_owner(StateID state_id, int owner)
+{
+	owners[get_or_insert(state_id)] = owner;
+}
+
+int LookaheadArena::get_owner(StateID state_id) const
+{
+	auto const i = index.find(state_id);
+	return i == index.no_index ? no_owner : owners[i];
+}
+
+}
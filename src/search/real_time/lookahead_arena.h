@@ -0,0 +1,108 @@
+#ifndef REAL_TIME_LOOKAHEAD_ARENA_H
+#define REAL_TIME_LOOKAHEAD_ARENA_H
+
+#include "flat_index_map.h"
+#include "../operator_id.h"
+#include "../state_id.h"
+
+#include <vector>
+
+namespace real_time
+{
+
+// Bookkeeping of a single lookahead iteration: the predecessor edges,
+// the closed states, the open list insertion times and (for risk
+// search) the tla owning each state.  Every state that shows up in
+// one of these gets a dense local index, and all data is stored in
+// flat arrays indexed by it.  The predecessor edges of a state form a
+// linked list inside one contiguous edge buffer.  clear() keeps all
+// the memory around, so after the first few iterations the expansion
+// hot path does not allocate anymore.
+class LookaheadArena
+{
+public:
+	struct Edge
+	{
+		StateID state; // the predecessor
+		OperatorID op;
+		int next;
+	};
+
+	class EdgeIterator
+	{
+		Edge const *edges;
+		int pos;
+	public:
+		EdgeIterator(Edge const *edges, int pos) : edges(edges), pos(pos) {}
+		Edge const &operator*() const { return edges[pos]; }
+		Edge const *operator->() const { return edges + pos; }
+		EdgeIterator &operator++() { pos = edges[pos].next; return *this; }
+		bool operator==(EdgeIterator const &other) const { return pos == other.pos; }
+		bool operator!=(EdgeIterator const &other) const { return pos != other.pos; }
+	};
+
+	struct EdgeRange
+	{
+		Edge const *edges;
+		int first;
+		EdgeIterator begin() const { return EdgeIterator(edges, first); }
+		EdgeIterator end() const { return EdgeIterator(edges, no_edge); }
+	};
+
+	static constexpr int no_edge = -1;
+	static constexpr int no_owner = -1;
+	static constexpr int no_index = FlatIndexMap<StateID>::no_index;
+
+private:
+	FlatIndexMap<StateID> index;
+	std::vector<StateID> states;
+	std::vector<int> first_edge;
+	std::vector<int> last_edge;
+	std::vector<int> insertion_times;
+	std::vector<int> owners;
+	std::vector<bool> closed_flags;
+	std::vector<Edge> edges;
+	// all states closed in this iteration, in the order they were
+	// closed.  States removed with remove_closed are not erased here.
+	std::vector<StateID> closed_states;
+	int num_closed;
+
+public:
+	LookaheadArena();
+
+	void clear();
+	void reserve(int num_states);
+
+	// number of states known to the arena
+	int size() const { return static_cast<int>(states.size()); }
+
+	// The local index of a state is in [0, size()) and stays valid
+	// until clear().  get_index returns no_index for unknown states.
+	int get_or_insert(StateID state_id);
+	int get_index(StateID state_id) const { return index.find(state_id); }
+	StateID get_state(int i) const { return states[i]; }
+
+	// predecessor edges are kept in the order they were added
+	void add_predecessor(StateID state_id, StateID predecessor_id, OperatorID op);
+	EdgeRange get_predecessors(StateID state_id) const;
+	EdgeRange get_predecessors_at(int i) const { return EdgeRange{edges.data(), first_edge[i]}; }
+
+	void close(StateID state_id);
+	void remove_closed(StateID state_id);
+	bool is_closed(StateID state_id) const;
+	void remove_closed_at(int i);
+	bool is_closed_at(int i) const { return closed_flags[i]; }
+	int get_num_closed() const { return num_closed; }
+	std::vector<StateID> const &get_closed_states() const { return closed_states; }
+
+	// states that were never inserted count as inserted at time 0
+	void set_insertion_time(StateID state_id, int time);
+	int get_insertion_time(StateID state_id) const;
+
+	void set_owner(StateID state_id, int owner);
+	int get_owner(StateID state_id) const;
+};
+
+}
+
+#endif
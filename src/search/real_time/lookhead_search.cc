@@ -10,6 +10,7 @@
 #include "../options/plugin.h"
 #include "../tasks/root_task.h"
 #include "../task_utils/task_properties.h"
+#include "../utils/system.h"
 #include "../open_lists/best_first_open_list.h"
 
 namespace real_time {
@@ -19,9 +20,45 @@ void LookaheadSearch::mark_expanded(SearchNode &node)
 	statistics->inc_expanded();
 	node.close();
 	if (store_exploration_data)
-		closed.emplace(node.get_state_id());
+		arena.close(node.get_state_id());
+	if (reuse_subtree)
+		expansion_order.push_back(node.get_state_id());
 	if (expansion_delay)
-		expansion_delay->update_expansion_delay(statistics->get_expanded() - open_list_insertion_time[node.get_state_id()]);
+		expansion_delay->update_expansion_delay(statistics->get_expanded() - arena.get_insertion_time(node.get_state_id()));
+}
+
+void LookaheadSearch::mark_replayed(SearchNode &node)
+{
+	++num_replayed;
+	--replays_left;
+	node.close();
+	if (store_exploration_data)
+		arena.close(node.get_state_id());
+	expansion_order.push_back(node.get_state_id());
+}
+
+// Replays the next state of the previous lookahead that is still open.
+// Returns false once there is none left or the replay limit is reached.
+bool LookaheadSearch::replay_next()
+{
+	assert(reuse_subtree);
+	while (replays_left > 0 && replay_position < previous_expansion_order.size()) {
+		auto const state_id = previous_expansion_order[replay_position++];
+		auto const state = state_registry.lookup_state(state_id);
+		auto node = search_space->get_node(state);
+		if (!node.is_open())
+			continue;
+		mark_replayed(node);
+		replay_expansion(node, state);
+		return true;
+	}
+	return false;
+}
+
+void LookaheadSearch::replay_expansion(SearchNode &, const GlobalState &)
+{
+	std::cerr << "this lookahead search does not support subtree reuse" << std::endl;
+	utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
 }
 
 auto LookaheadSearch::check_goal_and_set_plan(const GlobalState &state) -> bool
@@ -40,28 +77,42 @@ LookaheadSearch::LookaheadSearch(StateRegistry &state_registry, bool store_explo
 	  task(tasks::g_root_task),
 	  task_proxy(*task),
 	  state_registry(state_registry),
-	  successor_generator(successor_generator::g_successor_generators[task_proxy]),
+	  successor_generator(search_engine->get_successor_generator()),
 	  search_engine(search_engine),
+	  search_space(std::make_unique<SearchSpace>(state_registry)),
+	  reset_time(0),
 	  store_exploration_data(store_exploration_data),
 	  expansion_delay(expansion_delay),
-	  heuristic_error(heuristic_error) {}
+	  heuristic_error(heuristic_error),
+	  reuse_subtree(false),
+	  replay_position(0),
+	  replay_limit(0),
+	  replays_left(0),
+	  num_replayed(0)
+{
+	arena.reserve(256);
+}
 
 void LookaheadSearch::initialize(const GlobalState &initial_state)
 {
+	auto const reset_start = std::chrono::steady_clock::now();
 	solution_found = false;
 	plan.clear();
-	search_space = std::make_unique<SearchSpace>(state_registry);
+	search_space->reset();
 	statistics = std::make_unique<SearchStatistics>();
-	auto node = search_space->get_node(initial_state);
-	node.open_initial();
-	if (store_exploration_data) {
-		predecessors.clear();
+	if (store_exploration_data)
 		frontier.clear();
-		closed.clear();
-		closed.reserve(256);
+	arena.clear();
+	if (reuse_subtree) {
+		previous_expansion_order.swap(expansion_order);
+		expansion_order.clear();
+		replay_position = 0;
+		replays_left = replay_limit;
 	}
-	if (expansion_delay)
-		open_list_insertion_time.clear();
+	reset_time = std::chrono::steady_clock::now() - reset_start;
+
+	auto node = search_space->get_node(initial_state);
+	node.open_initial();
 }
 
 EagerLookaheadSearch::EagerLookaheadSearch(StateRegistry &state_registry, bool store_exploration_data, ExpansionDelay *expansion_delay, HeuristicError *heuristic_error, SearchEngine const *search_engine)
@@ -79,7 +130,7 @@ void EagerLookaheadSearch::initialize(const GlobalState &initial_state)
 	auto root_eval_context = EvaluationContext(initial_state, 0, false, statistics.get());
 	statistics->inc_evaluated_states();
 	if (expansion_delay)
-		open_list_insertion_time[cur_state_id] = 0;
+		arena.set_insertion_time(cur_state_id, 0);
 
 	auto applicables = std::vector<OperatorID>();
 	successor_generator.generate_applicable_ops(initial_state, applicables);
@@ -100,7 +151,7 @@ void EagerLookaheadSearch::initialize(const GlobalState &initial_state)
 		}
 
 		if (store_exploration_data)
-			predecessors[succ_state_id].emplace_back(cur_state_id, op);
+			arena.add_predecessor(succ_state_id, cur_state_id, op_id);
 
 		auto succ_eval_context = EvaluationContext(succ_state, succ_g, false, statistics.get());
 		if (succ_node.is_dead_end()) {
@@ -119,16 +170,17 @@ void EagerLookaheadSearch::initialize(const GlobalState &initial_state)
 	statistics->inc_generated();
 	if (heuristic_error)
 		heuristic_error->update_error();
-
 }
 
 auto EagerLookaheadSearch::step() -> SearchStatus
 {
 	assert(statistics);
+	if (reuse_subtree && replay_next())
+		return IN_PROGRESS;
+ get_node:
 	if (open_list->empty())
 		return FAILED;
 
- get_node:
 	const auto id = open_list->remove_min();
 	const auto state = state_registry.lookup_state(id);
 	auto node = search_space->get_node(state);
@@ -141,11 +193,24 @@ auto EagerLookaheadSearch::step() -> SearchStatus
 	if (check_goal_and_set_plan(state))
 		return SOLVED;
 
+	generate_successors(node, state, false);
+	return IN_PROGRESS;
+}
+
+void EagerLookaheadSearch::replay_expansion(SearchNode &node, const GlobalState &state)
+{
+	generate_successors(node, state, true);
+}
+
+// the heuristic error is only learned from new expansions
+void EagerLookaheadSearch::generate_successors(SearchNode &node, const GlobalState &state, bool replay)
+{
+	auto const id = state.get_id();
 	auto applicable_ops = std::vector<OperatorID>();
 	successor_generator.generate_applicable_ops(state, applicable_ops);
 
 	auto eval_context = EvaluationContext(state, node.get_g(), false, statistics.get());
-	if (heuristic_error)
+	if (heuristic_error && !replay)
 		heuristic_error->set_expanding_state(state);
 
 	for (auto op_id : applicable_ops) {
@@ -155,7 +220,7 @@ auto EagerLookaheadSearch::step() -> SearchStatus
 		auto succ_node = search_space->get_node(succ_state);
 
 		if (store_exploration_data)
-			predecessors[succ_state.get_id()].emplace_back(id, op);
+			arena.add_predecessor(succ_state.get_id(), id, op_id);
 
 		// Previously encountered dead end. Don't re-evaluate.
 		if (succ_node.is_dead_end())
@@ -181,19 +246,24 @@ auto EagerLookaheadSearch::step() -> SearchStatus
 			auto succ_eval_context = EvaluationContext(succ_state, succ_node.get_g(), false, statistics.get());
 			open_list->insert(succ_eval_context, succ_state.get_id());
 		}
-		open_list_insertion_time[id] = statistics->get_expanded();
-		if (heuristic_error)
+		if (expansion_delay)
+			arena.set_insertion_time(id, statistics->get_expanded());
+		if (heuristic_error && !replay)
 			heuristic_error->add_successor(succ_node, adj_cost);
 	}
-	if (heuristic_error)
+	if (heuristic_error && !replay)
 		heuristic_error->update_error();
-	return IN_PROGRESS;
 }
 
 void EagerLookaheadSearch::post()
 {
-	while (!open_list->empty())
-		frontier.push_back(open_list->remove_min());
+	while (!open_list->empty()) {
+		auto const state_id = open_list->remove_min();
+		// replayed states stay in the open list after they are closed
+		if (reuse_subtree && search_space->get_node(state_registry.lookup_state(state_id)).is_closed())
+			continue;
+		frontier.push_back(state_id);
+	}
 }
 
 auto AStarLookaheadSearch::create_open_list() const -> std::unique_ptr<StateOpenList> {
@@ -10,7 +10,8 @@
 #include "../state_registry.h"
 #include "../task_utils/successor_generator.h"
 #include "DiscreteDistribution.h"
-#include "lap_timer.h"
+#include "compact_belief.h"
+#include "lookahead_arena.h"
 
 #include <chrono>
 #include <memory>
@@ -32,22 +33,50 @@ protected:
 	StateRegistry &state_registry;
 	const successor_generator::SuccessorGenerator &successor_generator;
 	std::unique_ptr<SearchStatistics> statistics;
-	LapTimer lt;
 
 	SearchEngine const *search_engine; // to call get_adjusted_cost
+	// the search space lives across lookahead iterations and is
+	// reset in O(1) at the start of each one.
 	std::unique_ptr<SearchSpace> search_space;
+	// time spent resetting the per-iteration data in the last call
+	// to initialize
+	std::chrono::nanoseconds reset_time;
 	std::vector<StateID> frontier;
 
 	const bool store_exploration_data;
-	std::unordered_map<StateID, std::vector<std::pair<StateID, OperatorProxy>>> predecessors;
-	std::unordered_set<StateID> closed;
+	// predecessors, closed states and open list insertion times of
+	// the current lookahead iteration
+	LookaheadArena arena;
 
 	ExpansionDelay *expansion_delay;
-	std::unordered_map<StateID, int> open_list_insertion_time;
 
 	HeuristicError *heuristic_error;
 
+	// Subtree reuse.  The states expanded in a lookahead are kept in
+	// the order they were expanded, and the first steps of the next
+	// lookahead expand them again, in that order, as far as they are
+	// open by the time they come up.  These are the states under the
+	// new root and the ones reachable from those, so the part of the
+	// last lookahead below the chosen action is rebuilt with g values
+	// from the new root.  Replayed expansions generate their
+	// successors as usual, but they are not counted as expansions, so
+	// the lookahead bound is spent on new states only.  Instead, at
+	// most replay_limit states are replayed per lookahead, so a
+	// lookahead records at most its bound plus replay_limit states and
+	// the replay cannot grow from step to step.
+	bool reuse_subtree;
+	std::vector<StateID> expansion_order;
+	std::vector<StateID> previous_expansion_order;
+	std::size_t replay_position;
+	int replay_limit;
+	int replays_left;
+	long long num_replayed;
+
 	virtual void mark_expanded(SearchNode &node);
+	void mark_replayed(SearchNode &node);
+	bool replay_next();
+	// generates the successors of a replayed state
+	virtual void replay_expansion(SearchNode &node, const GlobalState &state);
 
 	bool check_goal_and_set_plan(const GlobalState &state);
 public:
@@ -71,6 +100,10 @@ public:
 
 	virtual void print_statistics() const {}
 
+	void set_reuse_subtree(bool reuse, int limit) { reuse_subtree = reuse; replay_limit = limit; }
+	auto reuses_subtree() const -> bool { return reuse_subtree; }
+	auto get_num_replayed() const -> long long { return num_replayed; }
+
 	auto found_solution() const -> bool {return solution_found;}
 	auto get_plan() const -> const Plan & {return plan;}
 	// Note: Were taking a const reference to an object inside a
@@ -80,24 +113,24 @@ public:
 	virtual auto get_expanded_states() -> std::unique_ptr<std::unordered_set<StateID> > { return nullptr; };
 	auto get_search_space() const -> SearchSpace & { return *search_space.get(); }
 	auto get_frontier() const -> const decltype(frontier) & { return frontier; }
-	auto get_predecessors() const -> const decltype(predecessors) & { return predecessors; }
-	auto next_lap() -> void { lt.reset(); }
-	auto stop_lap() -> std::chrono::milliseconds { lt.pause(); return get_duration(); }
-	auto get_duration() const -> std::chrono::milliseconds { return lt.get(); }
-	// this is consumed during learning.  that's fine, no one else
-	// needs this.
-	auto get_closed() -> decltype(closed) & { return closed; }
+	auto get_reset_time() const -> std::chrono::nanoseconds { return reset_time; }
+	// the closed states are consumed during learning.  that's fine,
+	// no one else needs them.
+	auto get_arena() -> LookaheadArena & { return arena; }
 
 	// only implemented for lookahead search methods making use of distributions (risk)
 	virtual auto get_tlas() -> TLAs const * { return nullptr; }
-	virtual auto get_beliefs() -> PerStateInformation<ShiftedDistribution> * { return nullptr; }
-	virtual auto get_post_beliefs() -> PerStateInformation<ShiftedDistribution> * { return nullptr; }
+	virtual auto get_beliefs() -> PerStateInformation<CompactBelief> * { return nullptr; }
+	virtual auto get_post_beliefs() -> PerStateInformation<CompactBelief> * { return nullptr; }
+	virtual auto get_distribution_table() -> DistributionTable const * { return nullptr; }
 };
 
 class EagerLookaheadSearch : public LookaheadSearch {
 	std::unique_ptr<StateOpenList> open_list;
+	void generate_successors(SearchNode &node, const GlobalState &state, bool replay);
 protected:
 	virtual auto create_open_list() const -> std::unique_ptr<StateOpenList> = 0;
+	void replay_expansion(SearchNode &node, const GlobalState &state) override;
 public:
 	EagerLookaheadSearch(StateRegistry &state_registry,
 	                     bool store_exploration_data,
@@ -0,0 +1,63 @@
+#include "mapped_file.h"
+
+#include "../utils/system.h"
+
+#include <fstream>
+#include <iostream>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace real_time
+{
+
+MappedFile::MappedFile(std::string const &file_name)
+	: file_data(nullptr), file_size(0), mapped(false)
+{
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+	int fd = open(file_name.c_str(), O_RDONLY);
+	if (fd >= 0) {
+		struct stat st;
+		if (fstat(fd, &st) == 0 && st.st_size > 0) {
+			void *p = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+			if (p != MAP_FAILED) {
+				file_data = static_cast<char const *>(p);
+				file_size = static_cast<std::size_t>(st.st_size);
+				mapped = true;
+			}
+		}
+		close(fd);
+	}
+	if (mapped)
+		return;
+#endif
+
+	std::ifstream f(file_name, std::ios::binary | std::ios::ate);
+	if (!f) {
+		std::cerr << "error: could not open " << file_name << std::endl;
+		utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+	}
+	file_size = static_cast<std::size_t>(f.tellg());
+	buffer.resize((file_size + sizeof(long long) - 1) / sizeof(long long));
+	f.seekg(0);
+	f.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(file_size));
+	if (!f) {
+		std::cerr << "error: could not read " << file_name << std::endl;
+		utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+	}
+	file_data = reinterpret_cast<char const *>(buffer.data());
+}
+
+MappedFile::~MappedFile()
+{
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+	if (mapped)
+		munmap(const_cast<char *>(file_data), file_size);
+#endif
+}
+
+}
@@ -0,0 +1,37 @@
+#ifndef REAL_TIME_MAPPED_FILE_H
+#define REAL_TIME_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace real_time
+{
+
+// Read-only view of a whole file.  On Linux and macOS the file is
+// mmap'ed, so only the pages that are actually touched are read from
+// disk.  Elsewhere (or if mapping fails) the file is read into memory
+// instead.  Either way, data() is aligned to at least 8 bytes.
+class MappedFile
+{
+	char const *file_data;
+	std::size_t file_size;
+	bool mapped;
+	// only used when the file could not be mapped
+	std::vector<long long> buffer;
+public:
+	// exits with SEARCH_INPUT_ERROR if the file cannot be read
+	explicit MappedFile(std::string const &file_name);
+	~MappedFile();
+
+	MappedFile(MappedFile const &) = delete;
+	MappedFile &operator=(MappedFile const &) = delete;
+
+	char const *data() const { return file_data; }
+	std::size_t size() const { return file_size; }
+	bool is_mapped() const { return mapped; }
+};
+
+}
+
+#endif
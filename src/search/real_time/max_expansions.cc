@@ -3,15 +3,15 @@
 namespace real_time
 {
 
-MaxExpansions::MaxExpansions(int b): stats(nullptr), bound(b) {}
+MaxExpansions::MaxExpansions(int b): stats(nullptr), bound(b), offset(0) {}
 
 bool MaxExpansions::lookahead_ok()
 {
 	assert(stats != nullptr);
-	return stats->get_expanded() < bound;
+	return stats->get_expanded() - offset < bound;
 }
 
-bool MaxExpansions::learning_ok() const
+bool MaxExpansions::learning_ok()
 {
 	// when only limiting the number of expansions, the learning
 	// phase is unbounded.
@@ -21,12 +21,8 @@ bool MaxExpansions::learning_ok() const
 void MaxExpansions::initialize(LookaheadSearch const &ls)
 {
 	stats = &ls.get_statistics();
-	assert(stats->get_expanded() == 1);
-}
-
-void MaxExpansions::print_surplus() const
-{
-	assert(stats != nullptr);
+	assert(stats->get_expanded() >= 1);
+	offset = stats->get_expanded() - 1;
 }
 
 }
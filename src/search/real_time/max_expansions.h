@@ -11,14 +11,16 @@ struct MaxExpansions : Bound
 {
 	SearchStatistics const *stats;
 	int bound;
+	// expansions the lookahead had already done when it was handed
+	// over, by a speculative lookahead
+	int offset;
 
 	MaxExpansions(int b);
 	virtual ~MaxExpansions() = default;
 
 	bool lookahead_ok() final;
-	bool learning_ok() const final;
+	bool learning_ok() final;
 	void initialize(LookaheadSearch const &ls) final;
-	void print_surplus() const final;
 };
 
 
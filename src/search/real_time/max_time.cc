@@ -1,41 +1,152 @@
 #include "max_time.h"
 
-#include <cmath>
+#include <algorithm>
+#include <iostream>
 
 namespace real_time
 {
 
+// the measured costs are scaled by this when reserving time for them
+static constexpr double safety_factor = 1.5;
+// share of the budget reserved for the decision and the learning
+// before their costs were measured
+static constexpr double initial_reserve = 0.05;
+
+static void update_average(double &average, double sample)
+{
+	average = average < 0 ? sample : average + (sample - average) / 8;
+}
+
+static double nanoseconds(MaxTime::Clock::duration d)
+{
+	return std::chrono::duration<double, std::nano>(d).count();
+}
+
 MaxTime::MaxTime(int ms)
-	: start(std::chrono::system_clock::now()),
-	  max_ms(ms),
-	  final_bound(start + max_ms),
-	  lookahead_part(95),
-	  lookahead_ms(ms * lookahead_part / 100),
-	  lookahead_bound(start + lookahead_ms),
-	  ls(nullptr),
-	  lookahead_ub(1) //assume lookahead always takes at least one ms
+	: step_budget(std::chrono::milliseconds(ms)),
+	  started(false),
+	  decision_cost(-1),
+	  learning_cost(-1),
+	  last_learning_time(0),
+	  learning_expansions(0),
+	  overrun_histogram{},
+	  num_steps(0),
+	  num_overruns(0),
+	  max_overrun(0)
 {}
 
+void MaxTime::start_step()
+{
+	// the schedule starts with the first step, not at construction,
+	// which may have been long before
+	step_start = Clock::now();
+	step_deadline = started ? step_deadline + step_budget : step_start + step_budget;
+	started = true;
+	learning_checker.start(step_deadline - step_budget / 2, step_start);
+}
+
+void MaxTime::initialize(LookaheadSearch const &)
+{
+	auto const now = Clock::now();
+	// learning that did not finish in the last step was caught up on
+	// since start_step, so that time belongs to the last learning
+	// phase
+	if (learning_expansions > 0)
+		update_average(learning_cost, (last_learning_time + nanoseconds(now - step_start)) / learning_expansions);
+	learning_expansions = 0;
+	lookahead_checker.start(step_deadline, now);
+}
+
 bool MaxTime::lookahead_ok()
 {
-	lookahead_ub = std::max(lookahead_ub, ls->get_duration());
-	return (std::chrono::system_clock::now() + lookahead_ub) < lookahead_bound;
+	bool ok;
+	if (decision_cost < 0 || learning_cost < 0)
+		ok = lookahead_checker.ok(initial_reserve * nanoseconds(step_budget), 0);
+	else
+		ok = lookahead_checker.ok(safety_factor * decision_cost, safety_factor * learning_cost);
+	// without a single expansion there is no action to take, so the
+	// first one is done even if the step is already late
+	return ok || lookahead_checker.get_units() == 1;
 }
 
-bool MaxTime::learning_ok() const
+bool MaxTime::learning_ok()
 {
-	return std::chrono::system_clock::now() < final_bound;
+	return learning_checker.ok(0, 0);
 }
 
-void MaxTime::initialize(LookaheadSearch const &ls)
+bool MaxTime::catch_up_ok()
 {
-	this->ls = &ls;
-	start = final_bound;
-	final_bound = start + max_ms;
-	lookahead_bound = start + lookahead_ms;
+	return learning_checker.ok(0, 0);
 }
 
-void MaxTime::print_surplus() const
+void MaxTime::action_committed()
 {
+	step_deadline += step_budget;
 }
+
+void MaxTime::pause(Clock::duration duration)
+{
+	step_deadline += duration;
+}
+
+bool MaxTime::behind_schedule() const
+{
+	return Clock::now() > step_deadline;
+}
+
+void MaxTime::lookahead_finished()
+{
+	lookahead_end = Clock::now();
+}
+
+void MaxTime::learning_started()
+{
+	learning_start = Clock::now();
+	update_average(decision_cost, nanoseconds(learning_start - lookahead_end));
+	learning_checker.start(step_deadline, learning_start);
+}
+
+void MaxTime::learning_finished()
+{
+	auto const now = Clock::now();
+	last_learning_time = nanoseconds(now - learning_start);
+	learning_expansions = lookahead_checker.get_units();
+
+	++num_steps;
+	if (now <= step_deadline)
+		return;
+	auto const overrun = now - step_deadline;
+	++num_overruns;
+	max_overrun = std::max(max_overrun, overrun);
+	auto const us = std::chrono::duration_cast<std::chrono::microseconds>(overrun).count();
+	int bucket = 0;
+	for (long long limit = 1; bucket < num_overrun_buckets - 1 && us >= limit; limit *= 10)
+		++bucket;
+	++overrun_histogram[bucket];
+}
+
+void MaxTime::print_statistics() const
+{
+	auto const checks = lookahead_checker.get_total_units();
+	std::cout << "Clock reads per lookahead check: "
+		  << (checks > 0 ? static_cast<double>(lookahead_checker.get_total_reads()) / checks : 0) << "\n"
+		  << "Estimated decision time: " << static_cast<long long>(decision_cost) << "ns\n"
+		  << "Estimated learning time per expansion: " << static_cast<long long>(learning_cost) << "ns\n"
+		  << "Steps that overran their deadline: " << num_overruns << " of " << num_steps << "\n"
+		  << "Maximum deadline overrun: "
+		  << std::chrono::duration_cast<std::chrono::microseconds>(max_overrun).count() << "us\n";
+	if (num_overruns == 0)
+		return;
+	std::cout << "Deadline overrun histogram:";
+	long long limit = 1;
+	for (int i = 0; i < num_overrun_buckets; ++i, limit *= 10) {
+		if (i < num_overrun_buckets - 1)
+			std::cout << " <" << limit << "us: ";
+		else
+			std::cout << " more: ";
+		std::cout << overrun_histogram[i];
+	}
+	std::cout << "\n";
+}
+
 }
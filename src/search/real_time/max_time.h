@@ -2,30 +2,72 @@
 #define REAL_TIME_MAX_TIME_H
 
 #include "bound.h"
+#include "deadline_checker.h"
 
+#include <array>
 #include <chrono>
 
 namespace real_time
 {
 
+// Gives every step the same time budget.  Steps follow each other at
+// a fixed rate: the deadline of a step is the deadline of the previous
+// one plus the budget, so a step that overruns its deadline takes the
+// time from the next one.  The lookahead stops early enough to leave
+// time for the decision and the learning, going by their costs
+// measured in the previous steps.  With asynchronous learning, the
+// cost of learning is that of taking the snapshot and of waiting for
+// the learning thread.  Every action committed on top of the first
+// one in a step gives the next step another budget.
 struct MaxTime : Bound
 {
-	std::chrono::time_point<std::chrono::system_clock> start;
-	const std::chrono::milliseconds max_ms;
-	std::chrono::time_point<std::chrono::system_clock> final_bound;
-	int lookahead_part;
-	std::chrono::milliseconds lookahead_ms;
-	std::chrono::time_point<std::chrono::system_clock> lookahead_bound;
-	LookaheadSearch const *ls;
-	std::chrono::milliseconds lookahead_ub; // upper bound estimate on the time of one lookahead iteration
-
-	MaxTime(int max_ms);
+	using Clock = DeadlineChecker::Clock;
+
+	const Clock::duration step_budget;
+	bool started;
+	Clock::time_point step_start;
+	Clock::time_point step_deadline;
+	Clock::time_point lookahead_end;
+	Clock::time_point learning_start;
+	DeadlineChecker lookahead_checker;
+	// also checks the catch up on the learning at the start of a
+	// step, which may take up to half of the step's budget
+	DeadlineChecker learning_checker;
+	// moving averages in nanoseconds of the time the decision takes
+	// and of the learning time per lookahead expansion.  Negative
+	// until measured.
+	double decision_cost;
+	double learning_cost;
+	// the last learning phase, until its catch-up is known
+	double last_learning_time;
+	long long learning_expansions;
+
+	// statistics on how far steps overran their deadline.  Bucket i
+	// counts overruns of less than 10^i microseconds, the last one
+	// all the others.
+	static constexpr int num_overrun_buckets = 8;
+	std::array<long long, num_overrun_buckets> overrun_histogram;
+	long long num_steps;
+	long long num_overruns;
+	Clock::duration max_overrun;
+
+	explicit MaxTime(int max_ms);
 	virtual ~MaxTime() = default;
 
 	bool lookahead_ok() final;
-	bool learning_ok() const final;
+	bool learning_ok() final;
 	void initialize(LookaheadSearch const &ls) final;
-	void print_surplus() const final;
+
+	void start_step() final;
+	void lookahead_finished() final;
+	void learning_started() final;
+	void learning_finished() final;
+	bool catch_up_ok() final;
+	void action_committed() final;
+	bool behind_schedule() const final;
+	void pause(Clock::duration duration) final;
+
+	void print_statistics() const final;
 };
 
 
@@ -1,76 +1,165 @@
 #include "nancy_backup.h"
 
+#include <limits>
+
 namespace real_time
 {
 
 NancyBackup::NancyBackup(StateRegistry const &state_registry,
 			 SearchEngine const *search_engine,
 			 Beliefs *beliefs,
-			 Beliefs *post_beliefs)
-	: Learning(state_registry, search_engine), beliefs(beliefs), post_beliefs(post_beliefs)
+			 Beliefs *post_beliefs,
+			 DistributionTable const *distribution_table)
+	: Learning(state_registry, search_engine), beliefs(beliefs), post_beliefs(post_beliefs),
+	  distribution_table(distribution_table), use_snapshot(false)
 {
 }
 
 
 void NancyBackup::initialize(
-	const std::unordered_map<StateID, std::vector<std::pair<StateID, OperatorProxy>>> &predecessors_,
-	const std::vector<StateID> &frontier,
-	std::unordered_set<StateID> &closed_)
+	LookaheadArena &arena_,
+	const std::vector<StateID> &frontier)
 {
-	predecessors = &predecessors_;
-	closed = &closed_;
-	initial_effort = closed->size();
+	arena = &arena_;
+	use_snapshot = false;
+	initial_effort = arena->get_num_closed();
 
-	assert(learning_queue.empty());
-	for (const auto &state_id : (*closed)) {
+	previous_beliefs.clear();
+	previous_post_beliefs.clear();
+	for (const auto &state_id : arena->get_closed_states()) {
 		auto const &state = state_registry.lookup_state(state_id);
-		(*beliefs)[state].expected_value = std::numeric_limits<double>::infinity();
+		previous_beliefs.push_back((*beliefs)[state]);
+		previous_post_beliefs.push_back((*post_beliefs)[state]);
+		(*beliefs)[state].set_infinite();
 	}
 
+	push_frontier(frontier);
+}
+
+void NancyBackup::push_frontier(std::vector<StateID> const &frontier)
+{
+	assert(learning_queue.empty());
+	for (const auto &state_id : frontier)
+		arena->get_or_insert(state_id);
+	learning_queue.resize(arena->size());
+
 	for (const auto &state_id : frontier) {
-		auto const &state = state_registry.lookup_state(state_id);
-		learning_queue.emplace((*beliefs)[state], state_id);
-		closed->erase(state_id);
+		auto const i = arena->get_index(state_id);
+		arena->remove_closed_at(i);
+		auto const exp = get_expected_cost(i);
+		if (exp != std::numeric_limits<double>::infinity())
+			learning_queue.push_or_decrease(i, exp);
 	}
 }
 
 
 
-void NancyBackup::step()
+void NancyBackup::copy_to_snapshot(int i)
 {
-	assert(!done());
+	auto const &state = state_registry.lookup_state(arena->get_state(i));
+	snapshot_beliefs[i] = (*beliefs)[state];
+	snapshot_post_beliefs[i] = (*post_beliefs)[state];
+	// the root of the lookahead has no belief of its own
+	if (snapshot_beliefs[i].is_known())
+		snapshot_expected_costs[i] = distribution_table->expected_cost(snapshot_beliefs[i]);
+}
 
- get_entry:
-	if (done())
-		return;
-	auto &top = learning_queue.top();
-	ShiftedDistribution dstr = top.first;
-	StateID state_id = top.second;
-	learning_queue.pop();
-	auto const &state = state_registry.lookup_state(state_id);
-	assert((*beliefs)[state].distribution != nullptr);
+CompactBelief &NancyBackup::get_belief(int i)
+{
+	if (use_snapshot)
+		return snapshot_beliefs[i];
+	return (*beliefs)[state_registry.lookup_state(arena->get_state(i))];
+}
 
-	if (dstr.expected_value == std::numeric_limits<double>::infinity())
-		goto get_entry;
+CompactBelief &NancyBackup::get_post_belief(int i)
+{
+	if (use_snapshot)
+		return snapshot_post_beliefs[i];
+	return (*post_beliefs)[state_registry.lookup_state(arena->get_state(i))];
+}
 
-	auto cls = closed->find(state_id);
+double NancyBackup::get_expected_cost(int i)
+{
+	if (use_snapshot)
+		return snapshot_expected_costs[i];
+	return distribution_table->expected_cost(get_belief(i));
+}
 
-	if (cls != closed->end())
-		closed->erase(cls);
+void NancyBackup::set_infinite(int i)
+{
+	get_belief(i).set_infinite();
+	if (use_snapshot)
+		snapshot_expected_costs[i] = std::numeric_limits<double>::infinity();
+}
 
-	auto preds = predecessors->find(state_id);
-	if (preds == predecessors->end())
-		return; // return to make the step not so long
+void NancyBackup::snapshot(LookaheadArena const &arena_,
+	const std::vector<StateID> &frontier)
+{
+	// the arena of the lookahead is reused by the next lookahead
+	snapshot_arena = arena_;
+	arena = &snapshot_arena;
+	use_snapshot = true;
+	initial_effort = arena->get_num_closed();
+
+	for (const auto &state_id : frontier)
+		arena->get_or_insert(state_id);
+	snapshot_beliefs.assign(arena->size(), CompactBelief());
+	snapshot_post_beliefs.assign(arena->size(), CompactBelief());
+	snapshot_expected_costs.assign(arena->size(), std::numeric_limits<double>::infinity());
+	// closed states that are on the frontier as well start out at
+	// infinity, so they are copied last
+	for (const auto &state_id : frontier)
+		copy_to_snapshot(arena->get_index(state_id));
+	for (const auto &state_id : arena->get_closed_states()) {
+		auto const i = arena->get_index(state_id);
+		copy_to_snapshot(i);
+		set_infinite(i);
+	}
 
-	for (auto const &[p_id, op] : preds->second) {
-		auto cls = closed->find(p_id);
-		if (cls == closed->end())
+	push_frontier(frontier);
+}
+
+void NancyBackup::run()
+{
+	while (!done())
+		step();
+}
+
+void NancyBackup::publish()
+{
+	assert(use_snapshot && done());
+	for (const auto &state_id : arena->get_closed_states()) {
+		auto const i = arena->get_index(state_id);
+		auto const &state = state_registry.lookup_state(state_id);
+		(*beliefs)[state] = snapshot_beliefs[i];
+		(*post_beliefs)[state] = snapshot_post_beliefs[i];
+	}
+}
+
+void NancyBackup::step()
+{
+	assert(!done());
+
+	// the queue holds every state once, with its current expected
+	// cost, so there are no outdated entries to skip
+	auto const i = learning_queue.pop();
+	auto const dstr = get_belief(i);
+	auto const exp = get_expected_cost(i);
+	assert(dstr.is_known());
+	assert(exp != std::numeric_limits<double>::infinity());
+
+	arena->remove_closed_at(i);
+
+	for (auto const &edge : arena->get_predecessors_at(i)) {
+		auto const p = arena->get_index(edge.state);
+		if (p == LookaheadArena::no_index || !arena->is_closed_at(p))
 			continue;
 
-		auto const &predecessor = state_registry.lookup_state(p_id);
-		auto const new_exp = dstr.expected_cost() + search_engine->get_adjusted_cost(op);
-		ShiftedDistribution &p_belief = (*beliefs)[predecessor];
-		auto const p_exp = p_belief.expected_cost();
+		auto const op = search_engine->get_operators()[edge.op];
+
+		auto const cost = search_engine->get_adjusted_cost(op);
+		auto const new_exp = exp + cost;
+		auto const p_exp = get_expected_cost(p);
 		if (p_exp > new_exp) {
 			// to be clear here:
 			// - the belief is only backed up if its expected value increased
@@ -83,17 +172,18 @@ void NancyBackup::step()
 			//   the same as the expected value of the raw distribution + shift
 
 			// backup the main belief
-			p_belief.set_and_shift(dstr, search_engine->get_adjusted_cost(op));
-			assert(std::abs(new_exp - p_belief.expected_cost()) < 0.001);
+			get_belief(p) = dstr.shifted(cost);
+			if (use_snapshot)
+				snapshot_expected_costs[p] = new_exp;
+			assert(std::abs(new_exp - get_expected_cost(p)) < 0.001);
 
 			// backup the post expansion belief
-			ShiftedDistribution &p_post_belief = (*post_beliefs)[predecessor];
-			ShiftedDistribution &s_post_belief = (*post_beliefs)[state];
+			auto const s_post_belief = get_post_belief(i);
 			assert(dstr.shift == s_post_belief.shift);
-			assert(s_post_belief.distribution);
-			p_post_belief.set_and_shift(s_post_belief, search_engine->get_adjusted_cost(op));
+			assert(s_post_belief.is_known());
+			get_post_belief(p) = s_post_belief.shifted(cost);
 
-			learning_queue.emplace(p_belief, p_id);
+			learning_queue.push_or_decrease(p, new_exp);
 		}
 	}
 }
@@ -111,8 +201,24 @@ size_t NancyBackup::effort()
 
 size_t NancyBackup::remaining()
 {
-	assert(closed != nullptr);
-	return closed->size();
+	assert(arena != nullptr);
+	return arena->get_num_closed();
+}
+
+void NancyBackup::abandon()
+{
+	assert(!use_snapshot);
+	// the states still closed were not popped, so their beliefs are
+	// either infinite or not final yet
+	auto const &closed_states = arena->get_closed_states();
+	for (size_t i = 0; i < closed_states.size(); ++i) {
+		if (!arena->is_closed(closed_states[i]))
+			continue;
+		auto const &state = state_registry.lookup_state(closed_states[i]);
+		(*beliefs)[state] = previous_beliefs[i];
+		(*post_beliefs)[state] = previous_post_beliefs[i];
+	}
+	learning_queue.clear();
 }
 
 }
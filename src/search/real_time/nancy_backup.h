@@ -1,9 +1,8 @@
 #ifndef REAL_TIME_NANCY_BACKUP_H
 #define REAL_TIME_NANCY_BACKUP_H
 
-#include <queue>
-
-#include "DiscreteDistribution.h"
+#include "compact_belief.h"
+#include "indexed_heap.h"
 #include "learning.h"
 
 namespace real_time
@@ -11,36 +10,59 @@ namespace real_time
 
 struct NancyBackup : public Learning
 {
-	using QueueEntry = std::pair<ShiftedDistribution, StateID>;
-
-	struct QueueComp
-	{
-		bool operator()(const QueueEntry &a, const QueueEntry &b) const
-		{
-			return a.first.expected_cost() >  b.first.expected_cost();
-		}
-	};
-
 	// passed in at construction time
-	using Beliefs = PerStateInformation<ShiftedDistribution>;
+	using Beliefs = PerStateInformation<CompactBelief>;
 	Beliefs *beliefs;
 	Beliefs *post_beliefs;
+	DistributionTable const *distribution_table;
+
+	// keyed by the local index of the state in the arena, so every
+	// state is in the queue at most once.  The beliefs themselves
+	// stay in the belief tables (or the snapshot).
+	IndexedHeap<double> learning_queue;
 
-	// created by us during initialize
-	std::priority_queue<QueueEntry, std::vector<QueueEntry>, QueueComp> learning_queue;
+	// the beliefs of the closed states before initialize(), in the
+	// order of the arena's closed states, for abandon()
+	std::vector<CompactBelief> previous_beliefs;
+	std::vector<CompactBelief> previous_post_beliefs;
+
+	// copies taken by snapshot().  use_snapshot tells whether step()
+	// works on them or on the arena and the belief tables.  The
+	// beliefs are indexed by the local index in snapshot_arena; only
+	// those of the closed states and the frontier are copied.  Their
+	// expected costs are copied as well, since the distribution table
+	// may grow while the learning thread runs.
+	bool use_snapshot;
+	LookaheadArena snapshot_arena;
+	std::vector<CompactBelief> snapshot_beliefs;
+	std::vector<CompactBelief> snapshot_post_beliefs;
+	std::vector<double> snapshot_expected_costs;
+
+	void copy_to_snapshot(int i);
+	CompactBelief &get_belief(int i);
+	CompactBelief &get_post_belief(int i);
+	double get_expected_cost(int i);
+	void set_infinite(int i);
+	void push_frontier(std::vector<StateID> const &frontier);
 
 	NancyBackup(StateRegistry const &state_registry,
                 SearchEngine const *search_engine,
                 Beliefs *beliefs,
-                Beliefs *post_beliefs);
+                Beliefs *post_beliefs,
+                DistributionTable const *distribution_table);
 
-	void initialize(const std::unordered_map<StateID, std::vector<std::pair<StateID, OperatorProxy>>> &predecessors,
-			const std::vector<StateID> &frontier,
-			std::unordered_set<StateID> &closed) final;
+	void initialize(LookaheadArena &arena,
+			const std::vector<StateID> &frontier) final;
 	void step() final;
 	bool done() final;
 	size_t effort() final;
 	size_t remaining() final;
+	void abandon() final;
+
+	void snapshot(LookaheadArena const &arena,
+		      const std::vector<StateID> &frontier) final;
+	void run() final;
+	void publish() final;
 };
 
 }
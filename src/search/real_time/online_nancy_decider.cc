@@ -32,7 +32,6 @@ OperatorID OnlineNancyDecider::decide(const std::vector<StateID> &frontier, Sear
 	const auto best_state_id = std::min_element(std::begin(frontier), std::end(frontier), [this, &search_space](const auto &lhs, const auto &rhs) {
 												      return evaluator(lhs, search_space) < evaluator(rhs, search_space);
 											      });
-	auto plan = Plan();
 	GlobalState const best_state = state_registry.lookup_state(*best_state_id);
 	int frontier_f_hat = evaluator(*best_state_id, search_space);
 	int frontier_h_hat = frontier_f_hat - search_space.get_node(best_state).get_g();
@@ -64,17 +63,17 @@ OperatorID OnlineNancyDecider::decide(const std::vector<StateID> &frontier, Sear
 		return next_action;
 	} else {
 		assert(!target_path.empty());
-		OperatorID next_action = target_path.back();
-		// assert(std::find(tlas->ops.begin(), tlas->ops.end(), next_action) != tlas->ops.end());
-		target_path.pop_back();
 		if (min_h < target_h_hat)
 			target_h_hat = min_h;
-		target_f_hat -= engine.get_adjusted_cost(engine.get_operators()[next_action]);
-		return next_action;
+		return follow_target_path();
 	}
+}
 
-	assert(!plan.empty());
-	return plan.front();
+OperatorID OnlineNancyDecider::follow_target_path()
+{
+	auto const next_action = Decision::follow_target_path();
+	target_f_hat -= engine.get_adjusted_cost(engine.get_operators()[next_action]);
+	return next_action;
 }
 
 }
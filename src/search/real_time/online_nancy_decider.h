@@ -14,7 +14,6 @@ class OnlineNancyDecider : public Decision
 	const SearchEngine &engine;
 	GlobalState const *cs;
 	std::function<int(StateID, SearchSpace &)> evaluator;
-	std::vector<OperatorID> target_path;
 	int target_f_hat;
 	int target_h_hat;
 	StateID target_state_id;
@@ -24,6 +23,7 @@ public:
 	~OnlineNancyDecider() override = default;
 
 	OperatorID decide(std::vector<StateID> const &frontier, SearchSpace &ss) override;
+	OperatorID follow_target_path() override;
 };
 }
 
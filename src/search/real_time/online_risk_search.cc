@@ -24,14 +24,17 @@ std::unique_ptr<StateOpenList> OnlineRiskLookaheadSearch::create_open_list() con
 
 bool OnlineRiskLookaheadSearch::state_owned_by_tla(StateID state_id, int tla_id) const
 {
-	const auto owner = state_owner.find(state_id);
-	if (owner == state_owner.end()) {
+	// the owner of a state is the index of the tla with the shortest
+	// known path to it.  this is a hack to prevent a state being
+	// expanded under a different tla.
+	auto const owner = arena.get_owner(state_id);
+	if (owner == LookaheadArena::no_owner) {
 		// this should never happen
 		std::cerr << "Encountered state with no known owner\n";
 		assert(false);
 		return false;
 	}
-	if (owner->second != tla_id) {
+	if (owner != tla_id) {
 		// this might happen
 		return false;
 	}
@@ -102,7 +105,6 @@ void OnlineTLAs::reserve(size_t n)
 void OnlineRiskLookaheadSearch::generate_tlas(GlobalState const &current_state)
 {
 	tlas.clear();
-	state_owner.clear();
 	if (heuristic_error)
 		heuristic_error->set_expanding_state(current_state);
 	auto ops = std::vector<OperatorID>();
@@ -114,7 +116,7 @@ void OnlineRiskLookaheadSearch::generate_tlas(GlobalState const &current_state)
 		auto const succ_state = state_registry.get_successor_state(current_state, op);
 		auto succ_node = search_space->get_node(succ_state);
 		if (store_exploration_data)
-			predecessors[succ_state.get_id()].emplace_back(current_state.get_id(), op);
+			arena.add_predecessor(succ_state.get_id(), current_state.get_id(), op_id);
 
 		if (succ_node.is_new())
 			succ_node.open(root_node, op, op.get_cost());
@@ -140,9 +142,9 @@ void OnlineRiskLookaheadSearch::generate_tlas(GlobalState const &current_state)
 		tlas.eval_contexts.emplace_back(std::move(eval_context));
 
 		if (expansion_delay) {
-			open_list_insertion_time[succ_state.get_id()] = 0;
+			arena.set_insertion_time(succ_state.get_id(), 0);
 		}
-		state_owner[succ_state.get_id()] = static_cast<int>(tlas.ops.size()) - 1;
+		arena.set_owner(succ_state.get_id(), static_cast<int>(tlas.ops.size()) - 1);
 
 		// add the belief (and expected value)
 		tlas.beliefs.push_back(node_belief(succ_node));
@@ -170,7 +172,7 @@ void OnlineRiskLookaheadSearch::initialize(const GlobalState &initial_state)
 	statistics->inc_generated(tlas.size());
 
 	if (store_exploration_data)
-		closed.emplace(initial_state.get_id());
+		arena.close(initial_state.get_id());
 }
 
 double OnlineRiskLookaheadSearch::risk_analysis(size_t const alpha, const std::vector<DiscreteDistribution> &squished_beliefs) const
@@ -319,7 +321,7 @@ get_node:
 	}
 
 	mark_expanded(node);
-	state_owner[state_id] = tla_id;
+	arena.set_owner(state_id, tla_id);
 
 	if (check_goal_and_set_plan(state)) {
 		return SOLVED;
@@ -338,7 +340,7 @@ get_node:
 		auto succ_node = search_space->get_node(succ_state);
 
 		if (store_exploration_data)
-			predecessors[succ_state.get_id()].emplace_back(state_id, op);
+			arena.add_predecessor(succ_state.get_id(), state_id, op_id);
 
 		if (succ_node.is_dead_end())
 			continue;
@@ -353,7 +355,7 @@ get_node:
 			}
 			succ_node.open(node, op, op.get_cost());
 			tlas.open_lists[tla_id]->insert(succ_eval_context, succ_state.get_id());
-			state_owner[succ_state.get_id()] = tla_id;
+			arena.set_owner(succ_state.get_id(), tla_id);
 		} else if (succ_node.get_g() > node.get_g() + op.get_cost()) {
 			// We found a new cheapest path to an open or closed state.
 			if (succ_node.is_closed())
@@ -361,10 +363,11 @@ get_node:
 			succ_node.reopen(node, op, op.get_cost());
 			auto succ_eval_context = EvaluationContext(succ_state, succ_node.get_g(), false, statistics.get());
 			tlas.open_lists[tla_id]->insert(succ_eval_context, succ_state.get_id());
-			state_owner[succ_state.get_id()] = tla_id;
+			arena.set_owner(succ_state.get_id(), tla_id);
 		}
 
-		open_list_insertion_time[state_id] = statistics->get_expanded();
+		if (expansion_delay)
+			arena.set_insertion_time(state_id, statistics->get_expanded());
 		if (heuristic_error)
 			heuristic_error->add_successor(succ_node, op.get_cost());
 	}
@@ -415,6 +418,5 @@ OnlineRiskLookaheadSearch::OnlineRiskLookaheadSearch(StateRegistry &state_regist
 {
 	tlas.reserve(32);
 	applicables.reserve(32);
-	state_owner.reserve(256);
 }
 }
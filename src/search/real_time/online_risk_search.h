@@ -63,12 +63,6 @@ class OnlineRiskLookaheadSearch : public LookaheadSearch
 	int hstar_gaussian_fallback_count;
 	int post_expansion_belief_gaussian_fallback_count;
 
-	// stores the index of the tla that owns the state
-	// this is a hack to detect and prevent a state being expanded
-	// under a tla when there is a different tla that has a shorter
-	// path to that state.
-	std::unordered_map<StateID, int> state_owner;
-
 	// This is storage for applicable operators
 	// It's kept here in the class because clearing a vector is
 	// more efficient than creating a new one each iteration
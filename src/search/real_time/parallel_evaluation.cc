@@ -0,0 +1,114 @@
+#include "parallel_evaluation.h"
+
+#include "../evaluation_context.h"
+#include "../heuristic.h"
+#include "../state_registry.h"
+
+#include "../utils/system.h"
+
+#include <cassert>
+#include <iostream>
+#include <set>
+
+namespace real_time
+{
+
+// The results of the threads can only be handed over through the
+// cache of a heuristic, and only evaluators that depend on nothing but
+// the state can be evaluated out of order.
+static Heuristic *get_target(std::shared_ptr<Evaluator> const &evaluator, char const *name)
+{
+	auto *heuristic = dynamic_cast<Heuristic *>(evaluator.get());
+	if (!heuristic || !heuristic->does_cache_estimates()) {
+		std::cerr << "lookahead_threads needs the " << name
+			  << " to be a heuristic that caches its estimates" << std::endl;
+		utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+	}
+	std::set<Evaluator *> path_dependent;
+	heuristic->get_path_dependent_evaluators(path_dependent);
+	if (!path_dependent.empty()) {
+		std::cerr << "lookahead_threads does not support path dependent "
+			  << name << "s" << std::endl;
+		utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+	}
+	return heuristic;
+}
+
+static void check_copies(std::shared_ptr<Evaluator> const &evaluator,
+			 std::vector<std::shared_ptr<Evaluator>> const &copies,
+			 char const *name)
+{
+	for (std::size_t i = 0; i < copies.size(); ++i) {
+		// a predefined evaluator is parsed to the same object every time
+		bool shared = copies[i] == evaluator;
+		for (std::size_t j = 0; j < i; ++j)
+			shared = shared || copies[i] == copies[j];
+		if (shared) {
+			std::cerr << "lookahead_threads needs one " << name << " per thread, "
+				  << "so the " << name << " must not be a predefined one" << std::endl;
+			utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+		}
+		get_target(copies[i], name);
+	}
+}
+
+ParallelEvaluation::ParallelEvaluation(StateRegistry &registry,
+				       std::shared_ptr<Evaluator> const &heuristic,
+				       std::shared_ptr<Evaluator> const &distance,
+				       std::vector<std::shared_ptr<Evaluator>> const &heuristic_copies,
+				       std::vector<std::shared_ptr<Evaluator>> const &distance_copies)
+	: heuristic(get_target(heuristic, "heuristic")),
+	  distance(distance ? get_target(distance, "distance heuristic") : nullptr),
+	  workers(heuristic_copies.size()),
+	  pool(static_cast<int>(heuristic_copies.size()))
+{
+	assert(!heuristic_copies.empty());
+	check_copies(heuristic, heuristic_copies, "heuristic");
+	if (distance) {
+		assert(distance_copies.size() == heuristic_copies.size());
+		check_copies(distance, distance_copies, "distance heuristic");
+	}
+
+	GlobalState const &initial_state = registry.get_initial_state();
+	for (std::size_t thread = 0; thread < workers.size(); ++thread) {
+		Worker &worker = workers[thread];
+		worker.heuristic = heuristic_copies[thread];
+		if (distance)
+			worker.distance = distance_copies[thread];
+		// The per-state caches of the copies subscribe to the registry
+		// when they are first used, which must not happen on the
+		// threads.
+		EvaluationContext context(initial_state, &worker.statistics);
+		context.get_evaluator_value_or_infinity(worker.heuristic.get());
+		if (worker.distance)
+			context.get_evaluator_value_or_infinity(worker.distance.get());
+	}
+}
+
+void ParallelEvaluation::evaluate(StateRegistry const &registry, std::vector<StateID> const &states,
+				  SearchStatistics &statistics)
+{
+	h_values.resize(states.size());
+	d_values.resize(states.size());
+	for (auto &worker : workers)
+		worker.statistics = SearchStatistics();
+
+	pool.run(states.size(), [&](std::size_t i, int thread) {
+		Worker &worker = workers[thread];
+		EvaluationContext context(registry.lookup_state(states[i]), &worker.statistics);
+		h_values[i] = context.get_evaluator_value_or_infinity(worker.heuristic.get());
+		if (worker.distance)
+			d_values[i] = context.get_evaluator_value_or_infinity(worker.distance.get());
+	});
+
+	for (std::size_t i = 0; i < states.size(); ++i) {
+		GlobalState const state = registry.lookup_state(states[i]);
+		heuristic->set_cached_estimate(state, h_values[i]);
+		if (distance)
+			distance->set_cached_estimate(state, d_values[i]);
+	}
+	for (auto const &worker : workers)
+		statistics.inc_evaluations(worker.statistics.get_evaluations());
+}
+
+}
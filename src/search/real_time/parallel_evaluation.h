@@ -0,0 +1,70 @@
+#ifndef REAL_TIME_PARALLEL_EVALUATION_H
+#define REAL_TIME_PARALLEL_EVALUATION_H
+
+#include "parallel_for.h"
+
+#include "../search_statistics.h"
+#include "../state_id.h"
+
+#include <memory>
+#include <vector>
+
+class Evaluator;
+class Heuristic;
+class StateRegistry;
+
+namespace real_time
+{
+
+// Evaluates the heuristics of many states on several threads, for a
+// lookahead that expands a batch of states at once.
+//
+// Evaluators keep scratch data and caches in their members, so every
+// thread evaluates with its own copy of the heuristic (and of the
+// distance heuristic, if that is a different one).  The threads only
+// read the states from the registry, and nothing is registered while
+// they run.  Afterwards, the results are stored in the caches of the
+// heuristics the lookahead evaluates with, so evaluating the states
+// there is a cache lookup.  Every thread counts its evaluations in its
+// own statistics, which are added to the lookahead's at the end.
+class ParallelEvaluation
+{
+	struct Worker
+	{
+		std::shared_ptr<Evaluator> heuristic;
+		std::shared_ptr<Evaluator> distance;
+		SearchStatistics statistics;
+	};
+
+	Heuristic *heuristic;
+	Heuristic *distance;
+	std::vector<Worker> workers;
+	ParallelFor pool;
+	std::vector<int> h_values;
+	std::vector<int> d_values;
+
+public:
+	// heuristic_copies and distance_copies hold one evaluator per
+	// thread, parsed from the same configuration as heuristic and
+	// distance.  distance may be null if the lookahead uses the
+	// heuristic as its distance heuristic.
+	ParallelEvaluation(StateRegistry &registry,
+			   std::shared_ptr<Evaluator> const &heuristic,
+			   std::shared_ptr<Evaluator> const &distance,
+			   std::vector<std::shared_ptr<Evaluator>> const &heuristic_copies,
+			   std::vector<std::shared_ptr<Evaluator>> const &distance_copies);
+
+	ParallelEvaluation(ParallelEvaluation const &) = delete;
+	ParallelEvaluation &operator=(ParallelEvaluation const &) = delete;
+
+	int get_num_threads() const { return pool.get_num_threads(); }
+
+	// Evaluates the states, which must not have been evaluated yet,
+	// and adds the evaluations to statistics.
+	void evaluate(StateRegistry const &registry, std::vector<StateID> const &states,
+		      SearchStatistics &statistics);
+};
+
+}
+
+#endif
@@ -0,0 +1,79 @@
+#include "parallel_for.h"
+
+namespace real_time
+{
+
+ParallelFor::ParallelFor(int num_threads)
+	: body(nullptr),
+	  size(0),
+	  next(0),
+	  generation(0),
+	  busy_workers(0),
+	  shutting_down(false)
+{
+	for (int thread = 1; thread < num_threads; ++thread)
+		workers.emplace_back(&ParallelFor::worker_main, this, thread);
+}
+
+ParallelFor::~ParallelFor()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		shutting_down = true;
+		++generation;
+	}
+	work_ready.notify_all();
+	for (auto &worker : workers)
+		worker.join();
+}
+
+void ParallelFor::work(int thread)
+{
+	for (std::size_t i = next++; i < size; i = next++)
+		(*body)(i, thread);
+}
+
+void ParallelFor::worker_main(int thread)
+{
+	unsigned seen = 0;
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		work_ready.wait(lock, [this, seen] { return generation != seen; });
+		seen = generation;
+		if (shutting_down)
+			return;
+		lock.unlock();
+		work(thread);
+		lock.lock();
+		// run() waits for every worker, so no worker can still look at
+		// a job once run() has returned
+		if (--busy_workers == 0)
+			work_done.notify_one();
+	}
+}
+
+void ParallelFor::run(std::size_t n, Body const &b)
+{
+	if (workers.empty() || n < 2) {
+		for (std::size_t i = 0; i < n; ++i)
+			b(i, 0);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		body = &b;
+		size = n;
+		next = 0;
+		busy_workers = static_cast<int>(workers.size());
+		++generation;
+	}
+	work_ready.notify_all();
+	work(0);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	work_done.wait(lock, [this] { return busy_workers == 0; });
+	body = nullptr;
+}
+
+}
@@ -0,0 +1,59 @@
+#ifndef REAL_TIME_PARALLEL_FOR_H
+#define REAL_TIME_PARALLEL_FOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace real_time
+{
+
+// Runs the iterations of a loop on a fixed set of threads.  The
+// threads are started once and wait for work in between, since the
+// loops we run here are short and run once per expansion.  The calling
+// thread takes part in the work, so for n threads, n - 1 workers are
+// started.  run() is not reentrant.
+class ParallelFor
+{
+public:
+	using Body = std::function<void(std::size_t i, int thread)>;
+
+	explicit ParallelFor(int num_threads);
+	~ParallelFor();
+
+	ParallelFor(ParallelFor const &) = delete;
+	ParallelFor &operator=(ParallelFor const &) = delete;
+
+	int get_num_threads() const { return static_cast<int>(workers.size()) + 1; }
+
+	// calls body(i, thread) for every i in [0, n).  thread is in
+	// [0, get_num_threads()) and no two calls with the same thread
+	// run at the same time, so it can be used to index scratch space.
+	void run(std::size_t n, Body const &body);
+
+private:
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable work_ready;
+	std::condition_variable work_done;
+
+	// the current job
+	Body const *body;
+	std::size_t size;
+	std::atomic<std::size_t> next;
+	// incremented for each job, so workers can tell new jobs apart
+	std::atomic<unsigned> generation;
+	int busy_workers;
+	bool shutting_down;
+
+	void work(int thread);
+	void worker_main(int thread);
+};
+
+}
+
+#endif
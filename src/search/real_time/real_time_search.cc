@@ -7,6 +7,8 @@
 #include <numeric> // for accumulate
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 namespace real_time
 {
@@ -16,6 +18,12 @@ auto RealTimeSearch::get_expanded_states() -> std::unique_ptr<std::unordered_set
 	return std::move(sc.ls->get_expanded_states());
 }
 
+void RealTimeSearch::search()
+{
+	SearchEngine::search();
+	sc.stop_speculating();
+}
+
 void RealTimeSearch::print_statistics() const {
 	statistics.print_detailed_statistics();
 	std::cout << "Number of lookahead phases: " << num_rts_phases << std::endl;
@@ -32,28 +40,67 @@ void RealTimeSearch::print_statistics() const {
 	sc.print_statistics();
 }
 
+// Parses the argument given for an evaluator option once more, so
+// that every lookahead thread gets an evaluator of its own.  position
+// is the index of the option among the positional arguments.
+static auto parse_copy(options::OptionParser &parser, std::string const &key, int position) -> std::shared_ptr<Evaluator> {
+	auto const &tree = *parser.get_parse_tree();
+	int num_positional = 0;
+	for (auto it = options::first_child_of_root(tree); it != options::end_of_roots_children(tree); ++it) {
+		if (it->key == key || (it->key.empty() && num_positional++ == position)) {
+			options::OptionParser copy_parser(options::subtree(tree, it), parser.get_registry(), parser.get_predefinitions(), false);
+			return copy_parser.start_parsing<std::shared_ptr<Evaluator>>();
+		}
+	}
+	return nullptr;
+}
+
 static auto _parse(options::OptionParser &parser) -> std::shared_ptr<SearchEngine> {
 	parser.document_synopsis("Lazy enforced hill-climbing", "");
 	parser.add_option<std::shared_ptr<Evaluator>>("h", "heuristic");
 	parser.add_option<std::shared_ptr<Evaluator>>("distance_heuristic", "distance heuristic", options::OptionParser::NONE);
 	parser.add_option<int>("lookahead_bound","Lookahead bound in number of expansions.", "100");
-	parser.add_option<int>("time_bound","Real-Time bound in milli seconds.", "200");
+	parser.add_option<int>("time_bound","Real-Time bound in milli seconds.  Each step (lookahead, decision and learning) gets this much time, and the lookahead leaves time for the decision and the learning going by their measured costs", "200");
 	parser.add_enum_option("rtbound_type", {"EXPANSIONS", "TIME"}, "Type of bound the algorithm is running under", "EXPANSIONS");
 	parser.add_enum_option("lookahead_search", {"A_STAR", "A_STAR_COLLECT", "F_HAT", "BREADTH_FIRST", "RISK", "ONLINE_RISK"}, "Lookahead search algorithm", "A_STAR");
 	parser.add_enum_option("learning", {"NONE","DIJKSTRA","NANCY"}, "What kind of learning update to perform (DIJKSTRA for heuristic values, NANCY for beliefs)", "NONE");
 	parser.add_enum_option("decision_strategy", {"MINIMIN", "BELLMAN", "NANCY", "ONLINE_NANCY"}, "Top-level action selection strategy", "MINIMIN");
 	parser.add_enum_option("feature_kind", {"JUST_H", "WITH_PARENT_H"}, "Kind of features to look up the beliefs in the data (the data format has to match)", "JUST_H");
 	parser.add_enum_option("post_feature_kind", {"JUST_H", "WITH_PARENT_H"}, "Kind of features to look up the post beliefs in the data (the data format has to match)", "JUST_H");
+	parser.add_enum_option("risk_kernel", {"NESTED", "CDF"}, "How risk-based lookahead computes the risk of each top-level action (CDF uses prefix sums over the beliefs and is much faster for many top-level actions)", "NESTED");
+	parser.add_enum_option("learning_queue", {"HEAP", "RADIX"}, "Priority queue of the DIJKSTRA learning (RADIX is a radix heap, which is faster for large lookaheads)", "RADIX");
+	parser.add_option<bool>("async_learning", "Run the learning phase on a separate thread while the next lookahead goes on.  Each lookahead then sees the values learned up to the phase before the previous one.  With rtbound_type=TIME, only the time the search thread spends on taking snapshots and waiting for the learning thread is taken from the lookahead", "false");
+	parser.add_enum_option("commitment", {"SINGLE", "FIXED", "TARGET", "DYNAMIC"}, "How many actions to take per lookahead, following the path to the frontier state the decision aimed for: one (SINGLE), commit_actions (FIXED), all of them (TARGET), or more while the step is behind its time budget (DYNAMIC, only with rtbound_type=TIME).  With a time bound, each action taken gives the next lookahead another time_bound", "SINGLE");
+	parser.add_option<int>("commit_actions", "Number of actions to take per lookahead with commitment=FIXED", "2", options::Bounds("1", ""));
+	parser.add_option<int>("action_duration", "Time in milliseconds the agent takes to execute an action.  If positive, the lookahead of the next step runs on a separate thread while the actions of a step are executed, starting from the state they lead to", "0", options::Bounds("0", ""));
+	parser.add_option<int>("lookahead_threads", "Number of threads of the risk-based lookahead.  With more than one, each step expands the best states of that many top-level actions, picked by their risk, and evaluates the heuristics of their successors on the threads.  Every thread parses h and distance_heuristic again, so they must be heuristics that cache their estimates, and neither they nor anything they refer to may be predefined", "1", options::Bounds("1", ""));
+	parser.add_option<bool>("subtree_reuse", "Start each lookahead by expanding again, in the same order, the states of the previous lookahead that lie under the chosen action.  They do not count against the lookahead bound, which is spent on new states only", "false");
+	parser.add_option<int>("subtree_reuse_limit", "Maximum number of states replayed per lookahead with subtree_reuse", "100", options::Bounds("0", ""));
 	// parser.add_option<int>("k", "Value for k-best decision strategy", "3");
 	parser.add_option<int>("expansion_delay_window_size", "Sliding average window size used for the computation of expansion delays (set this to 0 to use the global average)", "0", options::Bounds("0", ""));
 	parser.add_option<std::string>("hstar_data", "file containing h* data", options::OptionParser::NONE);
 	parser.add_option<std::string>("post_expansion_belief_data", "file containing post-expansion belief data", options::OptionParser::NONE);
+	parser.add_option<std::string>("belief_pool", "file with the precomputed belief distributions for the given data.  It is memory mapped and shared between processes.  If it does not exist, it is built from the data and written", options::OptionParser::NONE);
+
+	add_timeline_options(parser);
 
 	SearchEngine::add_options_to_parser(parser);
-	const auto opts = parser.parse();
+	auto opts = parser.parse();
 
 	if (parser.dry_run())
 		return nullptr;
+	int const lookahead_threads = opts.get<int>("lookahead_threads");
+	if (lookahead_threads > 1) {
+		std::vector<std::shared_ptr<Evaluator>> heuristic_copies;
+		std::vector<std::shared_ptr<Evaluator>> distance_copies;
+		for (int thread = 0; thread < lookahead_threads; ++thread) {
+			heuristic_copies.push_back(parse_copy(parser, "h", 0));
+			if (opts.contains("distance_heuristic"))
+				distance_copies.push_back(parse_copy(parser, "distance_heuristic", 1));
+		}
+		opts.set("lookahead_heuristic_copies", heuristic_copies);
+		opts.set("lookahead_distance_copies", distance_copies);
+	}
 	return std::make_shared<RealTimeSearch>(opts);
 }
 
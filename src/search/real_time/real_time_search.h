@@ -2,6 +2,7 @@
 #define REAL_TIME_REAL_TIME_SEARCH_H
 
 #include "kinds.h"
+#include "belief_pool.h"
 #include "expansion_delay.h"
 #include "heuristic_error.h"
 #include "search_ctrl.h"
@@ -23,6 +24,7 @@ class RealTimeSearch : public SearchEngine {
 
 	std::unique_ptr<HStarData<int>> hstar_data;
 	std::unique_ptr<HStarData<long long>> post_expansion_belief_data;
+	std::unique_ptr<BeliefPool> belief_pool;
 
 	SearchCtrl sc;
 
@@ -30,6 +32,8 @@ class RealTimeSearch : public SearchEngine {
 	std::unique_ptr<ExpansionDelay> expansion_delay;
 	std::unique_ptr<HeuristicError> heuristic_error;
 	void initialize_optional_features(const options::Options &opts);
+	// moves the agent
+	void apply_action(OperatorID op_id);
 
 protected:
 	void initialize() override;
@@ -40,6 +44,11 @@ public:
 	~RealTimeSearch() override;
 	auto get_expanded_states() -> std::unique_ptr<std::unordered_set<StateID> > override;
 
+	// stops a speculative lookahead that is still running when the
+	// search ends (e.g. when the time limit is reached), so that
+	// nothing touches the lookahead state afterwards
+	void search() override;
+
 	void print_statistics() const override;
 };
 }
@@ -0,0 +1,175 @@
+#include "risk_kernel.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+namespace real_time
+{
+
+double nested_risk(std::size_t const alpha,
+		   std::vector<ShiftedDistribution> const &beliefs,
+		   std::size_t const swap, ShiftedDistribution const *swapped)
+{
+	auto const belief = [&](std::size_t i) -> ShiftedDistribution const & {
+		return i == swap ? *swapped : beliefs[i];
+	};
+	double risk = 0.0;
+
+	// integrate over probability nodes in alpha's belief
+	// iterate over all other tlas beta
+	// integrate over probability nodes in beta's belief
+	// add to risk if beta cost is smaller than alpha cost
+	// => risk is proportional to the chance that alpha isn't the optimal choice
+	for (auto const &a : *belief(alpha).distribution) {
+		double shifted_a_cost = a.cost + belief(alpha).shift;
+		for (std::size_t beta = 0; beta < beliefs.size(); ++beta) {
+			assert(belief(beta).distribution != nullptr);
+			if (alpha == beta)
+				continue;
+			for (auto const &b : *belief(beta).distribution) {
+				double shifted_b_cost = b.cost + belief(beta).shift;
+				if (shifted_b_cost < shifted_a_cost)
+					risk += a.probability * b.probability * (shifted_a_cost - shifted_b_cost);
+				else
+					break;
+			}
+		}
+	}
+	return risk;
+}
+
+void CdfTable::build(ShiftedDistribution const &belief)
+{
+	assert(belief.distribution);
+	source = belief.distribution;
+	shift = belief.shift;
+	costs.clear();
+	probs.clear();
+	for (auto const &n : *belief.distribution) {
+		costs.push_back(n.cost + belief.shift);
+		probs.push_back(n.probability);
+	}
+	// risk_analysis stops at the first node that is not cheaper, so
+	// it relies on this as well.
+	assert(std::is_sorted(costs.begin(), costs.end()));
+
+	std::size_t const n = costs.size();
+	cum_prob.resize(n + 1);
+	cum_weighted.resize(n + 1);
+	cum_prob[0] = 0.0;
+	cum_weighted[0] = 0.0;
+	for (std::size_t i = 0; i < n; ++i) {
+		cum_prob[i + 1] = cum_prob[i] + probs[i];
+		cum_weighted[i + 1] = cum_weighted[i] + probs[i] * costs[i];
+	}
+}
+
+double CdfTable::expected_loss(double a) const
+{
+	auto const k = static_cast<std::size_t>(
+		std::lower_bound(costs.begin(), costs.end(), a) - costs.begin());
+	// no cheaper node, no loss.  This check also keeps an infinite a
+	// from producing inf * 0.
+	if (k == 0)
+		return 0.0;
+	return a * cum_prob[k] - cum_weighted[k];
+}
+
+void CdfRiskKernel::update(CdfTable &table, ShiftedDistribution const &belief)
+{
+	if (table.built_from(belief)) {
+		++num_reuses;
+		return;
+	}
+	table.build(belief);
+	++num_builds;
+}
+
+void CdfRiskKernel::fill_losses(CdfTable const &alpha_table,
+				std::vector<CdfTable> const &against,
+				std::vector<bool> const *active,
+				std::vector<double> &out) const
+{
+	std::size_t const width = alpha_table.size();
+	out.resize(against.size() * width);
+	for (std::size_t beta = 0; beta < against.size(); ++beta) {
+		if (active && !(*active)[beta])
+			continue;
+		double *row = out.data() + beta * width;
+		CdfTable const &table = against[beta];
+		if (table.size() == 0) {
+			std::fill(row, row + width, 0.0);
+			continue;
+		}
+		for (std::size_t j = 0; j < width; ++j)
+			row[j] = table.expected_loss(alpha_table.costs[j]);
+	}
+}
+
+double CdfRiskKernel::weighted_sum(CdfTable const &alpha_table,
+				   std::vector<double> const &base,
+				   std::vector<double> const &swapped,
+				   std::size_t alpha, std::size_t swap)
+{
+	std::size_t const width = alpha_table.size();
+	std::size_t const num_tlas = tables.size();
+	acc.assign(width, 0.0);
+	double *a = acc.data();
+	for (std::size_t beta = 0; beta < num_tlas; ++beta) {
+		if (beta == alpha)
+			continue;
+		double const *row = (beta == swap ? swapped.data() : base.data()) + beta * width;
+		for (std::size_t j = 0; j < width; ++j)
+			a[j] += row[j];
+	}
+	double risk = 0.0;
+	double const *p = alpha_table.probs.data();
+	for (std::size_t j = 0; j < width; ++j)
+		risk += p[j] * a[j];
+	return risk;
+}
+
+void CdfRiskKernel::compute(std::size_t alpha,
+			    std::vector<ShiftedDistribution> const &beliefs,
+			    std::vector<ShiftedDistribution> const &post_beliefs,
+			    std::vector<bool> const &active,
+			    std::vector<double> &risks)
+{
+	std::size_t const num_tlas = beliefs.size();
+	assert(post_beliefs.size() == num_tlas && active.size() == num_tlas);
+	assert(alpha < num_tlas);
+
+	tables.resize(num_tlas);
+	post_tables.resize(num_tlas);
+	for (std::size_t i = 0; i < num_tlas; ++i) {
+		update(tables[i], beliefs[i]);
+		// the post tables of inactive tlas are never read
+		if (active[i])
+			update(post_tables[i], post_beliefs[i]);
+	}
+
+	fill_losses(tables[alpha], tables, nullptr, losses);
+	fill_losses(tables[alpha], post_tables, &active, post_losses);
+
+	risks.assign(num_tlas, std::numeric_limits<double>::infinity());
+	for (std::size_t i = 0; i < num_tlas; ++i) {
+		if (!active[i])
+			continue;
+		if (i == alpha) {
+			// the nodes of alpha itself change, the others stay the same
+			fill_losses(post_tables[alpha], tables, nullptr, alpha_post_losses);
+			risks[i] = weighted_sum(post_tables[alpha], alpha_post_losses, alpha_post_losses, alpha, num_tlas);
+		} else {
+			risks[i] = weighted_sum(tables[alpha], losses, post_losses, alpha, i);
+		}
+	}
+}
+
+void CdfRiskKernel::print_statistics() const
+{
+	std::cout << "CDF tables built: " << num_builds << std::endl;
+	std::cout << "CDF tables reused: " << num_reuses << std::endl;
+}
+
+}
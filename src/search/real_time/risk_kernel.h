@@ -0,0 +1,104 @@
+#ifndef REAL_TIME_RISK_KERNEL_H
+#define REAL_TIME_RISK_KERNEL_H
+
+#include "DiscreteDistribution.h"
+
+#include <limits>
+#include <vector>
+
+namespace real_time
+{
+
+// The risk of alpha, the tla with the lowest expected cost: the
+// expected amount by which the cost of alpha exceeds that of another
+// tla, summed over the other tlas.  If swap is a tla index, its belief
+// is taken to be *swapped instead of beliefs[swap].  This is the nested
+// loop over the nodes of alpha, the other tlas and their nodes.
+double nested_risk(std::size_t alpha,
+		   std::vector<ShiftedDistribution> const &beliefs,
+		   std::size_t swap = std::numeric_limits<std::size_t>::max(),
+		   ShiftedDistribution const *swapped = nullptr);
+
+// Cumulative view of a shifted belief in structure-of-arrays layout.
+// costs holds the shifted costs of the nodes (sorted ascending),
+// cum_prob[k] and cum_weighted[k] hold the sum of p and p * cost
+// over the first k nodes.  With these, the expected loss of a cost a
+// against the whole belief
+//   sum_{b < a} p_b * (a - b)
+// becomes a * cum_prob[k] - cum_weighted[k] where k is the number of
+// nodes cheaper than a.
+struct CdfTable
+{
+	// the belief the table was built from.  Distributions never change
+	// after their creation, so the same distribution and shift give the
+	// same table.
+	DiscreteDistribution const *source = nullptr;
+	int shift = 0;
+	std::vector<double> costs;
+	std::vector<double> probs;
+	std::vector<double> cum_prob;
+	std::vector<double> cum_weighted;
+
+	void build(ShiftedDistribution const &belief);
+	bool built_from(ShiftedDistribution const &belief) const
+	{
+		return source == belief.distribution && shift == belief.shift;
+	}
+	double expected_loss(double a) const;
+	std::size_t size() const { return costs.size(); }
+};
+
+// Evaluates the risk of all tlas at once.  RiskLookaheadSearch
+// computes for every tla i the risk of alpha after swapping in the
+// post expansion belief of i.  Doing that with the nested loop in
+// risk_analysis costs O(T^2 * S^2) per decision.  Here, each belief
+// is turned into a CdfTable once, the loss of every node of alpha
+// against every tla is evaluated by binary search, and the risk of
+// each tla is a weighted sum over a dense T x S matrix of these
+// losses.  All inner loops run over contiguous arrays so the compiler
+// can vectorize them.
+//
+// The tables are kept per tla between calls.  Between two calls of
+// select_tla usually only the beliefs of the expanded tla change, so
+// only its tables are rebuilt.
+class CdfRiskKernel
+{
+	std::vector<CdfTable> tables;
+	std::vector<CdfTable> post_tables;
+	long long num_builds = 0;
+	long long num_reuses = 0;
+	// losses[beta * width + j] is the loss of the j-th node of
+	// alpha's belief against beta's belief.  post_losses is the same
+	// against the post expansion beliefs, alpha_post_losses uses the
+	// nodes of alpha's post expansion belief instead.
+	std::vector<double> losses;
+	std::vector<double> post_losses;
+	std::vector<double> alpha_post_losses;
+	std::vector<double> acc;
+
+	void update(CdfTable &table, ShiftedDistribution const &belief);
+	// rows of against whose active entry is false are left out
+	void fill_losses(CdfTable const &alpha_table,
+			 std::vector<CdfTable> const &against,
+			 std::vector<bool> const *active,
+			 std::vector<double> &out) const;
+	double weighted_sum(CdfTable const &alpha_table,
+			    std::vector<double> const &base,
+			    std::vector<double> const &swapped,
+			    std::size_t alpha, std::size_t swap);
+public:
+	// Computes risks[i] for every tla i with active[i] set.  The
+	// result matches RiskLookaheadSearch::risk_analysis up to
+	// floating point rounding.
+	void compute(std::size_t alpha,
+		     std::vector<ShiftedDistribution> const &beliefs,
+		     std::vector<ShiftedDistribution> const &post_beliefs,
+		     std::vector<bool> const &active,
+		     std::vector<double> &risks);
+
+	void print_statistics() const;
+};
+
+}
+
+#endif
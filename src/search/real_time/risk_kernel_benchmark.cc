@@ -0,0 +1,161 @@
+#include "risk_kernel_benchmark.h"
+
+#include "DiscreteDistribution.h"
+#include "risk_kernel.h"
+
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../utils/rng.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+
+namespace real_time
+{
+
+RiskKernelBenchmark::RiskKernelBenchmark(options::Options const &opts)
+	: SearchEngine(opts),
+	  tla_counts(opts.get_list<int>("tlas")),
+	  max_samples(opts.get<int>("samples")),
+	  calls(opts.get<int>("calls")),
+	  random_seed(opts.get<int>("random_seed"))
+{
+}
+
+long long RiskKernelBenchmark::run(int num_tlas) const
+{
+	utils::RandomNumberGenerator rng(random_seed + num_tlas);
+
+	// The distributions to draw beliefs from.  Like h* beliefs, they
+	// have integer costs in ascending order, some of them equal.
+	int const num_distributions = 4 * num_tlas + 16;
+	std::vector<std::vector<ProbabilityNode>> nodes(num_distributions);
+	std::vector<std::unique_ptr<DiscreteDistribution>> distributions;
+	for (auto &dist_nodes : nodes) {
+		int const size = 1 + rng(max_samples);
+		double cost = rng(20);
+		double total = 0.0;
+		for (int i = 0; i < size; ++i) {
+			cost += rng(3);
+			dist_nodes.emplace_back(cost, 0.01 + rng());
+			total += dist_nodes.back().probability;
+		}
+		for (auto &n : dist_nodes)
+			n.probability /= total;
+		distributions.push_back(std::make_unique<DiscreteDistribution>(
+			max_samples, dist_nodes.data(), dist_nodes.data() + dist_nodes.size()));
+	}
+
+	std::vector<ShiftedDistribution> beliefs(num_tlas);
+	std::vector<ShiftedDistribution> post_beliefs(num_tlas);
+	std::vector<bool> active(num_tlas);
+	auto const draw = [&](int tla) {
+		beliefs[tla].set(distributions[rng(num_distributions)].get(), rng(10));
+		post_beliefs[tla].set(distributions[rng(num_distributions)].get(), rng(10));
+		// some tlas have an empty open list
+		active[tla] = rng(10) != 0;
+	};
+	for (int tla = 0; tla < num_tlas; ++tla)
+		draw(tla);
+
+	CdfRiskKernel cdf_kernel;
+	std::vector<double> nested_risks(num_tlas);
+	std::vector<double> cdf_risks;
+	std::chrono::steady_clock::duration nested_time{0};
+	std::chrono::steady_clock::duration cdf_time{0};
+	double max_difference = 0.0;
+	long long num_mismatches = 0;
+
+	for (int call = 0; call < calls; ++call) {
+		draw(rng(num_tlas));
+		std::size_t alpha = 0;
+		for (int tla = 1; tla < num_tlas; ++tla) {
+			if (beliefs[tla].expected_cost() < beliefs[alpha].expected_cost())
+				alpha = tla;
+		}
+
+		auto const nested_start = std::chrono::steady_clock::now();
+		for (int tla = 0; tla < num_tlas; ++tla) {
+			if (active[tla])
+				nested_risks[tla] = nested_risk(alpha, beliefs, tla, &post_beliefs[tla]);
+		}
+		auto const cdf_start = std::chrono::steady_clock::now();
+		cdf_kernel.compute(alpha, beliefs, post_beliefs, active, cdf_risks);
+		auto const cdf_end = std::chrono::steady_clock::now();
+		nested_time += cdf_start - nested_start;
+		cdf_time += cdf_end - cdf_start;
+
+		for (int tla = 0; tla < num_tlas; ++tla) {
+			if (!active[tla])
+				continue;
+			double const difference = std::abs(nested_risks[tla] - cdf_risks[tla])
+				/ std::max(1.0, std::abs(nested_risks[tla]));
+			max_difference = std::max(max_difference, difference);
+			if (difference > 1e-9)
+				++num_mismatches;
+		}
+	}
+
+	double const nested_us = std::chrono::duration<double, std::micro>(nested_time).count() / calls;
+	double const cdf_us = std::chrono::duration<double, std::micro>(cdf_time).count() / calls;
+	std::cout << "Tlas: " << num_tlas << std::endl;
+	std::cout << "Nested kernel: " << nested_us << "us per call" << std::endl;
+	std::cout << "CDF kernel: " << cdf_us << "us per call" << std::endl;
+	if (cdf_us > 0)
+		std::cout << "Speedup: " << nested_us / cdf_us << std::endl;
+	std::cout << "Largest relative difference: " << max_difference << std::endl;
+	std::cout << "Mismatches: " << num_mismatches << std::endl;
+	cdf_kernel.print_statistics();
+	return num_mismatches;
+}
+
+SearchStatus RiskKernelBenchmark::step()
+{
+	long long num_mismatches = 0;
+	for (int num_tlas : tla_counts)
+		num_mismatches += run(num_tlas);
+	if (num_mismatches > 0) {
+		std::cerr << "the CDF kernel disagrees with the nested kernel on "
+			  << num_mismatches << " risks" << std::endl;
+		utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+	}
+	return FAILED;
+}
+
+static std::shared_ptr<SearchEngine> _parse(options::OptionParser &parser)
+{
+	parser.document_synopsis(
+		"Risk kernel benchmark",
+		"Computes the risks of random beliefs with the nested and the CDF "
+		"risk kernel of risk lookahead search, compares the results and "
+		"reports the time per call of both. Exits with an error if they "
+		"disagree. Does not search for a plan.");
+	parser.add_list_option<int>("tlas", "numbers of tlas to measure", "[2,8,32]");
+	parser.add_option<int>("samples", "maximum number of nodes per belief", "64", options::Bounds("1", ""));
+	parser.add_option<int>("calls", "risk computations per number of tlas", "10000", options::Bounds("1", ""));
+	parser.add_option<int>("random_seed", "seed of the random beliefs", "0");
+	SearchEngine::add_options_to_parser(parser);
+	options::Options opts = parser.parse();
+
+	if (!parser.dry_run()) {
+		for (int num_tlas : opts.get_list<int>("tlas")) {
+			if (num_tlas < 1)
+				parser.error("numbers of tlas must be positive");
+		}
+		if (opts.get_list<int>("tlas").empty())
+			parser.error("need at least one number of tlas");
+	}
+
+	if (parser.dry_run())
+		return nullptr;
+	return std::make_shared<RiskKernelBenchmark>(opts);
+}
+
+static options::Plugin<SearchEngine> _plugin("risk_kernel_benchmark", _parse);
+
+}
@@ -0,0 +1,42 @@
+#ifndef REAL_TIME_RISK_KERNEL_BENCHMARK_H
+#define REAL_TIME_RISK_KERNEL_BENCHMARK_H
+
+#include "../search_engine.h"
+
+#include <vector>
+
+namespace options {
+class Options;
+}
+
+namespace real_time
+{
+
+// Checks the CDF risk kernel against the nested loop, not a planner.
+//
+// For every configured number of tlas, random beliefs and post
+// expansion beliefs are drawn and then, like in a lookahead, the
+// beliefs of one random tla change before every call.  Both kernels
+// compute the risks of all tlas on the same input.  The benchmark
+// reports the time per call of both, the largest relative difference
+// of their results and fails if any result differs by more than
+// rounding.
+class RiskKernelBenchmark : public SearchEngine
+{
+	std::vector<int> const tla_counts;
+	int const max_samples;
+	int const calls;
+	int const random_seed;
+
+	// returns the number of mismatching risks
+	long long run(int num_tlas) const;
+protected:
+	SearchStatus step() override;
+public:
+	explicit RiskKernelBenchmark(options::Options const &opts);
+	~RiskKernelBenchmark() override = default;
+};
+
+}
+
+#endif
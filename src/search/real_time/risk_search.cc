@@ -14,19 +14,29 @@ namespace real_time
 
 bool RiskLookaheadSearch::state_owned_by_tla(StateID state_id, int tla_id) const
 {
-	const auto &owner = state_owners.find(state_id);
-	if (owner == state_owners.end()) {
+	auto const owner = arena.get_owner(state_id);
+	if (owner == LookaheadArena::no_owner) {
 		// this should never happen
 		std::cerr << "Encountered state with no known owner\n";
 		assert(false);
 		return false;
 	}
-	return owner->second == tla_id;
+	return owner == tla_id;
 }
 
+// with subtree reuse, replayed states are closed while their entries
+// are still in the open lists
+bool RiskLookaheadSearch::is_stale(StateID state_id) const
+{
+	return reuse_subtree && search_space->get_node(state_registry.lookup_state(state_id)).is_closed();
+}
+
+// stores the index of the tla that owns the state.  this is a hack to
+// detect and prevent a state being expanded under a tla when there is
+// a different tla that has a shorter path to that state.
 void RiskLookaheadSearch::make_state_owner(StateID state_id, int tla_id)
 {
-	state_owners[state_id] = tla_id;
+	arena.set_owner(state_id, tla_id);
 }
 
 ShiftedDistribution RiskLookaheadSearch::get_belief(EvaluationContext &eval_context, int ph)
@@ -34,9 +44,9 @@ ShiftedDistribution RiskLookaheadSearch::get_belief(EvaluationContext &eval_cont
 	// first check if we know this state from previous expansions and
 	// have a belief about it
 	auto const &state = eval_context.get_state();
-	ShiftedDistribution belief = beliefs[state];
-	if (nullptr != belief.distribution) {
-		return belief;
+	auto const known_belief = beliefs[state];
+	if (known_belief.is_known()) {
+		return distribution_table.expand(known_belief);
 	}
 
 	// if not, get the distribution associated with the state's features
@@ -55,13 +65,11 @@ ShiftedDistribution RiskLookaheadSearch::get_belief(EvaluationContext &eval_cont
 		distribution = new DiscreteDistribution(MAX_SAMPLES, f, f_hat, d, f_hat - f);
 		raw_beliefs.remember(df, distribution);
 	}
-	belief.set(distribution, 0);
-	beliefs[state] = belief;
+	beliefs[state] = CompactBelief(distribution_table.add(distribution), 0);
 
 	// It's more convenient to look up the post expansions belief here
 	// already.  This way we can be sure that both beliefs are always
 	// present.
-	ShiftedDistribution post_belief;
 	DataFeature post_df(pf_kind, h, ph);
 	DiscreteDistribution *post_distribution = raw_post_beliefs.get_distribution(post_df);
 	if (!post_distribution) {
@@ -77,13 +85,9 @@ ShiftedDistribution RiskLookaheadSearch::get_belief(EvaluationContext &eval_cont
 		post_distribution->squish(squishFactor);
 		raw_post_beliefs.remember(post_df, post_distribution);
 	}
-	post_belief.set(post_distribution, 0);
-	post_beliefs[state] = post_belief;
-
-	assert(belief.distribution);
-	assert(post_belief.distribution);
+	post_beliefs[state] = CompactBelief(distribution_table.add(post_distribution), 0);
 
-	return belief;
+	return distribution_table.expand(beliefs[state]);
 }
 
 // Post expansion belief is generated when a node is created.  It is
@@ -91,9 +95,8 @@ ShiftedDistribution RiskLookaheadSearch::get_belief(EvaluationContext &eval_cont
 ShiftedDistribution RiskLookaheadSearch::get_post_belief(StateID state_id)
 {
 	auto const &state = state_registry.lookup_state(state_id);
-	ShiftedDistribution post_belief = post_beliefs[state];
-	assert(post_belief.distribution);
-	return post_belief;
+	assert(post_beliefs[state].is_known());
+	return distribution_table.expand(post_beliefs[state]);
 }
 
 void RiskLookaheadSearch::initialize(const GlobalState &initial_state)
@@ -102,7 +105,6 @@ void RiskLookaheadSearch::initialize(const GlobalState &initial_state)
 
 	// generate tlas
 	tlas.clear();
-	state_owners.clear();
 	if (heuristic_error)
 		heuristic_error->set_expanding_state(initial_state);
 	applicables.clear();
@@ -129,7 +131,7 @@ void RiskLookaheadSearch::initialize(const GlobalState &initial_state)
 		}
 
 		if (store_exploration_data)
-			predecessors[succ_state_id].emplace_back(cur_state_id, op);
+			arena.add_predecessor(succ_state_id, cur_state_id, op_id);
 
 		auto eval_context = EvaluationContext(succ_state, succ_g, false, statistics.get());
 		if (eval_context.is_evaluator_value_infinite(heuristic.get()) || eval_context.is_evaluator_value_infinite(distance_heuristic.get())) {
@@ -159,11 +161,11 @@ void RiskLookaheadSearch::initialize(const GlobalState &initial_state)
 		tlas.eval_contexts.emplace_back(std::move(eval_context));
 
 		if (expansion_delay) {
-			open_list_insertion_time[succ_state_id] = 0;
+			arena.set_insertion_time(succ_state_id, 0);
 		}
 		// make the tla own the state of the top level node (I assume
 		// here, that the state of all top level nodes are distinct)
-		assert(state_owners[succ_state_id].empty());
+		assert(arena.get_owner(succ_state_id) == LookaheadArena::no_owner);
 		make_state_owner(succ_state_id, static_cast<int>(tlas.ops.size()) - 1);
 
 		if (heuristic_error)
@@ -197,31 +199,46 @@ void RiskLookaheadSearch::initialize(const GlobalState &initial_state)
 #endif
 }
 
-double RiskLookaheadSearch::risk_analysis(size_t const alpha, const std::vector<ShiftedDistribution> &est_beliefs) const
+// Fills risks[i] with the risk of alpha if tla i was expanded, for
+// every tla with a non-empty open list.
+void RiskLookaheadSearch::compute_risks(size_t alpha)
 {
-	double risk = 0.0;
-
-	// integrate over probability nodes in alpha's belief
-	// iterate over all other tlas beta
-	// integrate over probability nodes in beta's belief
-	// add to risk if beta cost is smaller than alpha cost
-	// => risk is proportional to the chance that alpha isn't the optimal choice
-	for (auto const &a : *est_beliefs[alpha].distribution) {
-		double shifted_a_cost = a.cost + est_beliefs[alpha].shift;
-		for (size_t beta = 0; beta < tlas.size(); ++beta) {
-			assert(est_beliefs[beta].distribution != nullptr);
-			if (alpha == beta)
+	risk_active.assign(tlas.size(), false);
+	for (size_t i = 0; i < tlas.size(); ++i) {
+		if (tlas.open_lists[i].empty())
+			continue;
+		assert(expansion_delay);
+		assert(tlas.post_beliefs[i].expected_cost() -
+		       (get_post_belief(tlas.open_lists[i].top().second).expected_cost() + tlas.open_lists[i].top().first.g - tlas.op_costs[i])
+		       < 0.01);
+		assert(tlas.post_beliefs[i].distribution);
+		assert(tlas.beliefs[i].distribution);
+		risk_active[i] = true;
+	}
+
+	if (risk_kernel == RiskKernel::CDF) {
+		cdf_kernel.compute(alpha, tlas.beliefs, tlas.post_beliefs, risk_active, risks);
+#ifndef NDEBUG
+		for (size_t i = 0; i < tlas.size(); ++i) {
+			if (!risk_active[i])
 				continue;
-			for (auto const &b : *est_beliefs[beta].distribution) {
-				double shifted_b_cost = b.cost + est_beliefs[beta].shift;
-				if (shifted_b_cost < shifted_a_cost)
-					risk += a.probability * b.probability * (shifted_a_cost - shifted_b_cost);
-				else
-					break;
-			}
+			double const nested = nested_risk(alpha, tlas.beliefs, i, &tlas.post_beliefs[i]);
+			assert(nested == risks[i] ||
+			       std::abs(nested - risks[i]) <= 1e-9 * std::max(1.0, std::abs(nested)));
 		}
+#endif
+		return;
+	}
+
+	risks.assign(tlas.size(), std::numeric_limits<double>::infinity());
+	for (size_t i = 0; i < tlas.size(); ++i) {
+		if (!risk_active[i])
+			continue;
+		// Simulate how expanding this TLA's best node would affect
+		// its belief by swapping in the estimated post expansion
+		// belief
+		risks[i] = nested_risk(alpha, tlas.beliefs, i, &tlas.post_beliefs[i]);
 	}
-	return risk;
 }
 
 // select the tla with the minimal expected risk
@@ -240,25 +257,13 @@ size_t RiskLookaheadSearch::select_tla()
 		}
 	}
 
+	compute_risks(alpha);
+
 	for (size_t i = 0; i < tlas.size(); ++i) {
-		if (tlas.open_lists[i].empty()) {
+		if (!risk_active[i]) {
 			continue;
 		}
-		assert(expansion_delay);
-		assert(tlas.post_beliefs[i].expected_cost() -
-		       (get_post_belief(tlas.open_lists[i].top().second).expected_cost() + tlas.open_lists[i].top().first.g - tlas.op_costs[i])
-		       < 0.01);
-
-		// Simulate how expanding this TLA's best node would affect its belief
-		ShiftedDistribution post_i = tlas.post_beliefs[i];
-		assert(post_i.distribution);
-		// swap in the estimated post expansion belief
-		ShiftedDistribution tmp = tlas.beliefs[i];
-		assert(tmp.distribution);
-		tlas.beliefs[i] = post_i;
-		double risk = risk_analysis(alpha, tlas.beliefs);
-		// restore the previous one
-		tlas.beliefs[i] = tmp;
+		double risk = risks[i];
 
 		// keep the minimum risk tla.
 		// otherwise tie-break f_hat -> f -> g
@@ -305,6 +310,24 @@ size_t RiskLookaheadSearch::select_tla()
 	return res;
 }
 
+// fills batch_tlas with the tla select_tla picks, followed by the
+// other tlas with non-empty open lists in the order of their risks,
+// up to num tlas in total
+void RiskLookaheadSearch::select_tlas(std::size_t num)
+{
+	batch_tlas.clear();
+	std::size_t const best = select_tla();
+	batch_tlas.push_back(best);
+	for (size_t i = 0; i < tlas.size(); ++i) {
+		if (i != best && risk_active[i])
+			batch_tlas.push_back(i);
+	}
+	std::stable_sort(batch_tlas.begin() + 1, batch_tlas.end(),
+			 [this](std::size_t a, std::size_t b) { return risks[a] < risks[b]; });
+	if (batch_tlas.size() > num)
+		batch_tlas.resize(num);
+}
+
 // nancy just backs up the top of the open list
 void RiskLookaheadSearch::backup_beliefs()
 {
@@ -325,21 +348,23 @@ void RiskLookaheadSearch::backup_beliefs()
 			auto const state_id = best_state.second;
 			// we want the g from best_state to top level node, not to root
 			auto const g = best_state.first.g - tlas.op_costs[tla_id];
-			// only consider this state if we own it
-			if (state_owned_by_tla(state_id, tla_id)) {
+			// only consider this state if we own it and it is still
+			// open after replaying the previous lookahead
+			if (state_owned_by_tla(state_id, tla_id) && !is_stale(state_id)) {
 				// only do backup if it's a different state from last time
 				if (state_id != tlas.states[tla_id].first) {
 					auto best_state = state_registry.lookup_state(state_id);
 					// every known node should have a known belief
-					assert(beliefs[best_state].distribution != nullptr);
-					assert(post_beliefs[best_state].distribution != nullptr);
+					assert(beliefs[best_state].is_known());
+					assert(post_beliefs[best_state].is_known());
+					auto const belief = distribution_table.expand(beliefs[best_state]);
 
-					tlas.states[tla_id] = std::make_pair(state_id, beliefs[best_state].expected_cost());
+					tlas.states[tla_id] = std::make_pair(state_id, belief.expected_cost());
 
-					tlas.beliefs[tla_id].set_and_shift(beliefs[best_state], g);
-					tlas.post_beliefs[tla_id].set_and_shift(post_beliefs[best_state], g);
+					tlas.beliefs[tla_id].set_and_shift(belief, g);
+					tlas.post_beliefs[tla_id].set_and_shift(distribution_table.expand(post_beliefs[best_state]), g);
 					tlas.eval_contexts[tla_id] = EvaluationContext(best_state, g, false, statistics.get());
-					assert(beliefs[best_state].expected_cost() + g - tlas.beliefs[tla_id].expected_cost() < 0.01);
+					assert(belief.expected_cost() + g - tlas.beliefs[tla_id].expected_cost() < 0.01);
 				}
 				// we're done in any case, since we found the best owned node
 				// for this tla.
@@ -360,9 +385,15 @@ SearchStatus RiskLookaheadSearch::step()
 		return FAILED;
 	}
 
+	if (reuse_subtree && replay_next())
+		return IN_PROGRESS;
+
 	// setup work: find tla to expand under
 	backup_beliefs();
 
+	if (parallel)
+		return expand_batch();
+
 get_node:
 	int tla_id = select_tla();
 	if (tlas.open_lists[tla_id].empty()) {
@@ -397,23 +428,114 @@ get_node:
 		return SOLVED;
 	}
 
+	generate_successors(node, state, tla_id, this_h, false);
+	return IN_PROGRESS;
+}
+
+// Expands the best state of each of the tlas select_tlas picks, one
+// per thread.  The successors of all of them are generated and
+// registered in one batch, the heuristics of the new ones are evaluated
+// on the threads, and then the successors are inserted one expansion
+// after the other, as in step().  A batch can take the lookahead up to
+// one batch beyond its bound.
+SearchStatus RiskLookaheadSearch::expand_batch()
+{
+	select_tlas(parallel->get_num_threads());
+	if (tlas.open_lists[batch_tlas.front()].empty())
+		return FAILED;
+
+	batch.clear();
+	batch_parents.clear();
+	for (auto const tla_id : batch_tlas) {
+		// the first open state the tla owns, like in step()
+		while (!tlas.open_lists[tla_id].empty()) {
+			auto const top = tlas.remove_min(tla_id);
+			if (!state_owned_by_tla(top.second, tla_id))
+				continue;
+			auto state = state_registry.lookup_state(top.second);
+			auto node = search_space->get_node(state);
+			if (node.is_closed())
+				continue;
+			mark_expanded(node);
+			if (check_goal_and_set_plan(state))
+				return SOLVED;
+			batch.push_back(Expansion{top.second, static_cast<int>(tla_id), top.first.h});
+			batch_parents.push_back(top.second);
+			break;
+		}
+	}
+	// the tlas were emptied, others may still have open states
+	if (batch.empty())
+		return IN_PROGRESS;
+	++num_batches;
+
+	successor_generator.generate_applicable_ops(state_registry, batch_parents, applicables, applicable_offsets);
+	state_registry.get_successor_states(batch_parents, applicables, applicable_offsets, successor_ids);
+
+	unevaluated.clear();
+	for (auto const &succ_id : successor_ids) {
+		auto const succ_state = state_registry.lookup_state(succ_id);
+		if (search_space->get_node(succ_state).is_new() && !base_heuristic->is_estimate_cached(succ_state))
+			unevaluated.push_back(succ_id);
+	}
+	// two expanded states can have a successor in common
+	std::sort(unevaluated.begin(), unevaluated.end(),
+		  [](StateID a, StateID b) { return a.hash() < b.hash(); });
+	unevaluated.erase(std::unique(unevaluated.begin(), unevaluated.end()), unevaluated.end());
+	parallel->evaluate(state_registry, unevaluated, *statistics);
+	num_parallel_evaluations += unevaluated.size();
+
+	for (size_t i = 0; i < batch.size(); ++i) {
+		auto state = state_registry.lookup_state(batch[i].state_id);
+		auto node = search_space->get_node(state);
+		auto const first = applicable_offsets[i];
+		insert_successors(node, state, batch[i].tla_id, batch[i].h, false,
+				  applicables.data() + first, successor_ids.data() + first,
+				  applicable_offsets[i + 1] - first);
+	}
+	return IN_PROGRESS;
+}
+
+void RiskLookaheadSearch::replay_expansion(SearchNode &node, const GlobalState &state)
+{
+	auto const tla_id = arena.get_owner(state.get_id());
+	auto eval_context = EvaluationContext(state, node.get_g(), false, statistics.get());
+	auto const this_h = eval_context.get_evaluator_value_or_infinity(heuristic.get());
+	generate_successors(node, state, tla_id, this_h, true);
+}
+
+// the heuristic error is only learned from new expansions
+void RiskLookaheadSearch::generate_successors(SearchNode &node, const GlobalState &state, int tla_id, int this_h, bool replay)
+{
 	applicables.clear();
 	successor_generator.generate_applicable_ops(state, applicables);
+	successor_ids.clear();
+	for (auto op_id : applicables)
+		successor_ids.push_back(state_registry.get_successor_state(state, task_proxy.get_operators()[op_id]).get_id());
+	insert_successors(node, state, tla_id, this_h, replay, applicables.data(), successor_ids.data(), applicables.size());
+}
+
+// successors[i] is the successor of state under ops[i]
+void RiskLookaheadSearch::insert_successors(SearchNode &node, const GlobalState &state, int tla_id, int this_h, bool replay,
+					    OperatorID const *ops, StateID const *successors, std::size_t num_successors)
+{
+	auto const state_id = state.get_id();
 	auto eval_context = EvaluationContext(state, node.get_g(), false, statistics.get());
-	if (heuristic_error)
+	if (heuristic_error && !replay)
 		heuristic_error->set_expanding_state(state);
 
-	for (auto op_id : applicables) {
+	for (size_t i = 0; i < num_successors; ++i) {
+		const auto op_id = ops[i];
 		const auto op = task_proxy.get_operators()[op_id];
 		const auto adj_cost = search_engine->get_adjusted_cost(op);
-		const auto succ_state = state_registry.get_successor_state(state, op);
+		const auto succ_state = state_registry.lookup_state(successors[i]);
 		const auto succ_state_id = succ_state.get_id();
 		statistics->inc_generated();
 		auto succ_node = search_space->get_node(succ_state);
 		auto succ_g = node.get_g() + adj_cost;
 
 		if (store_exploration_data)
-			predecessors[succ_state_id].emplace_back(state_id, op);
+			arena.add_predecessor(succ_state_id, state_id, op_id);
 
 		if (succ_node.is_dead_end())
 			continue;
@@ -454,14 +576,14 @@ get_node:
 			}
 		}
 
-		open_list_insertion_time[state_id] = statistics->get_expanded();
-		if (heuristic_error)
+		if (expansion_delay)
+			arena.set_insertion_time(state_id, statistics->get_expanded());
+		if (heuristic_error && !replay)
 			heuristic_error->add_successor(succ_node, adj_cost);
 	}
-	if (heuristic_error)
+	if (heuristic_error && !replay)
 		heuristic_error->update_error();
 
-	return IN_PROGRESS;
 }
 
 void RiskLookaheadSearch::post()
@@ -470,7 +592,7 @@ void RiskLookaheadSearch::post()
 	for (size_t i = 0; i < tlas.open_lists.size(); ++i) {
 		while (!tlas.open_lists[i].empty()) {
 			StateID state_id = tlas.remove_min(i).second;
-			if (state_owned_by_tla(state_id, i))
+			if (state_owned_by_tla(state_id, i) && !is_stale(state_id))
 				frontier.push_back(state_id);
 		}
 	}
@@ -481,6 +603,15 @@ void RiskLookaheadSearch::print_statistics() const {
 		  << "Fallback to gaussian (post-expansion belief): " << post_expansion_belief_gaussian_fallback_count << "\n"
 		  << "Number of expansions under alpha: " << alpha_expansion_count << "\n"
 		  << "Number of expansions under beta: " << beta_expansion_count << "\n";
+	raw_beliefs.print_statistics("Belief");
+	raw_post_beliefs.print_statistics("Post-expansion belief");
+	if (risk_kernel == RiskKernel::CDF)
+		cdf_kernel.print_statistics();
+	if (parallel) {
+		std::cout << "Lookahead threads: " << parallel->get_num_threads() << "\n"
+			  << "Expansion batches: " << num_batches << "\n"
+			  << "States evaluated on the lookahead threads: " << num_parallel_evaluations << std::endl;
+	}
 }
 
 RiskLookaheadSearch::RiskLookaheadSearch(StateRegistry &state_registry,
@@ -488,9 +619,11 @@ RiskLookaheadSearch::RiskLookaheadSearch(StateRegistry &state_registry,
 					 bool store_exploration_data, ExpansionDelay *expansion_delay, HeuristicError *heuristic_error,
 					 HStarData<int> *hstar_data,
 					 HStarData<long long> *post_expansion_belief_data,
+					 BeliefPool const *belief_pool,
 					 SearchEngine const *search_engine,
 					 DataFeatureKind f_kind,
-					 DataFeatureKind pf_kind)
+					 DataFeatureKind pf_kind,
+					 RiskKernel risk_kernel)
 	: LookaheadSearch(state_registry, store_exploration_data,
 			  expansion_delay, heuristic_error, search_engine),
 	  f_evaluator(std::make_shared<sum_evaluator::SumEvaluator>(std::vector<std::shared_ptr<Evaluator>>{heuristic, std::make_shared<g_evaluator::GEvaluator>()})),
@@ -500,8 +633,8 @@ RiskLookaheadSearch::RiskLookaheadSearch(StateRegistry &state_registry,
 	  distance_heuristic(distance),
 	  beliefs(),
 	  post_beliefs(),
-	  raw_beliefs(f_kind, hstar_data),
-	  raw_post_beliefs(pf_kind, post_expansion_belief_data),
+	  raw_beliefs(f_kind, hstar_data, belief_pool, BeliefPool::HSTAR),
+	  raw_post_beliefs(pf_kind, post_expansion_belief_data, belief_pool, BeliefPool::POST_EXPANSION),
 	  f_kind(f_kind),
 	  pf_kind(pf_kind),
 	  hstar_data(hstar_data),
@@ -509,11 +642,15 @@ RiskLookaheadSearch::RiskLookaheadSearch(StateRegistry &state_registry,
 	  hstar_gaussian_fallback_count(0),
 	  post_expansion_belief_gaussian_fallback_count(0),
 	  alpha_expansion_count(0),
-	  beta_expansion_count(0)
+	  beta_expansion_count(0),
+	  num_batches(0),
+	  num_parallel_evaluations(0),
+	  risk_kernel(risk_kernel)
 {
 	tlas.reserve(32);
 	applicables.reserve(32);
-	state_owners.reserve(256);
+	risk_active.reserve(32);
+	risks.reserve(32);
 	assert(raw_beliefs.size() > 0 && raw_post_beliefs.size() > 0);
 
 	dead_end_belief.set(&DiscreteDistribution::dead_distribution, 0);
@@ -5,6 +5,10 @@
 #include "DiscreteDistribution.h"
 #include "belief_data.h"
 #include "belief_store.h"
+#include "compact_belief.h"
+#include "kinds.h"
+#include "parallel_evaluation.h"
+#include "risk_kernel.h"
 #include "tlas.h"
 #include "../evaluator.h"
 #include "../open_list.h"
@@ -13,16 +17,16 @@
 #include "../state_registry.h"
 #include "../per_state_information.h"
 
+#include <limits>
 #include <memory>
 #include <vector>
-#include <unordered_map>
 
 namespace real_time
 {
 
 class RiskLookaheadSearch : public LookaheadSearch
 {
-	using Beliefs = PerStateInformation<ShiftedDistribution>;
+	using Beliefs = PerStateInformation<CompactBelief>;
 
 	std::shared_ptr<Evaluator> f_evaluator;
 	std::shared_ptr<Evaluator> f_hat_evaluator;
@@ -32,7 +36,9 @@ class RiskLookaheadSearch : public LookaheadSearch
 
 	TLAs tlas;
 
-	// beliefs for each state
+	// beliefs for each state, referring to the distributions in
+	// distribution_table
+	DistributionTable distribution_table;
 	Beliefs beliefs;
 	Beliefs post_beliefs;
 	// cached distributions for each feature value
@@ -51,25 +57,52 @@ class RiskLookaheadSearch : public LookaheadSearch
 	int alpha_expansion_count;
 	int beta_expansion_count;
 
-	// stores the index of the tla that owns the state
-	// this is a hack to detect and prevent a state being expanded
-	// under a tla when there is a different tla that has a shorter
-	// path to that state.
-	std::unordered_map<StateID, int> state_owners;
-
 	// This is storage for applicable operators
 	// It's kept here in the class because clearing a vector is
 	// more efficient than creating a new one each iteration
 	std::vector<OperatorID> applicables;
+	std::vector<int> applicable_offsets;
+	std::vector<StateID> successor_ids;
+
+	// if set, each step expands a batch of states under different
+	// tlas and evaluates their successors on several threads
+	std::unique_ptr<ParallelEvaluation> parallel;
+	struct Expansion
+	{
+		StateID state_id;
+		int tla_id;
+		int h;
+	};
+	// scratch space for expand_batch
+	std::vector<std::size_t> batch_tlas;
+	std::vector<Expansion> batch;
+	std::vector<StateID> batch_parents;
+	std::vector<StateID> unevaluated;
+	long long num_batches;
+	long long num_parallel_evaluations;
+
+	// how the risk of each tla is computed in select_tla
+	RiskKernel risk_kernel;
+	CdfRiskKernel cdf_kernel;
+	// scratch space for select_tla, reused across calls
+	std::vector<bool> risk_active;
+	std::vector<double> risks;
 protected:
 	//std::unique_ptr<StateOpenList> create_open_list() const;
 	void make_state_owner(StateID state_id, int tla_id);
 	bool state_owned_by_tla(StateID state_id, int tla_id) const;
-	double risk_analysis(std::size_t const alpha, const std::vector<ShiftedDistribution> &beliefs) const;
+	bool is_stale(StateID state_id) const;
+	void compute_risks(std::size_t alpha);
 	std::size_t select_tla();
+	void select_tlas(std::size_t num);
+	SearchStatus expand_batch();
 	void backup_beliefs();
 	ShiftedDistribution get_belief(EvaluationContext &context, int ph);
 	ShiftedDistribution get_post_belief(StateID state_id);
+	void generate_successors(SearchNode &node, const GlobalState &state, int tla_id, int this_h, bool replay);
+	void insert_successors(SearchNode &node, const GlobalState &state, int tla_id, int this_h, bool replay,
+			       OperatorID const *ops, StateID const *successors, std::size_t num_successors);
+	void replay_expansion(SearchNode &node, const GlobalState &state) override;
 public:
 
 	RiskLookaheadSearch(StateRegistry &state_registry,
@@ -81,11 +114,15 @@ public:
 		HeuristicError *heuristic_error,
 		HStarData<int> *hstar_data,
 		HStarData<long long> *post_expansion_belief_data,
+		BeliefPool const *belief_pool,
 		SearchEngine const *search_engine,
 		DataFeatureKind f_kind,
-		DataFeatureKind pf_kind);
+		DataFeatureKind pf_kind,
+		RiskKernel risk_kernel);
 	~RiskLookaheadSearch() override;
 
+	void set_parallel_evaluation(std::unique_ptr<ParallelEvaluation> evaluation) { parallel = std::move(evaluation); }
+
 	void initialize(const GlobalState &initial_state) final;
 	auto step() -> SearchStatus final;
 	auto post() -> void final;
@@ -99,8 +136,9 @@ public:
 	auto operator=(RiskLookaheadSearch &&) = delete;
 
 	auto get_tlas() -> TLAs const * { return &tlas; }
-	auto get_beliefs() -> PerStateInformation<ShiftedDistribution> * { return &beliefs; }
-	auto get_post_beliefs() -> PerStateInformation<ShiftedDistribution> * { return &post_beliefs; }
+	auto get_beliefs() -> PerStateInformation<CompactBelief> * { return &beliefs; }
+	auto get_post_beliefs() -> PerStateInformation<CompactBelief> * { return &post_beliefs; }
+	auto get_distribution_table() -> DistributionTable const * { return &distribution_table; }
 };
 
 }
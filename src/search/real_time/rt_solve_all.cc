@@ -25,9 +25,9 @@ RtSolveAll::RtSolveAll(const options::Options &opts)
 	 f_evaluator(opts.get<std::shared_ptr<Evaluator> >("f_eval", nullptr)),
 	 evaluator(opts.get<std::shared_ptr<Evaluator> >("eval")),
 	 reopen_closed_nodes(opts.get<bool>("reopen_closed_nodes")),
-	 hstar_file(opts.get<std::string>("hstar_file")),
-	 successors_file(opts.get<std::string>("successors_file")),
-	 collect_parent_h(opts.get<bool>("collect_parent_h")),
+	 hstar_writer(opts.get<std::string>("hstar_file"), get_sample_format(opts), HStarSamples, opts.get<bool>("collect_parent_h")),
+	 successors_writer(opts.get<std::string>("successors_file"), get_sample_format(opts), SuccessorSamples),
+	 num_solved_states(0),
 	 reserved_time(opts.get<double>("reserved_time")),
 	 timer(std::numeric_limits<double>::infinity())
 {
@@ -60,62 +60,40 @@ void RtSolveAll::initialize()
 	assert(search_space != nullptr);
 }
 
-void RtSolveAll::dump_hstar_values() const
-{
-	auto out = std::ofstream(hstar_file);
-	if (collect_parent_h) {
-		for (const auto &[state_id, values] : solved_states) {
-			const auto [h, hstar, ph] = values;
-			out << h << ' ' << hstar << ' ' << ph << '\n';
-		}
-	} else {
-		for (const auto &[state_id, values] : solved_states) {
-			const auto [h, hstar, ph] = values;
-			out << h << ' ' << hstar << '\n';
-		}
-	}
-
-	std::cout << "wrote h* data to " << hstar_file << '\n';
-}
-
-void RtSolveAll::dump_succ_value(std::ostream &out, const GlobalState &state, int h)
+void RtSolveAll::write_succ_values(const GlobalState &state, int h)
 {
 	applicables.clear();
 	successor_generator.generate_applicable_ops(state, applicables);
 	assert(!applicables.empty());
-	out << h;
+	successors.clear();
 
 	for (auto op_id : applicables) {
 		auto op = task_proxy.get_operators()[op_id];
 		auto successor = state_registry.get_successor_state(state, op);
 		auto eval_context = EvaluationContext(successor);
 		if (!eval_context.is_evaluator_value_infinite(evaluator.get()))
-			out << " " << get_adjusted_cost(op) << " " << eval_context.get_evaluator_value(evaluator.get());
+			successors.emplace_back(get_adjusted_cost(op), eval_context.get_evaluator_value(evaluator.get()));
 	}
 
-	out << '\n';
+	successors_writer.write_successors(h, successors);
 }
 
-void RtSolveAll::dump_succ_values()
+void RtSolveAll::finish_samples()
 {
-	auto out = std::ofstream(successors_file);
-	for (const auto &[state_id, values] : solved_states) {
-		const auto [h, hstar, ph] = values;
-		GlobalState const &state{state_registry.lookup_state(state_id)};
-		if (task_properties::is_goal_state(task_proxy, state) || hstar == EvaluationResult::INFTY)
-			continue;
-		dump_succ_value(out, state, h);
-	}
+	// the successors data of the solved states is already written
 	for (const auto &state_id : *expanded_states) {
 		GlobalState const &state{state_registry.lookup_state(state_id)};
 		EvaluationContext evc{state};
 		if (task_properties::is_goal_state(task_proxy, state) || evc.is_evaluator_value_infinite(evaluator.get()))
 			continue;
 		const auto h = evc.get_evaluator_value(evaluator.get());
-		dump_succ_value(out, state, h);
+		write_succ_values(state, h);
 	}
+	hstar_writer.flush();
+	successors_writer.flush();
 
-	std::cout << "wrote successors data to " << successors_file << '\n';
+	std::cout << "wrote h* data to " << hstar_writer.get_file_name() << '\n';
+	std::cout << "wrote successors data to " << successors_writer.get_file_name() << '\n';
 }
 
 void RtSolveAll::init_next_open_list()
@@ -124,7 +102,7 @@ void RtSolveAll::init_next_open_list()
 	auto const next_id = *(expanded_states->begin());
 	auto const next_state = state_registry.lookup_state(next_id);
 	open_list->clear();
-	search_space = std::make_unique<SearchSpace>(state_registry);
+	search_space->reset();
 	auto initial_node = search_space->get_node(next_state);
 	initial_node.open_initial();
 	EvaluationContext evc{next_state, 0, true, &statistics};
@@ -152,9 +130,11 @@ SearchStatus RtSolveAll::update_hstar(SearchNode const &node, int hstar)
 			} else {
 				ph = h;
 			}
-			assert(solved_states.find(cur_state.get_id()) == std::end(solved_states));
 			assert(evc.get_evaluator_value(evaluator.get()) <= hstar);
-			solved_states.emplace(cur_state.get_id(), std::make_tuple(h, hstar, ph));
+			++num_solved_states;
+			hstar_writer.write_hstar(h, hstar, ph);
+			if (!task_properties::is_goal_state(task_proxy, cur_state))
+				write_succ_values(cur_state, h);
 		}
 
 		if (!has_parent)
@@ -165,8 +145,7 @@ SearchStatus RtSolveAll::update_hstar(SearchNode const &node, int hstar)
 	}
 
 	if (expanded_states->empty()) {
-		dump_hstar_values();
-		dump_succ_values();
+		finish_samples();
 		return SOLVED;
 	}
 
@@ -236,8 +215,7 @@ void RtSolveAll::eval_node(SearchNode &sn, OperatorProxy const &op, SearchNode c
 SearchStatus RtSolveAll::step()
 {
 	if (timer.is_expired()) {
-		dump_hstar_values();
-		dump_succ_values();
+		finish_samples();
 		return TIMEOUT;
 	}
 
@@ -278,7 +256,7 @@ SearchStatus RtSolveAll::step()
 void RtSolveAll::print_statistics() const
 {
 	statistics.print_detailed_statistics();
-	std::cout << "Number of solved states: " << solved_states.size() << "\n";
+	std::cout << "Number of solved states: " << num_solved_states << "\n";
 }
 
 static std::shared_ptr<SearchEngine> _parse(options::OptionParser &parser) {
@@ -289,6 +267,7 @@ static std::shared_ptr<SearchEngine> _parse(options::OptionParser &parser) {
 	parser.add_option<std::string>("successors_file", "file name to dump post-expansion data", "successors_data.txt");
 	parser.add_option<double>("reserved_time", "reserved time to dump data", "0", Bounds("0", ""));
 	parser.add_option<bool>("collect_parent_h", "also collect and print the parent h for each state", "false");
+	add_sample_format_option(parser);
 	parser.add_option<bool>("reopen_closed_nodes", "reopen closed nodes when solving", "true");
 
 	SearchEngine::add_pruning_option(parser);
@@ -5,6 +5,7 @@
 #include "../search_engine.h"
 #include "../utils/countdown_timer.h"
 #include "real_time_search.h"
+#include "sample_writer.h"
 
 #include <memory>
 #include <vector>
@@ -44,19 +45,18 @@ class RtSolveAll : public SearchEngine {
 	std::shared_ptr<Evaluator> evaluator;
 	const bool reopen_closed_nodes;
 
-	const std::string hstar_file;
-	void dump_hstar_values() const;
-
-	const std::string successors_file;
-	void dump_succ_values();
-	void dump_succ_value(std::ostream &out, GlobalState const &state, int h);
+	// samples are written as soon as the states are solved
+	SampleWriter hstar_writer;
+	SampleWriter successors_writer;
+	void write_succ_values(GlobalState const &state, int h);
+	void finish_samples();
+	std::vector<std::pair<int, int>> successors;
 
 	std::tuple<GlobalState, SearchNode, bool> fetch_next_node();
 	void eval_node(SearchNode &sn, OperatorProxy const &op, SearchNode const &n);
 	SearchStatus update_hstar(SearchNode const &node, int hstar);
 
-	std::unordered_map<StateID, std::tuple<int, int, int>> solved_states;
-	const bool collect_parent_h;
+	int num_solved_states;
 
 	std::vector<OperatorID> applicables;
 
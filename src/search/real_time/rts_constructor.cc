@@ -13,6 +13,7 @@
 #include "scalar_decider.h"
 #include "dist_decider.h"
 #include "belief_data.h"
+#include "belief_pool.h"
 #include "DiscreteDistribution.h"
 #include "state_collector.h"
 #include "risk_search.h"
@@ -40,6 +41,8 @@ RealTimeSearch::RealTimeSearch(const options::Options &opts)
 		hstar_data = std::make_unique<HStarData<int>>(opts.get<std::string>("hstar_data"), f_kind);
 	if (opts.contains("post_expansion_belief_data"))
 		post_expansion_belief_data = std::make_unique<HStarData<long long>>(opts.get<std::string>("post_expansion_belief_data"), pf_kind);
+	if (opts.contains("belief_pool"))
+		belief_pool = std::make_unique<BeliefPool>(opts.get<std::string>("belief_pool"), hstar_data.get(), post_expansion_belief_data.get());
 
 	heuristic = opts.get<std::shared_ptr<Evaluator>>("h");
 	base_heuristic = heuristic;
@@ -53,6 +56,11 @@ RealTimeSearch::RealTimeSearch(const options::Options &opts)
 	bool const store_exploration_data = sc.lm != BackupMethod::NONE;
 	//bool const store_exploration_data = true;
 
+	if (opts.get<int>("lookahead_threads") > 1 && sc.lsm != LookaheadSearchMethod::RISK) {
+		std::cerr << "lookahead_threads is only supported by the risk-based lookahead" << std::endl;
+		utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+	}
+
 	std::cout << "initializing lookahead method\n";
 	switch (sc.lsm) {
 	case LookaheadSearchMethod::A_STAR_COLLECT:
@@ -67,9 +75,22 @@ RealTimeSearch::RealTimeSearch(const options::Options &opts)
 	case LookaheadSearchMethod::F_HAT:
 		sc.ls = std::make_unique<FHatLookaheadSearch>(state_registry, heuristic, distance_heuristic, store_exploration_data, expansion_delay.get(), *heuristic_error, this);
 		break;
-	case LookaheadSearchMethod::RISK:
-		sc.ls = std::make_unique<RiskLookaheadSearch>(state_registry, heuristic, base_heuristic, distance_heuristic, store_exploration_data, expansion_delay.get(), heuristic_error.get(), hstar_data.get(), post_expansion_belief_data.get(), this, f_kind, pf_kind);
+	case LookaheadSearchMethod::RISK: {
+		auto risk_search = std::make_unique<RiskLookaheadSearch>(state_registry, heuristic, base_heuristic, distance_heuristic, store_exploration_data, expansion_delay.get(), heuristic_error.get(), hstar_data.get(), post_expansion_belief_data.get(), belief_pool.get(), this, f_kind, pf_kind, RiskKernel(opts.get_enum("risk_kernel")));
+		if (opts.get<int>("lookahead_threads") > 1) {
+			// the lookahead evaluates the distance heuristic only if
+			// it is not the heuristic itself
+			std::shared_ptr<Evaluator> distance;
+			if (distance_heuristic != heuristic)
+				distance = opts.get<std::shared_ptr<Evaluator>>("distance_heuristic");
+			risk_search->set_parallel_evaluation(std::make_unique<ParallelEvaluation>(
+				state_registry, base_heuristic, distance,
+				opts.get<std::vector<std::shared_ptr<Evaluator>>>("lookahead_heuristic_copies"),
+				opts.get<std::vector<std::shared_ptr<Evaluator>>>("lookahead_distance_copies")));
+		}
+		sc.ls = std::move(risk_search);
 		break;
+	}
 	case LookaheadSearchMethod::ONLINE_RISK:
 		sc.ls = std::make_unique<OnlineRiskLookaheadSearch>(state_registry, heuristic, base_heuristic, distance_heuristic, store_exploration_data, expansion_delay.get(), heuristic_error.get(), this, false);
 		break;
@@ -78,6 +99,24 @@ RealTimeSearch::RealTimeSearch(const options::Options &opts)
 		utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
 	}
 
+	if (opts.get<bool>("subtree_reuse")) {
+		if (sc.lsm == LookaheadSearchMethod::ONLINE_RISK) {
+			std::cerr << "subtree_reuse is not supported by the online risk lookahead" << std::endl;
+			utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+		}
+		sc.ls->set_reuse_subtree(true, opts.get<int>("subtree_reuse_limit"));
+	}
+
+	sc.commitment = CommitmentPolicy(opts.get_enum("commitment"));
+	sc.commit_actions = opts.get<int>("commit_actions");
+	sc.action_duration = std::chrono::milliseconds(opts.get<int>("action_duration"));
+	if (sc.action_duration.count() > 0)
+		sc.speculation_worker = std::make_unique<AsyncWorker>();
+
+	open_timeline(sc.timeline, opts);
+
+	bool const async_learning = opts.get<bool>("async_learning") && sc.lm != BackupMethod::NONE;
+
 	std::cout << "initializing lookahead termination condition\n";
 	switch (BoundKind(opts.get_enum("rtbound_type"))) {
 	case BoundKind::EXPANSIONS:
@@ -94,14 +133,16 @@ RealTimeSearch::RealTimeSearch(const options::Options &opts)
 		sc.le = nullptr;
 		break;
 	case BackupMethod::DIJKSTRA:
-		sc.le = std::make_unique<DijkstraBackup>(state_registry, this, std::dynamic_pointer_cast<LearningEvaluator>(heuristic), std::dynamic_pointer_cast<LearningEvaluator>(distance_heuristic), sc.lsm != LookaheadSearchMethod::BREADTH_FIRST);
+		sc.le = std::make_unique<DijkstraBackup>(state_registry, this, std::dynamic_pointer_cast<LearningEvaluator>(heuristic), std::dynamic_pointer_cast<LearningEvaluator>(distance_heuristic), sc.lsm != LookaheadSearchMethod::BREADTH_FIRST, LearningQueue(opts.get_enum("learning_queue")));
 		break;
 	case BackupMethod::NANCY:
 		auto beliefs = sc.ls->get_beliefs();
 		auto post_beliefs = sc.ls->get_post_beliefs();
-		sc.le = std::make_unique<NancyBackup>(state_registry, this, beliefs, post_beliefs);
+		sc.le = std::make_unique<NancyBackup>(state_registry, this, beliefs, post_beliefs, sc.ls->get_distribution_table());
 		break;
 	}
+	if (async_learning)
+		sc.learning_worker = std::make_unique<AsyncWorker>();
 
 	std::cout << "initializing decision strat\n";
 	switch (sc.ds) {
@@ -17,8 +17,10 @@ SearchStatus RealTimeSearch::step() {
 	statistics.inc_generated_ops(current_stats.get_generated_ops());
 	statistics.inc_reopened(current_stats.get_reopened());
 
-	if (status == FAILED)
+	if (status == FAILED) {
+		sc.finish_step();
 		return FAILED;
+	}
 
 	if (status == SOLVED) {
 		auto overall_plan = Plan();
@@ -29,24 +31,38 @@ SearchStatus RealTimeSearch::step() {
 			solution_cost += get_adjusted_cost(task_proxy.get_operators()[op_id]);
 		overall_plan.insert(std::end(overall_plan), std::begin(plan), std::end(plan));
 		set_plan(overall_plan);
+		sc.finish_step();
 		return SOLVED;
 	}
 
-	if (sc.ls->get_frontier().empty())
+	if (sc.ls->get_frontier().empty()) {
+		sc.finish_step();
 		return FAILED;
+	}
 
 	OperatorID best_tla = sc.select_action();
 
 	sc.learn_initial();
 
+	apply_action(best_tla);
+	int committed = 1;
+	for (; sc.commit_another(committed); ++committed)
+		apply_action(sc.dec->follow_target_path());
+
+	sc.finish_step();
+	if (sc.speculation_worker)
+		sc.speculate(current_state, committed);
+	return IN_PROGRESS;
+}
+
+void RealTimeSearch::apply_action(OperatorID op_id)
+{
 	const auto parent_node = search_space.get_node(current_state);
-	const auto op = task_proxy.get_operators()[best_tla];
+	const auto op = task_proxy.get_operators()[op_id];
 	solution_cost += get_adjusted_cost(op);
 	current_state = state_registry.get_successor_state(current_state, op);
 	auto next_node = search_space.get_node(current_state);
 	if (next_node.is_new())
 		next_node.open(parent_node, op, get_adjusted_cost(op));
-
-	return IN_PROGRESS;
 }
 }
@@ -0,0 +1,61 @@
+#ifndef REAL_TIME_SAMPLE_FILE_H
+#define REAL_TIME_SAMPLE_FILE_H
+
+// Layout of the binary training sample files written by the h*
+// solvers.  This header only depends on the standard library, since
+// the aggregation tool in training/ includes it as well.
+//
+// A file starts with a SampleFileHeader, followed by fixed-width
+// records of the kind given in the header:
+//  - HStarSamples: one HStarRecord per solved state.
+//  - SuccessorSamples: per state a SuccessorRecord (h, number of
+//    successors), followed by one SuccessorRecord (action cost,
+//    successor h) per successor.
+// Files are only ever appended to, so a file of an interrupted run is
+// valid up to its last complete record (or state, for successor
+// files).
+
+#include <cstdint>
+
+namespace real_time
+{
+
+constexpr char sample_file_magic[8] = {'N', 'A', 'N', 'C', 'Y', 'S', 'M', 'P'};
+constexpr std::uint32_t sample_file_version = 1;
+
+enum SampleKind : std::uint32_t
+{
+	HStarSamples = 0,
+	SuccessorSamples = 1,
+};
+
+struct SampleFileHeader
+{
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t kind;
+	// whether the ph fields of HStarRecords hold the h value of the parent
+	std::uint32_t with_parent_h;
+	std::uint32_t reserved;
+};
+
+struct HStarRecord
+{
+	std::int32_t h;
+	std::int32_t hstar;
+	std::int32_t ph;
+};
+
+struct SuccessorRecord
+{
+	std::int32_t first;
+	std::int32_t second;
+};
+
+static_assert(sizeof(SampleFileHeader) == 24, "unexpected sample file header size");
+static_assert(sizeof(HStarRecord) == 12, "unexpected h* record size");
+static_assert(sizeof(SuccessorRecord) == 8, "unexpected successor record size");
+
+}
+
+#endif
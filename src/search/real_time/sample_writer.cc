@@ -0,0 +1,132 @@
+#include "sample_writer.h"
+
+#include "../options/option_parser.h"
+#include "../options/options.h"
+#include "../utils/system.h"
+
+#include <cassert>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+
+namespace real_time
+{
+
+static constexpr std::size_t buffer_size = 1 << 16;
+
+SampleWriter::SampleWriter(std::string const &file_name, SampleFormat format, SampleKind kind, bool with_parent_h)
+	: file_name(file_name),
+	  format(format),
+	  kind(kind),
+	  with_parent_h(with_parent_h),
+	  file(std::fopen(file_name.c_str(), format == SampleFormat::BINARY ? "wb" : "w")),
+	  num_records(0)
+{
+	if (!file) {
+		std::cerr << "error: could not open " << file_name << " for writing" << std::endl;
+		utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+	}
+	buffer.reserve(buffer_size);
+	if (format == SampleFormat::BINARY) {
+		SampleFileHeader header = {};
+		std::memcpy(header.magic, sample_file_magic, sizeof(header.magic));
+		header.version = sample_file_version;
+		header.kind = kind;
+		header.with_parent_h = with_parent_h;
+		append(&header, sizeof(header));
+	}
+}
+
+SampleWriter::~SampleWriter()
+{
+	flush();
+	std::fclose(file);
+}
+
+void SampleWriter::append(void const *data, std::size_t size)
+{
+	char const *bytes = static_cast<char const *>(data);
+	buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+void SampleWriter::append(int value)
+{
+	char digits[16];
+	auto const result = std::to_chars(digits, digits + sizeof(digits), value);
+	buffer.insert(buffer.end(), digits, result.ptr);
+}
+
+void SampleWriter::flush_buffer()
+{
+	if (buffer.empty())
+		return;
+	if (std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+		std::cerr << "error: could not write to " << file_name << std::endl;
+		utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+	}
+	buffer.clear();
+}
+
+void SampleWriter::flush()
+{
+	flush_buffer();
+	std::fflush(file);
+}
+
+void SampleWriter::write_hstar(int h, int hstar, int ph)
+{
+	assert(kind == HStarSamples);
+	if (format == SampleFormat::BINARY) {
+		HStarRecord const record = {h, hstar, with_parent_h ? ph : h};
+		append(&record, sizeof(record));
+	} else {
+		append(h);
+		buffer.push_back(' ');
+		append(hstar);
+		if (with_parent_h) {
+			buffer.push_back(' ');
+			append(ph);
+		}
+		buffer.push_back('\n');
+	}
+	++num_records;
+	if (buffer.size() >= buffer_size)
+		flush();
+}
+
+void SampleWriter::write_successors(int h, std::vector<std::pair<int, int>> const &successors)
+{
+	assert(kind == SuccessorSamples);
+	if (format == SampleFormat::BINARY) {
+		SuccessorRecord const state = {h, static_cast<std::int32_t>(successors.size())};
+		append(&state, sizeof(state));
+		for (auto const &[cost, succ_h] : successors) {
+			SuccessorRecord const successor = {cost, succ_h};
+			append(&successor, sizeof(successor));
+		}
+	} else {
+		append(h);
+		for (auto const &[cost, succ_h] : successors) {
+			buffer.push_back(' ');
+			append(cost);
+			buffer.push_back(' ');
+			append(succ_h);
+		}
+		buffer.push_back('\n');
+	}
+	++num_records;
+	if (buffer.size() >= buffer_size)
+		flush();
+}
+
+void add_sample_format_option(options::OptionParser &parser)
+{
+	parser.add_enum_option("sample_format", {"TEXT", "BINARY"}, "Format of the sample files (TEXT is read by the combine_*.py scripts, BINARY by training/merge_samples)", "TEXT");
+}
+
+SampleFormat get_sample_format(options::Options const &opts)
+{
+	return SampleFormat(opts.get_enum("sample_format"));
+}
+
+}
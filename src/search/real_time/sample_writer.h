@@ -0,0 +1,70 @@
+#ifndef REAL_TIME_SAMPLE_WRITER_H
+#define REAL_TIME_SAMPLE_WRITER_H
+
+#include "sample_file.h"
+
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace options {
+class OptionParser;
+class Options;
+}
+
+namespace real_time
+{
+
+enum class SampleFormat
+{
+	TEXT,
+	BINARY,
+};
+
+// Streams training samples to a file while the solver runs, instead of
+// keeping them all in memory until the end.  Samples are collected in
+// a small buffer that is written out whenever it is full, so a run
+// that is killed loses at most one buffer of samples.
+//
+// The text format is the one read by the combine_*.py scripts, the
+// binary format is described in sample_file.h and read by
+// training/merge_samples.
+class SampleWriter
+{
+	std::string file_name;
+	SampleFormat format;
+	SampleKind kind;
+	bool with_parent_h;
+	std::FILE *file;
+	std::vector<char> buffer;
+	long long num_records;
+
+	void append(void const *data, std::size_t size);
+	void append(int value);
+	void flush_buffer();
+public:
+	SampleWriter(std::string const &file_name, SampleFormat format, SampleKind kind, bool with_parent_h = false);
+	~SampleWriter();
+
+	SampleWriter(SampleWriter const &) = delete;
+	SampleWriter &operator=(SampleWriter const &) = delete;
+
+	// ph is only written if the writer was created with_parent_h
+	void write_hstar(int h, int hstar, int ph);
+	// successors are pairs of action cost and successor h
+	void write_successors(int h, std::vector<std::pair<int, int>> const &successors);
+
+	// writes out the buffer and makes it visible to other processes
+	void flush();
+
+	std::string const &get_file_name() const { return file_name; }
+	long long get_num_records() const { return num_records; }
+};
+
+void add_sample_format_option(options::OptionParser &parser);
+SampleFormat get_sample_format(options::Options const &opts);
+
+}
+
+#endif
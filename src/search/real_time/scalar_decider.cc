@@ -13,10 +13,9 @@ OperatorID ScalarDecider::decide(const std::vector<StateID> &frontier, SearchSpa
 		[this, &search_space](const auto &lhs, const auto &rhs) {
 			return evaluator(lhs, search_space) < evaluator(rhs, search_space);
 		});
-	auto plan = Plan();
-	search_space.trace_path_rev(state_registry.lookup_state(*best_state_id), plan);
-	assert(!plan.empty());
-	return plan.back();
+	target_path.clear();
+	search_space.trace_path_rev(state_registry.lookup_state(*best_state_id), target_path);
+	return follow_target_path();
 }
 
 }
@@ -3,10 +3,10 @@
 #include <numeric>   // accumulate
 #include <algorithm> // sort
 #include <chrono>    // the search control itself also measures time
+#include <thread>
 #include <tuple>
 
 #include "vec_stats.h"
-#include "lap_timer.h"
 
 namespace real_time
 {
@@ -20,32 +20,114 @@ SearchCtrl::SearchCtrl(GlobalState const &s, LookaheadSearchMethod lsm, BackupMe
 	  le(nullptr),
 	  ds(ds),
 	  dec(nullptr),
-	  learning_done(true)
+	  catchups(0),
+	  abandoned_learnings(0),
+	  learning_done(true),
+	  learning_worker(nullptr),
+	  learning_pending(false),
+	  learning_waits(0),
+	  learning_wait_time(0),
+	  learning_time(0),
+	  learning_effort(0),
+	  commitment(CommitmentPolicy::SINGLE),
+	  commit_actions(1),
+	  num_committed(0),
+	  action_duration(0),
+	  speculation_worker(nullptr),
+	  stop_speculation(false),
+	  speculation_pending(false),
+	  speculated_state(StateID::no_state),
+	  resumed_status(IN_PROGRESS),
+	  speculations(0),
+	  speculation_hits(0),
+	  speculative_expansions(0),
+	  speculation_time(0)
 {
-	durations.reserve(1 << 18); // 262144, should be plenty for most instances
 }
-SearchCtrl::~SearchCtrl() {}
 
-void SearchCtrl::initialize_lookahead(GlobalState const &s)
+SearchCtrl::~SearchCtrl()
 {
-	if (!learning_done) {
-		learn_catch_up();
-	}
+	stop_speculating();
+}
 
-	cs = &s;
-	ls->initialize(s);
+void SearchCtrl::initialize_lookahead(GlobalState const &s)
+{
 	assert(lb != nullptr);
+	bool const adopted = finish_speculation(s);
+	timeline.start_step();
+	lb->start_step();
+	if (!adopted) {
+		if (!learning_done) {
+			learn_catch_up(false);
+			timeline.end_phase(StepTimeline::LEARNING);
+		}
+
+		cs = &s;
+		ls->initialize(s);
+	}
+	reset_times.push_back(ls->get_reset_time().count());
 	lb->initialize(*ls);
 }
 
+void SearchCtrl::speculate(GlobalState const &s, int num_actions)
+{
+	assert(speculation_worker && !speculation_pending);
+	execution_start = std::chrono::steady_clock::now();
+	execution_end = execution_start + num_actions * action_duration;
+	speculated_state = s.get_id();
+	stop_speculation = false;
+	speculation_pending = true;
+	++speculations;
+	// the search thread leaves the lookahead (and with it the state
+	// registry and the heuristics) alone until the job is stopped
+	speculation_worker->start([this, &s]() {
+		auto const start = std::chrono::steady_clock::now();
+		if (!learning_done)
+			learn_catch_up(true);
+		cs = &s;
+		ls->initialize(s);
+		auto res = IN_PROGRESS;
+		while (!stop_speculation && res == IN_PROGRESS)
+			res = ls->step();
+		resumed_status = res;
+		speculation_time += std::chrono::steady_clock::now() - start;
+	});
+}
+
+bool SearchCtrl::finish_speculation(GlobalState const &s)
+{
+	if (!speculation_pending)
+		return false;
+	std::this_thread::sleep_until(execution_end);
+	stop_speculating();
+	lb->pause(std::chrono::steady_clock::now() - execution_start);
+	if (s.get_id() != speculated_state) {
+		resumed_status = IN_PROGRESS;
+		return false;
+	}
+	++speculation_hits;
+	speculative_expansions += ls->get_statistics().get_expanded() - 1;
+	return true;
+}
+
+void SearchCtrl::stop_speculating()
+{
+	if (!speculation_pending)
+		return;
+	stop_speculation = true;
+	speculation_worker->wait();
+	speculation_pending = false;
+}
+
 SearchStatus SearchCtrl::search()
 {
-	SearchStatus res = IN_PROGRESS;
+	SearchStatus res = resumed_status;
+	resumed_status = IN_PROGRESS;
 	while (lb->lookahead_ok() && res == IN_PROGRESS) {
-		ls->next_lap();
 		res = ls->step();
-		auto dur = ls->stop_lap();
 	}
+	lb->lookahead_finished();
+	timeline.end_phase(StepTimeline::LOOKAHEAD);
 	expansions.push_back(ls->get_statistics().get_expanded());
 	switch (res) {
 	case FAILED:        return FAILED;
@@ -61,37 +143,131 @@ SearchStatus SearchCtrl::search()
 }
 
 
-void SearchCtrl::learn_catch_up()
+void SearchCtrl::learn_catch_up(bool speculative)
 {
-	while (lb->learning_ok() && !le->done()) {
+	++catchups;
+	auto const start = std::chrono::steady_clock::now();
+	while (!le->done() && (speculative ? !stop_speculation : lb->catch_up_ok())) {
 		le->step();
 	}
+	// the next lookahead reuses the arena, so whatever is left of
+	// the phase is given up
+	if (!le->done()) {
+		le->abandon();
+		++abandoned_learnings;
+	}
+	learning_time += std::chrono::steady_clock::now() - start;
+	learning_done = true;
 }
 
 void SearchCtrl::learn_initial()
 {
+	lb->learning_started();
+	if (learning_worker)
+		learn_async();
+	else
+		learn_sync();
+	lb->learning_finished();
+	timeline.end_phase(StepTimeline::LEARNING);
+}
+
+void SearchCtrl::learn_sync()
+{
+	auto const start = std::chrono::steady_clock::now();
 	// build up the learning queue
-	le->initialize(ls->get_predecessors(), ls->get_frontier(), ls->get_closed());
+	le->initialize(ls->get_arena(), ls->get_frontier());
+	learning_effort += le->effort();
 
 	while (lb->learning_ok() && !le->done()) {
 		le->step();
 	}
+	learning_time += std::chrono::steady_clock::now() - start;
 	learning_done = le->done();
 }
 
+void SearchCtrl::learn_async()
+{
+	// the previous phase has to be published first, since this
+	// phase builds on the values it learned
+	finish_learning();
+	auto const start = std::chrono::steady_clock::now();
+	le->snapshot(ls->get_arena(), ls->get_frontier());
+	learning_effort += le->effort();
+	learning_time += std::chrono::steady_clock::now() - start;
+	learning_pending = true;
+	// learning_time is not touched by the search thread until the
+	// job is done
+	learning_worker->start([this]() {
+		auto const start = std::chrono::steady_clock::now();
+		le->run();
+		learning_time += std::chrono::steady_clock::now() - start;
+	});
+}
+
+void SearchCtrl::finish_learning()
+{
+	if (!learning_pending)
+		return;
+	auto const start = std::chrono::steady_clock::now();
+	if (learning_worker->wait()) {
+		++learning_waits;
+		learning_wait_time += std::chrono::steady_clock::now() - start;
+	}
+	le->publish();
+	learning_pending = false;
+}
+
 OperatorID SearchCtrl::select_action()
 {
-	return dec->decide(ls->get_frontier(), ls->get_search_space());
+	auto const op = dec->decide(ls->get_frontier(), ls->get_search_space());
+	timeline.end_phase(StepTimeline::DECISION);
+	return op;
+}
+
+bool SearchCtrl::commit_another(int committed)
+{
+	if (dec->target_path.empty())
+		return false;
+	bool commit = false;
+	switch (commitment) {
+	case CommitmentPolicy::SINGLE:
+		break;
+	case CommitmentPolicy::FIXED:
+		commit = committed < commit_actions;
+		break;
+	case CommitmentPolicy::TARGET:
+		commit = true;
+		break;
+	case CommitmentPolicy::DYNAMIC:
+		commit = lb->behind_schedule();
+		break;
+	}
+	if (commit) {
+		++num_committed;
+		lb->action_committed();
+	}
+	return commit;
+}
+
+void SearchCtrl::finish_step()
+{
+	timeline.end_step(expansions.back());
 }
 
 void SearchCtrl::prepare_statistics()
 {
+	// the search may have ended during a speculative lookahead, e.g.
+	// by running out of time
+	stop_speculating();
 	std::sort(expansions.begin(), expansions.end());
+	std::sort(reset_times.begin(), reset_times.end());
+	timeline.flush();
 }
 
 void SearchCtrl::print_statistics() const
 {
 	ls->print_statistics();
+	lb->print_statistics();
 
 	auto estats = vec_stats(expansions);
 
@@ -99,7 +275,39 @@ void SearchCtrl::print_statistics() const
 		  << "Minimum number of expansions: " << estats.min << "\n"
 		  << "Maximum number of expansions: " << estats.max << "\n"
 		  << "Median expansions: " << estats.med << "\n"
-		  << "Number of catchup learning phases: " << catchups << "\n";
+		  << "Number of catchup learning phases: " << catchups << "\n"
+		  << "Number of abandoned learning phases: " << abandoned_learnings << "\n";
+	if (commitment != CommitmentPolicy::SINGLE)
+		std::cout << "Actions committed without a lookahead: " << num_committed << "\n";
+	if (ls->reuses_subtree())
+		std::cout << "Replayed expansions: " << ls->get_num_replayed() << "\n";
+	if (speculation_worker) {
+		std::cout << "Speculative lookaheads: " << speculations << "\n"
+			  << "Speculative lookaheads adopted: " << speculation_hits << "\n"
+			  << "Speculative expansions adopted: " << speculative_expansions << "\n"
+			  << "Time spent on speculative lookaheads: "
+			  << std::chrono::duration_cast<std::chrono::microseconds>(speculation_time).count() << "us\n";
+	}
+	timeline.print_statistics();
+
+	if (le) {
+		auto const learning_us = std::chrono::duration_cast<std::chrono::microseconds>(learning_time).count();
+		std::cout << "Total learning time: " << learning_us << "us\n"
+			  << "States handed to learning: " << learning_effort << "\n";
+		if (learning_us > 0)
+			std::cout << "Learning throughput: " << learning_effort * 1000000 / learning_us << " states/s\n";
+	}
+	if (learning_worker) {
+		std::cout << "Number of waits for asynchronous learning: " << learning_waits << "\n"
+			  << "Total wait time for asynchronous learning: "
+			  << std::chrono::duration_cast<std::chrono::microseconds>(learning_wait_time).count() << "us\n";
+	}
+
+	if (!reset_times.empty()) {
+		auto rstats = vec_stats(reset_times);
+		std::cout << "Average lookahead reset time: " << rstats.avg << "ns\n"
+			  << "Maximum lookahead reset time: " << rstats.max << "ns\n";
+	}
 }
 
 }
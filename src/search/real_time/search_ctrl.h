@@ -1,17 +1,21 @@
 #ifndef REALTIME_SEARCH_CTRL_H
 #define REALTIME_SEARCH_CTRL_H
 
+#include <atomic>
+#include <chrono>
 #include <memory>
 
 #include <vector>
 
 #include "../search_engine.h" // for SearchStatus
 
+#include "async_worker.h"
 #include "kinds.h"
 #include "bound.h"
 #include "lookhead_search.h"
 #include "learning.h"
 #include "decision.h"
+#include "step_timeline.h"
 
 namespace real_time
 {
@@ -35,28 +39,102 @@ struct SearchCtrl
 	// expansions in each lookahead phase.  interesting to look at
 	// when a time bound is used.
 	std::vector<int> expansions;
-	// debug statistics.  this vector collects the times of each
-	// expansion iteration in the lookahead phase.  how often did
-	// we run out of time during learning
-	std::vector<std::chrono::milliseconds::rep> durations;
+	// timings of each step, split into its phases
+	StepTimeline timeline;
+	// debug statistics.  this vector collects the time it took to
+	// reset the lookahead search at the start of each iteration.
+	std::vector<std::chrono::nanoseconds::rep> reset_times;
 	// debug statistics.  this counts how often the algorithm ran
 	// out of time during the learning phase.  With the current
 	// default settings, this is pretty much always zero.
 	int catchups;
+	// debug statistics.  catchup phases that ran out of time as
+	// well, see Learning::abandon.
+	int abandoned_learnings;
 
 	// we select an action first, then do the learning. if we
-	// couldn't finish it, we gotta do it next iteration before
-	// the lookahead phase.
+	// couldn't finish it, we catch up on it next iteration before
+	// the lookahead phase, as far as the bound allows.
 	bool learning_done;
 
+	// if set, learning runs on this thread while the next lookahead
+	// goes on, see Learning::snapshot.  The results of a learning
+	// phase are published right before the next learning phase, so
+	// each lookahead sees the values learned up to the phase before
+	// the previous one.  Declared after le, so the worker is done
+	// before the learning method goes away.
+	std::unique_ptr<AsyncWorker> learning_worker;
+	bool learning_pending;
+	// debug statistics.  how often and how long the search had to
+	// wait for the learning thread.
+	int learning_waits;
+	std::chrono::nanoseconds learning_wait_time;
+	// debug statistics.  time spent learning (including the
+	// snapshots for asynchronous learning) and the number of closed
+	// states the learning phases started with.
+	std::chrono::nanoseconds learning_time;
+	long long learning_effort;
+
+	// how many actions to take per lookahead, see commit_another
+	CommitmentPolicy commitment;
+	int commit_actions;
+	// debug statistics.  actions taken without a lookahead of their
+	// own.
+	long long num_committed;
+
+	// Speculative lookahead.  If action_duration is positive, the
+	// agent is taken to spend that long on executing each action,
+	// and the lookahead of the next step starts on speculation_worker
+	// from the state the actions lead to as soon as the step is done.
+	// When the next step starts (once the actions are executed), the
+	// lookahead is stopped and either adopted, if the agent is in the
+	// predicted state, or thrown away.  An adopted lookahead goes on
+	// with a full budget of its own.
+	std::chrono::nanoseconds action_duration;
+	std::unique_ptr<AsyncWorker> speculation_worker;
+	std::atomic<bool> stop_speculation;
+	bool speculation_pending;
+	StateID speculated_state;
+	std::chrono::steady_clock::time_point execution_start;
+	std::chrono::steady_clock::time_point execution_end;
+	// the status of the adopted lookahead, which is where search()
+	// picks up
+	SearchStatus resumed_status;
+	// debug statistics
+	int speculations;
+	int speculation_hits;
+	long long speculative_expansions;
+	std::chrono::nanoseconds speculation_time;
+
 	SearchCtrl(GlobalState const &s, LookaheadSearchMethod lsm, BackupMethod lm, DecisionStrategy ds);
 	virtual ~SearchCtrl();
 
 	void initialize_lookahead(GlobalState const &s);
 	SearchStatus search();
 	void learn_initial();
-	void learn_catch_up();
+	// speculative tells that the catch up runs on the speculation
+	// thread, where it stops with the speculation instead of going
+	// by the bound
+	void learn_catch_up(bool speculative);
+	void learn_sync();
+	void learn_async();
+	void finish_learning();
+	// starts the lookahead from the state the actions taken in this
+	// step lead to
+	void speculate(GlobalState const &s, int num_actions);
+	// waits until the actions are executed and tells whether the
+	// speculative lookahead is adopted
+	bool finish_speculation(GlobalState const &s);
+	void stop_speculating();
 	OperatorID select_action();
+	// Whether to take another action from the decision's target path
+	// after having taken the given number of actions in this step.
+	// SINGLE takes one action per lookahead, FIXED up to
+	// commit_actions, TARGET all the way to the target, and DYNAMIC
+	// takes more while the bound is behind schedule.
+	bool commit_another(int committed);
+	// called at the end of every step, after the transition
+	void finish_step();
 
 	void prepare_statistics();
 	void print_statistics() const;
@@ -26,7 +26,8 @@ SolveAll::SolveAll(Options const &opts)
     reserved_time(opts.get<double>("reserved_time")),
     timer(std::numeric_limits<double>::infinity()),
     hstar_file(opts.get<std::string>("hstar_file")),
-    successors_file(opts.get<std::string>("successors_file"))
+    successors_file(opts.get<std::string>("successors_file")),
+    sample_format(real_time::get_sample_format(opts))
 {
 }
 
@@ -259,54 +260,56 @@ SearchStatus SolveAll::step()
     }
   }
 
-  // dump hstar values
-  {
-    std::cout << "dumping h* values\n";
-    auto out = std::ofstream(hstar_file);
-    for (const StateID sid : expanded_states) {
-      auto h_it = hs.find(sid);
-      if (h_it == hs.end()) {
-        std::cerr << "unknown h value for state\n";
-        continue;
-      }
-      int h = h_it->second;
-      auto hstar_it = hstars.find(sid);
-      if (hstar_it == hstars.end()) {
-        //std::cerr << "unknown hstar value for state\n";
-        continue;
-      }
-      int hstar = hstar_it->second;
-      out << h << " " << hstar << '\n';
+  dump_hstar_values();
+  compute_and_dump_successors_data();
+
+  return SOLVED;
+}
+
+void SolveAll::dump_hstar_values() const
+{
+  std::cout << "dumping h* values\n";
+  real_time::SampleWriter out(hstar_file, sample_format, real_time::HStarSamples);
+  for (const StateID &sid : expanded_states) {
+    auto h_it = hs.find(sid);
+    if (h_it == hs.end()) {
+      std::cerr << "unknown h value for state\n";
+      continue;
     }
-    out.close();
-    std::cout << "dumped h* values to " << hstar_file << "\n";
+    int h = h_it->second;
+    auto hstar_it = hstars.find(sid);
+    if (hstar_it == hstars.end()) {
+      //std::cerr << "unknown hstar value for state\n";
+      continue;
+    }
+    int hstar = hstar_it->second;
+    out.write_hstar(h, hstar, h);
   }
+  std::cout << "dumped h* values to " << hstar_file << "\n";
+}
 
-  // dump successor values
-  {
-    std::cout << "dumping successor h* values\n";
-    auto out = std::ofstream(successors_file);
-    std::vector<OperatorID> apps;
-    auto const &ops = task_proxy.get_operators();
-    for (auto const &s : expanded_states) {
-      int h = hs[s];
-      // int hstar = hstars[s];
-      auto state = state_registry.lookup_state(s);
-      apps.clear();
-      successor_generator.generate_applicable_ops(state, apps);
-      out << h;
-      for (auto const op_id : apps) {
-        auto const &op = ops[op_id];
-        auto const &succ = state_registry.get_successor_state(state, op);
-        out << " " << get_adjusted_cost(op) << " " << hs[succ.get_id()];
-      }
-      out << "\n";
+void SolveAll::compute_and_dump_successors_data()
+{
+  std::cout << "dumping successor h* values\n";
+  real_time::SampleWriter out(successors_file, sample_format, real_time::SuccessorSamples);
+  std::vector<OperatorID> apps;
+  std::vector<std::pair<int, int>> successors;
+  auto const &ops = task_proxy.get_operators();
+  for (auto const &s : expanded_states) {
+    int h = hs[s];
+    // int hstar = hstars[s];
+    auto state = state_registry.lookup_state(s);
+    apps.clear();
+    successor_generator.generate_applicable_ops(state, apps);
+    successors.clear();
+    for (auto const op_id : apps) {
+      auto const &op = ops[op_id];
+      auto const &succ = state_registry.get_successor_state(state, op);
+      successors.emplace_back(get_adjusted_cost(op), hs[succ.get_id()]);
     }
-    out.close();
-    std::cout << "dumped successor h* values to " << successors_file << "\n";
+    out.write_successors(h, successors);
   }
-
-  return SOLVED;
+  std::cout << "dumped successor h* values to " << successors_file << "\n";
 }
 
 static std::shared_ptr<SearchEngine> _parse(options::OptionParser &parser)
@@ -328,6 +331,7 @@ static std::shared_ptr<SearchEngine> _parse(options::OptionParser &parser)
 	parser.add_option<std::string>("hstar_file", "file name to dump h* values", "hstar_values.txt");
 	parser.add_option<std::string>("successors_file", "file name to dump post-expansion data", "successors_data.txt");
 	parser.add_option<double>("reserved_time", "reserved time to dump data", "0", Bounds("0", ""));
+	real_time::add_sample_format_option(parser);
 
 	SearchEngine::add_pruning_option(parser);
 	SearchEngine::add_options_to_parser(parser);
@@ -1,6 +1,8 @@
 #ifndef REAL_TIME_SOLVE_ALL_H
 #define REAL_TIME_SOLVE_ALL_H
 
+#include "sample_writer.h"
+
 #include "../options/options.h"
 #include "../open_list.h"
 #include "../search_engine.h"
@@ -46,6 +48,7 @@ class SolveAll : public SearchEngine
 	utils::CountdownTimer timer;
 	const std::string hstar_file;
   const std::string successors_file;
+  const real_time::SampleFormat sample_format;
 
 	void dump_hstar_values() const;
 	void compute_and_dump_successors_data();
@@ -42,9 +42,11 @@ void EagerCollector::mark_expanded(SearchNode &node)
 	collect(node.get_state_id());
 	node.close();
 	if (store_exploration_data)
-		closed.emplace(node.get_state_id());
+		arena.close(node.get_state_id());
+	if (reuse_subtree)
+		expansion_order.push_back(node.get_state_id());
 	if (expansion_delay)
-		expansion_delay->update_expansion_delay(statistics->get_expanded() - open_list_insertion_time[node.get_state_id()]);
+		expansion_delay->update_expansion_delay(statistics->get_expanded() - arena.get_insertion_time(node.get_state_id()));
 }
 
 AStarCollect::AStarCollect(StateRegistry &state_registry, std::shared_ptr<Evaluator> heuristic, bool store_exploration_data, ExpansionDelay *expansion_delay, HeuristicError *heuristic_error, SearchEngine const *search_engine) :
@@ -0,0 +1,132 @@
+#include "step_timeline.h"
+
+#include "../options/option_parser.h"
+#include "../options/options.h"
+#include "../utils/system.h"
+
+#include <cctype>
+#include <iostream>
+
+namespace real_time
+{
+
+static char const *const phase_names[StepTimeline::NUM_PHASES] = {
+	"lookahead", "decision", "learning", "transition"
+};
+
+static long long nanoseconds(StepTimeline::Clock::duration d)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+}
+
+StepTimeline::StepTimeline()
+	: phase_times{},
+	  num_steps(0),
+	  format(TimelineFormat::JSONL)
+{
+}
+
+void StepTimeline::open(std::string const &file_name, TimelineFormat format)
+{
+	this->file_name = file_name;
+	this->format = format;
+	out.open(file_name);
+	if (!out) {
+		std::cerr << "error: could not open " << file_name << " for writing" << std::endl;
+		utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+	}
+	if (format == TimelineFormat::CSV) {
+		out << "step,start_ns,expansions";
+		for (auto const name : phase_names)
+			out << "," << name << "_ns";
+		out << ",total_ns\n";
+	}
+}
+
+void StepTimeline::start_step()
+{
+	step_start = Clock::now();
+	if (num_steps == 0)
+		origin = step_start;
+	mark = step_start;
+	phase_times.fill(Clock::duration::zero());
+}
+
+void StepTimeline::end_phase(Phase phase)
+{
+	auto const now = Clock::now();
+	phase_times[phase] += now - mark;
+	mark = now;
+}
+
+void StepTimeline::end_step(int expansions)
+{
+	end_phase(TRANSITION);
+	++num_steps;
+	for (int i = 0; i < NUM_PHASES; ++i)
+		phase_histograms[i].record(nanoseconds(phase_times[i]));
+	auto const step_time = mark - step_start;
+	step_histogram.record(nanoseconds(step_time));
+	if (out.is_open())
+		write_line(expansions, step_time);
+}
+
+void StepTimeline::write_line(int expansions, Clock::duration step_time)
+{
+	if (format == TimelineFormat::CSV) {
+		out << num_steps << "," << nanoseconds(step_start - origin) << "," << expansions;
+		for (auto const &time : phase_times)
+			out << "," << nanoseconds(time);
+		out << "," << nanoseconds(step_time) << "\n";
+	} else {
+		out << "{\"step\":" << num_steps
+		    << ",\"start_ns\":" << nanoseconds(step_start - origin)
+		    << ",\"expansions\":" << expansions;
+		for (int i = 0; i < NUM_PHASES; ++i)
+			out << ",\"" << phase_names[i] << "_ns\":" << nanoseconds(phase_times[i]);
+		out << ",\"total_ns\":" << nanoseconds(step_time) << "}\n";
+	}
+}
+
+void StepTimeline::flush()
+{
+	if (!out.is_open())
+		return;
+	out.flush();
+	if (!out) {
+		std::cerr << "error: could not write to " << file_name << std::endl;
+		utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+	}
+}
+
+void StepTimeline::print_statistics() const
+{
+	if (num_steps == 0)
+		return;
+	std::cout << "Step latency: ";
+	step_histogram.print(std::cout);
+	std::cout << "\n";
+	for (int i = 0; i < NUM_PHASES; ++i) {
+		std::string name = phase_names[i];
+		name[0] = std::toupper(name[0]);
+		std::cout << name << " latency: ";
+		phase_histograms[i].print(std::cout);
+		std::cout << "\n";
+	}
+	if (out.is_open())
+		std::cout << "Timeline written to " << file_name << "\n";
+}
+
+void add_timeline_options(options::OptionParser &parser)
+{
+	parser.add_option<std::string>("timeline_file", "file to write the timings of every step to, one line per step", options::OptionParser::NONE);
+	parser.add_enum_option("timeline_format", {"JSONL", "CSV"}, "Format of the timeline file", "JSONL");
+}
+
+void open_timeline(StepTimeline &timeline, options::Options const &opts)
+{
+	if (opts.contains("timeline_file"))
+		timeline.open(opts.get<std::string>("timeline_file"), TimelineFormat(opts.get_enum("timeline_format")));
+}
+
+}
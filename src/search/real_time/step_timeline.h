@@ -0,0 +1,80 @@
+#ifndef REAL_TIME_STEP_TIMELINE_H
+#define REAL_TIME_STEP_TIMELINE_H
+
+#include "latency_histogram.h"
+
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <string>
+
+namespace options {
+class OptionParser;
+class Options;
+}
+
+namespace real_time
+{
+
+enum class TimelineFormat
+{
+	JSONL,
+	CSV,
+};
+
+// Times every step of the real-time search, split into phases that
+// are measured back to back: the time since the last phase ended goes
+// to the phase that ends.  Catching up on learning counts as learning,
+// the post-processing of the lookahead (e.g. the risk analysis) as
+// decision.  The durations go into a latency histogram per phase and
+// one for the whole step, and optionally into a timeline file with
+// one line per step.
+class StepTimeline
+{
+public:
+	enum Phase
+	{
+		LOOKAHEAD,
+		DECISION,
+		LEARNING,
+		TRANSITION,
+		NUM_PHASES,
+	};
+	using Clock = std::chrono::steady_clock;
+
+private:
+	Clock::time_point origin;
+	Clock::time_point step_start;
+	Clock::time_point mark;
+	std::array<Clock::duration, NUM_PHASES> phase_times;
+	std::array<LatencyHistogram, NUM_PHASES> phase_histograms;
+	LatencyHistogram step_histogram;
+	long long num_steps;
+
+	std::string file_name;
+	TimelineFormat format;
+	std::ofstream out;
+
+	void write_line(int expansions, Clock::duration step_time);
+public:
+	StepTimeline();
+
+	// starts writing the timeline to the file
+	void open(std::string const &file_name, TimelineFormat format);
+
+	void start_step();
+	void end_phase(Phase phase);
+	// ends the transition phase, which is the rest of the step
+	void end_step(int expansions);
+
+	void flush();
+	void print_statistics() const;
+};
+
+void add_timeline_options(options::OptionParser &parser);
+// opens the timeline file if the options ask for one
+void open_timeline(StepTimeline &timeline, options::Options const &opts);
+
+}
+
+#endif
@@ -20,7 +20,7 @@ VecStats<T> vec_stats(std::vector<T> const &v)
 	const auto s = static_cast<long>(v.size());
 	assert(s > 0);
 	VecStats<T> r;
-	r.avg = std::accumulate(v.begin(), v.end(), 0) / s;
+	r.avg = std::accumulate(v.begin(), v.end(), T()) / s;
 	r.min = v[0];
 	r.max = v[s-1];
 	r.med = ((s & 1) == 0) ? (v[(s/2)-1] + v[s/2]) / 2 : v[s/2];
@@ -23,12 +23,13 @@ using utils::ExitCode;
 
 class PruningMethod;
 
-successor_generator::SuccessorGenerator &get_successor_generator(const TaskProxy &task_proxy) {
+static successor_generator::SuccessorGenerator &build_successor_generator(
+    const TaskProxy &task_proxy, successor_generator::GeneratorKind kind) {
     cout << "Building successor generator..." << flush;
     int peak_memory_before = utils::get_peak_memory_in_kb();
     utils::Timer successor_generator_timer;
     successor_generator::SuccessorGenerator &successor_generator =
-        successor_generator::g_successor_generators[task_proxy];
+        successor_generator::get_successor_generator(task_proxy, kind);
     successor_generator_timer.stop();
     cout << "done! [t=" << utils::g_timer << "]" << endl;
     int peak_memory_after = utils::get_peak_memory_in_kb();
@@ -45,8 +46,11 @@ SearchEngine::SearchEngine(const Options &opts)
       solution_found(false),
       task(tasks::g_root_task),
       task_proxy(*task),
-      state_registry(task_proxy),
-      successor_generator(get_successor_generator(task_proxy)),
+      state_registry(task_proxy, opts.get<bool>("incremental_hashing")),
+      successor_generator(build_successor_generator(
+                              task_proxy,
+                              static_cast<successor_generator::GeneratorKind>(
+                                  opts.get_enum("successor_generator")))),
       search_space(state_registry),
       cost_type(static_cast<OperatorCost>(opts.get_enum("cost_type"))),
       is_unit_cost(task_properties::is_unit_cost(task_proxy)),
@@ -151,6 +155,20 @@ void SearchEngine::add_options_to_parser(OptionParser &parser) {
         "experiments. Timed-out searches are treated as failed searches, "
         "just like incomplete search algorithms that exhaust their search space.",
         "infinity");
+    parser.add_option<bool>(
+        "incremental_hashing",
+        "hash registered states with Zobrist keys, updating the hash of a "
+        "successor from its predecessor instead of rehashing the whole state. "
+        "Costs 4 bytes per state and pays off for tasks with many variables.",
+        "false");
+    parser.add_enum_option(
+        "successor_generator",
+        {"TREE", "FLAT", "BITSET"},
+        "representation of the successor generator. All of them generate "
+        "the same operators in the same order. TREE: a tree of polymorphic "
+        "nodes. FLAT: the same tree in one array. BITSET: intersects "
+        "per-fact operator bitsets; falls back to FLAT if they would be large.",
+        "TREE");
 }
 
 /* Method doesn't belong here because it's only useful for certain derived classes.
@@ -64,10 +64,13 @@ public:
     bool found_solution() const;
     SearchStatus get_status() const;
     const Plan &get_plan() const;
-    void search();
+    virtual void search();
     const SearchStatistics &get_statistics() const {return statistics;}
     void set_bound(int b) {bound = b;}
     int get_bound() {return bound;}
+    const successor_generator::SuccessorGenerator &get_successor_generator() const {
+        return successor_generator;
+    }
     int get_adjusted_cost(const OperatorProxy &op) const;
 	virtual std::unique_ptr<std::unordered_set<StateID> > get_expanded_states() { assert(0); return nullptr; }
     OperatorsProxy get_operators() const {return task_proxy.get_operators(); };
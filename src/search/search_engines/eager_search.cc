@@ -20,6 +20,7 @@ namespace eager_search {
 EagerSearch::EagerSearch(const Options &opts)
     : SearchEngine(opts),
       reopen_closed_nodes(opts.get<bool>("reopen_closed")),
+      expansion_batch(opts.get<int>("expansion_batch")),
       open_list(opts.get<shared_ptr<OpenListFactory>>("open")->
                 create_state_open_list()),
       f_evaluator(opts.get<shared_ptr<Evaluator>>("f_eval", nullptr)),
@@ -37,6 +38,9 @@ void EagerSearch::initialize() {
          << (reopen_closed_nodes ? " with" : " without")
          << " reopening closed nodes, (real) bound = " << bound
          << endl;
+    if (expansion_batch > 1)
+        cout << "Expanding up to " << expansion_batch
+             << " states per step" << endl;
     assert(open_list);
 
     set<Evaluator *> evals;
@@ -112,8 +116,12 @@ void EagerSearch::print_statistics() const {
 }
 
 SearchStatus EagerSearch::step() {
+    if (expansion_batch > 1)
+        return expand_batch();
+
     pair<SearchNode, bool> n = fetch_next_node();
     if (!n.second) {
+        cout << "Completely explored state space -- no solution!" << endl;
         return FAILED;
     }
     SearchNode node = n.first;
@@ -146,90 +154,165 @@ SearchStatus EagerSearch::step() {
             continue;
 
         GlobalState succ_state = state_registry.get_successor_state(s, op);
-        statistics.inc_generated();
-        bool is_preferred = preferred_operators.contains(op_id);
+        generate_successor(node, s, op_id, succ_state,
+                           preferred_operators.contains(op_id));
+    }
+
+    return IN_PROGRESS;
+}
+
+SearchStatus EagerSearch::expand_batch() {
+    /*
+      Close up to expansion_batch nodes before any of their successors
+      is inserted, so that the successors of all of them can be
+      registered in one pass. Stops at the first goal.
+    */
+    batch_parents.clear();
+    while (static_cast<int>(batch_parents.size()) < expansion_batch) {
+        pair<SearchNode, bool> n = fetch_next_node();
+        if (!n.second)
+            break;
+        GlobalState s = n.first.get_state();
+        if (check_goal_and_set_plan(s))
+            return SOLVED;
+        batch_parents.push_back(s.get_id());
+    }
+    if (batch_parents.empty()) {
+        cout << "Completely explored state space -- no solution!" << endl;
+        return FAILED;
+    }
 
-        SearchNode succ_node = search_space.get_node(succ_state);
+    successor_generator.generate_applicable_ops(
+        state_registry, batch_parents, batch_ops, batch_offsets);
 
-        for (Evaluator *evaluator : path_dependent_evaluators) {
-            evaluator->notify_state_transition(s, op_id, succ_state);
+    // Prune and apply the bound in place, one parent at a time.
+    vector<OperatorID> applicable_ops;
+    int num_kept = 0;
+    for (size_t i = 0; i < batch_parents.size(); ++i) {
+        GlobalState s = state_registry.lookup_state(batch_parents[i]);
+        SearchNode node = search_space.get_node(s);
+        applicable_ops.assign(batch_ops.begin() + batch_offsets[i],
+                              batch_ops.begin() + batch_offsets[i + 1]);
+        pruning_method->prune_operators(s, applicable_ops);
+        batch_offsets[i] = num_kept;
+        for (OperatorID op_id : applicable_ops) {
+            OperatorProxy op = task_proxy.get_operators()[op_id];
+            if ((node.get_real_g() + op.get_cost()) < bound)
+                batch_ops[num_kept++] = op_id;
         }
+    }
+    batch_ops.erase(batch_ops.begin() + num_kept, batch_ops.end());
+    batch_offsets.back() = num_kept;
 
-        // Previously encountered dead end. Don't re-evaluate.
-        if (succ_node.is_dead_end())
-            continue;
+    state_registry.get_successor_states(
+        batch_parents, batch_ops, batch_offsets, batch_successors);
 
-        if (succ_node.is_new()) {
-            // We have not seen this state before.
-            // Evaluate and create a new node.
+    for (size_t i = 0; i < batch_parents.size(); ++i) {
+        GlobalState s = state_registry.lookup_state(batch_parents[i]);
+        SearchNode node = search_space.get_node(s);
 
-            // Careful: succ_node.get_g() is not available here yet,
-            // hence the stupid computation of succ_g.
-            // TODO: Make this less fragile.
-            int succ_g = node.get_g() + get_adjusted_cost(op);
+        EvaluationContext eval_context(s, node.get_g(), false, &statistics, true);
+        ordered_set::OrderedSet<OperatorID> preferred_operators;
+        for (const shared_ptr<Evaluator> &preferred_operator_evaluator : preferred_operator_evaluators) {
+            collect_preferred_operators(eval_context,
+                                        preferred_operator_evaluator.get(),
+                                        preferred_operators);
+        }
 
-            EvaluationContext succ_eval_context(
-                succ_state, succ_g, is_preferred, &statistics);
-            statistics.inc_evaluated_states();
+        for (int j = batch_offsets[i]; j < batch_offsets[i + 1]; ++j) {
+            GlobalState succ_state = state_registry.lookup_state(batch_successors[j]);
+            generate_successor(node, s, batch_ops[j], succ_state,
+                               preferred_operators.contains(batch_ops[j]));
+        }
+    }
 
-            if (open_list->is_dead_end(succ_eval_context)) {
-                succ_node.mark_as_dead_end();
-                statistics.inc_dead_ends();
-                continue;
-            }
-            succ_node.open(node, op, get_adjusted_cost(op));
+    return IN_PROGRESS;
+}
 
-            open_list->insert(succ_eval_context, succ_state.get_id());
-            if (search_progress.check_progress(succ_eval_context)) {
-                print_checkpoint_line(succ_node.get_g());
-                reward_progress();
-            }
-        } else if (succ_node.get_g() > node.get_g() + get_adjusted_cost(op)) {
-            // We found a new cheapest path to an open or closed state.
-            if (reopen_closed_nodes) {
-                if (succ_node.is_closed()) {
-                    /*
-                      TODO: It would be nice if we had a way to test
-                      that reopening is expected behaviour, i.e., exit
-                      with an error when this is something where
-                      reopening should not occur (e.g. A* with a
-                      consistent heuristic).
-                    */
-                    statistics.inc_reopened();
-                }
-                succ_node.reopen(node, op, get_adjusted_cost(op));
+void EagerSearch::generate_successor(
+    const SearchNode &node, const GlobalState &s, OperatorID op_id,
+    const GlobalState &succ_state, bool is_preferred) {
+    OperatorProxy op = task_proxy.get_operators()[op_id];
+    statistics.inc_generated();
+
+    SearchNode succ_node = search_space.get_node(succ_state);
+
+    for (Evaluator *evaluator : path_dependent_evaluators) {
+        evaluator->notify_state_transition(s, op_id, succ_state);
+    }
+
+    // Previously encountered dead end. Don't re-evaluate.
+    if (succ_node.is_dead_end())
+        return;
+
+    if (succ_node.is_new()) {
+        // We have not seen this state before.
+        // Evaluate and create a new node.
 
-                EvaluationContext succ_eval_context(
-                    succ_state, succ_node.get_g(), is_preferred, &statistics);
+        // Careful: succ_node.get_g() is not available here yet,
+        // hence the stupid computation of succ_g.
+        // TODO: Make this less fragile.
+        int succ_g = node.get_g() + get_adjusted_cost(op);
+
+        EvaluationContext succ_eval_context(
+            succ_state, succ_g, is_preferred, &statistics);
+        statistics.inc_evaluated_states();
+
+        if (open_list->is_dead_end(succ_eval_context)) {
+            succ_node.mark_as_dead_end();
+            statistics.inc_dead_ends();
+            return;
+        }
+        succ_node.open(node, op, get_adjusted_cost(op));
 
+        open_list->insert(succ_eval_context, succ_state.get_id());
+        if (search_progress.check_progress(succ_eval_context)) {
+            print_checkpoint_line(succ_node.get_g());
+            reward_progress();
+        }
+    } else if (succ_node.get_g() > node.get_g() + get_adjusted_cost(op)) {
+        // We found a new cheapest path to an open or closed state.
+        if (reopen_closed_nodes) {
+            if (succ_node.is_closed()) {
                 /*
-                  Note: our old code used to retrieve the h value from
-                  the search node here. Our new code recomputes it as
-                  necessary, thus avoiding the incredible ugliness of
-                  the old "set_evaluator_value" approach, which also
-                  did not generalize properly to settings with more
-                  than one evaluator.
-
-                  Reopening should not happen all that frequently, so
-                  the performance impact of this is hopefully not that
-                  large. In the medium term, we want the evaluators to
-                  remember evaluator values for states themselves if
-                  desired by the user, so that such recomputations
-                  will just involve a look-up by the Evaluator object
-                  rather than a recomputation of the evaluator value
-                  from scratch.
+                  TODO: It would be nice if we had a way to test
+                  that reopening is expected behaviour, i.e., exit
+                  with an error when this is something where
+                  reopening should not occur (e.g. A* with a
+                  consistent heuristic).
                 */
-                open_list->insert(succ_eval_context, succ_state.get_id());
-            } else {
-                // If we do not reopen closed nodes, we just update the parent pointers.
-                // Note that this could cause an incompatibility between
-                // the g-value and the actual path that is traced back.
-                succ_node.update_parent(node, op, get_adjusted_cost(op));
+                statistics.inc_reopened();
             }
+            succ_node.reopen(node, op, get_adjusted_cost(op));
+
+            EvaluationContext succ_eval_context(
+                succ_state, succ_node.get_g(), is_preferred, &statistics);
+
+            /*
+              Note: our old code used to retrieve the h value from
+              the search node here. Our new code recomputes it as
+              necessary, thus avoiding the incredible ugliness of
+              the old "set_evaluator_value" approach, which also
+              did not generalize properly to settings with more
+              than one evaluator.
+
+              Reopening should not happen all that frequently, so
+              the performance impact of this is hopefully not that
+              large. In the medium term, we want the evaluators to
+              remember evaluator values for states themselves if
+              desired by the user, so that such recomputations
+              will just involve a look-up by the Evaluator object
+              rather than a recomputation of the evaluator value
+              from scratch.
+            */
+            open_list->insert(succ_eval_context, succ_state.get_id());
+        } else {
+            // If we do not reopen closed nodes, we just update the parent pointers.
+            // Note that this could cause an incompatibility between
+            // the g-value and the actual path that is traced back.
+            succ_node.update_parent(node, op, get_adjusted_cost(op));
         }
     }
-
-    return IN_PROGRESS;
 }
 
 pair<SearchNode, bool> EagerSearch::fetch_next_node() {
@@ -243,7 +326,6 @@ pair<SearchNode, bool> EagerSearch::fetch_next_node() {
 
     while (true) {
         if (open_list->empty()) {
-            cout << "Completely explored state space -- no solution!" << endl;
             // HACK! HACK! we do this because SearchNode has no default/copy constructor
             const GlobalState &initial_state = state_registry.get_initial_state();
             SearchNode dummy_node = search_space.get_node(initial_state);
@@ -319,6 +401,20 @@ void EagerSearch::dump_search_space() const {
     search_space.dump(task_proxy);
 }
 
+void add_expansion_batch_option(OptionParser &parser) {
+    parser.add_option<int>(
+        "expansion_batch",
+        "number of states that are taken off the open list and expanded "
+        "together. Their successors are registered in one pass, which "
+        "hides the latency of the state registry's hash lookups once the "
+        "registry no longer fits into the cache. The search then no "
+        "longer strictly expands states in the order of the open list: a "
+        "successor of one state of a batch is expanded only after the "
+        "whole batch.",
+        "1",
+        Bounds("1", "infinity"));
+}
+
 void EagerSearch::start_f_value_statistics(EvaluationContext &eval_context) {
     if (f_evaluator) {
         int f_value = eval_context.get_evaluator_value(f_evaluator.get());
@@ -11,12 +11,14 @@ class Evaluator;
 class PruningMethod;
 
 namespace options {
+class OptionParser;
 class Options;
 }
 
 namespace eager_search {
 class EagerSearch : public SearchEngine {
     const bool reopen_closed_nodes;
+    const int expansion_batch;
 
     std::unique_ptr<StateOpenList> open_list;
     std::shared_ptr<Evaluator> f_evaluator;
@@ -27,7 +29,17 @@ class EagerSearch : public SearchEngine {
 
     std::shared_ptr<PruningMethod> pruning_method;
 
+    // Scratch space of expand_batch, kept to reuse the memory.
+    std::vector<StateID> batch_parents;
+    std::vector<OperatorID> batch_ops;
+    std::vector<int> batch_offsets;
+    std::vector<StateID> batch_successors;
+
     std::pair<SearchNode, bool> fetch_next_node();
+    SearchStatus expand_batch();
+    void generate_successor(
+        const SearchNode &node, const GlobalState &s, OperatorID op_id,
+        const GlobalState &succ_state, bool is_preferred);
     void start_f_value_statistics(EvaluationContext &eval_context);
     void update_f_value_statistics(const SearchNode &node);
     void reward_progress();
@@ -45,6 +57,8 @@ public:
 
     void dump_search_space() const;
 };
+
+extern void add_expansion_batch_option(options::OptionParser &parser);
 }
 
 #endif
@@ -0,0 +1,516 @@
+#include "parallel_eager_search.h"
+
+#include "search_common.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../open_list_factory.h"
+#include "../option_parser.h"
+#include "../plugin.h"
+#include "../pruning_method.h"
+
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/memory.h"
+#include "../utils/rng.h"
+#include "../utils/rng_options.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <deque>
+#include <limits>
+#include <set>
+#include <thread>
+
+using namespace std;
+
+namespace parallel_eager_search {
+static const int INF = numeric_limits<int>::max();
+
+static uint64_t random_key(utils::RandomNumberGenerator &rng) {
+    const int bound = numeric_limits<int>::max();
+    return (static_cast<uint64_t>(rng(bound)) << 31) ^ static_cast<uint64_t>(rng(bound));
+}
+
+ZobristHash::ZobristHash(
+    const TaskProxy &task_proxy, int abstract_values, utils::RandomNumberGenerator &rng) {
+    VariablesProxy variables = task_proxy.get_variables();
+    keys.resize(variables.size());
+
+    if (abstract_values == 0) {
+        for (VariableProxy var : variables) {
+            for (int value = 0; value < var.get_domain_size(); ++value)
+                keys[var.get_id()].push_back(random_key(rng));
+        }
+        return;
+    }
+
+    // Transitions of each variable as an undirected graph on its values.
+    vector<vector<set<int>>> neighbors(variables.size());
+    for (VariableProxy var : variables)
+        neighbors[var.get_id()].resize(var.get_domain_size());
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        for (EffectProxy effect : op.get_effects()) {
+            FactPair post = effect.get_fact().get_pair();
+            for (FactProxy pre : op.get_preconditions()) {
+                FactPair pre_pair = pre.get_pair();
+                if (pre_pair.var == post.var && pre_pair.value != post.value) {
+                    neighbors[post.var][pre_pair.value].insert(post.value);
+                    neighbors[post.var][post.value].insert(pre_pair.value);
+                }
+            }
+        }
+    }
+
+    /*
+      Order the values of each variable by a breadth-first traversal of its
+      transition graph and cut the order into abstract_values groups of
+      consecutive values.
+    */
+    for (VariableProxy var : variables) {
+        int domain_size = var.get_domain_size();
+        vector<int> order;
+        vector<bool> seen(domain_size, false);
+        for (int start = 0; start < domain_size; ++start) {
+            if (seen[start])
+                continue;
+            deque<int> queue {start};
+            seen[start] = true;
+            while (!queue.empty()) {
+                int value = queue.front();
+                queue.pop_front();
+                order.push_back(value);
+                for (int next : neighbors[var.get_id()][value]) {
+                    if (!seen[next]) {
+                        seen[next] = true;
+                        queue.push_back(next);
+                    }
+                }
+            }
+        }
+
+        int num_groups = min(abstract_values, domain_size);
+        vector<uint64_t> group_keys(num_groups);
+        for (uint64_t &key : group_keys)
+            key = random_key(rng);
+        vector<uint64_t> &var_keys = keys[var.get_id()];
+        var_keys.resize(domain_size);
+        for (int i = 0; i < domain_size; ++i)
+            var_keys[order[i]] = group_keys[i * num_groups / domain_size];
+    }
+}
+
+ParallelEagerSearch::Worker::Worker(const TaskProxy &task_proxy)
+    : registry(task_proxy),
+      num_sent(0),
+      has_mail(false) {
+}
+
+ParallelEagerSearch::ParallelEagerSearch(
+    const Options &opts, options::Registry &registry,
+    const options::Predefinitions &predefinitions)
+    : SearchEngine(opts),
+      eval_config(opts.get<ParseTree>("eval")),
+      pruning_config(opts.get<ParseTree>("pruning")),
+      registry(registry),
+      predefinitions(predefinitions),
+      num_threads(opts.get<int>("threads")),
+      hash_kind(HashKind(opts.get_enum("hash"))),
+      abstract_values(opts.get<int>("abstract_values")),
+      rng(utils::parse_rng_from_options(opts)),
+      incumbent_cost(INF),
+      incumbent_thread(-1),
+      incumbent_id(StateID::no_state),
+      num_active(0),
+      timed_out(false) {
+    /*
+      The registries of all threads share the axiom evaluator of the task,
+      which keeps its scratch data in its members.
+    */
+    task_properties::verify_no_axioms(task_proxy);
+}
+
+ParallelEagerSearch::~ParallelEagerSearch() {
+}
+
+void ParallelEagerSearch::initialize() {
+    cout << "Conducting hash distributed A* search with " << num_threads
+         << " threads, (real) bound = " << bound << endl;
+
+    hash = utils::make_unique_ptr<ZobristHash>(
+        task_proxy, hash_kind == HashKind::ABSTRACT_ZOBRIST ? abstract_values : 0, *rng);
+
+    /*
+      Evaluators are not thread-safe, so every thread gets its own, parsed
+      from the configuration. Everything is built here on the main thread,
+      because building evaluators fills shared per-task caches.
+    */
+    for (int thread = 0; thread < num_threads; ++thread) {
+        auto worker = utils::make_unique_ptr<Worker>(task_proxy);
+        OptionParser eval_parser(eval_config, registry, predefinitions, false);
+        worker->evaluator = eval_parser.start_parsing<shared_ptr<Evaluator>>();
+        OptionParser pruning_parser(pruning_config, registry, predefinitions, false);
+        worker->pruning_method = pruning_parser.start_parsing<shared_ptr<PruningMethod>>();
+        worker->pruning_method->initialize(task);
+
+        Options open_opts;
+        open_opts.set("eval", worker->evaluator);
+        auto open_and_f = search_common::create_astar_open_list_factory_and_f_eval(open_opts);
+        worker->open_list = open_and_f.first->create_state_open_list();
+        worker->f_evaluator = open_and_f.second;
+
+        set<Evaluator *> path_dependent_evaluators;
+        worker->open_list->get_path_dependent_evaluators(path_dependent_evaluators);
+        if (!path_dependent_evaluators.empty()) {
+            cerr << "parallel_eager does not support path-dependent evaluators" << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+        }
+        if (!workers.empty() && workers.front()->evaluator == worker->evaluator) {
+            cerr << "parallel_eager needs one evaluator per thread, "
+                 << "so the evaluator must not be a predefined one" << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+        }
+        worker->outboxes.resize(num_threads);
+        worker->successor.resize(worker->registry.get_bins_per_state());
+        workers.push_back(move(worker));
+    }
+
+    const GlobalState &initial_state = state_registry.get_initial_state();
+    int owner = get_owner(initial_state);
+    Worker &worker = *workers[owner];
+    GlobalState state = worker.registry.get_initial_state();
+    EvaluationContext eval_context(state, 0, true, &worker.statistics);
+    worker.statistics.inc_evaluated_states();
+    if (worker.open_list->is_dead_end(eval_context)) {
+        cout << "Initial state is a dead end." << endl;
+    } else {
+        NodeInfo &info = worker.nodes[state];
+        info.status = NodeInfo::OPEN;
+        info.g = 0;
+        info.real_g = 0;
+        worker.open_list->insert(eval_context, state.get_id());
+    }
+    print_initial_evaluator_values(eval_context);
+}
+
+int ParallelEagerSearch::get_owner(
+    const PackedStateBin *buffer, const StateRegistry &states) const {
+    uint64_t h = (*hash)(states.get_num_variables(), [&](int var) {
+                             return states.get_state_value(buffer, var);
+                         });
+    return static_cast<int>(h % num_threads);
+}
+
+int ParallelEagerSearch::get_owner(const GlobalState &state) const {
+    uint64_t h = (*hash)(task_proxy.get_variables().size(), [&](int var) {
+                             return state[var];
+                         });
+    return static_cast<int>(h % num_threads);
+}
+
+SearchStatus ParallelEagerSearch::step() {
+    // Every thread starts busy.
+    num_active = num_threads;
+    vector<thread> threads;
+    for (int thread = 1; thread < num_threads; ++thread)
+        threads.emplace_back(&ParallelEagerSearch::work, this, thread);
+    work(0);
+    for (auto &t : threads)
+        t.join();
+
+    for (const auto &worker : workers) {
+        const SearchStatistics &s = worker->statistics;
+        statistics.inc_expanded(s.get_expanded());
+        statistics.inc_evaluated_states(s.get_evaluated_states());
+        statistics.inc_evaluations(s.get_evaluations());
+        statistics.inc_generated(s.get_generated());
+        statistics.inc_reopened(s.get_reopened());
+        statistics.inc_generated_ops(s.get_generated_ops());
+    }
+
+    if (timed_out) {
+        cout << "Time limit reached. Abort search." << endl;
+        return TIMEOUT;
+    }
+    if (incumbent_cost == INF) {
+        cout << "Completely explored state space -- no solution!" << endl;
+        return FAILED;
+    }
+    cout << "Solution found!" << endl;
+    trace_plan();
+    return SOLVED;
+}
+
+void ParallelEagerSearch::work(int thread) {
+    Worker &worker = *workers[thread];
+    auto deadline = chrono::steady_clock::now() + chrono::duration<double>(
+        min(max_time, 1e9));
+    bool active = true;
+    int since_time_check = 0;
+    while (true) {
+        if (++since_time_check == 256) {
+            since_time_check = 0;
+            if (chrono::steady_clock::now() >= deadline)
+                timed_out = true;
+        }
+        if (timed_out)
+            return;
+
+        if (worker.has_mail) {
+            if (!active) {
+                // The unprocessed messages keep num_active above zero.
+                ++num_active;
+                active = true;
+            }
+            receive(worker);
+        }
+        if (expand(worker, thread)) {
+            flush(worker);
+            continue;
+        }
+
+        if (active) {
+            active = false;
+            --num_active;
+        }
+        if (num_active == 0)
+            return;
+        this_thread::yield();
+    }
+}
+
+void ParallelEagerSearch::receive(Worker &worker) {
+    worker.received.clear();
+    {
+        lock_guard<mutex> lock(worker.inbox_mutex);
+        swap(worker.received, worker.inbox);
+        worker.has_mail = false;
+    }
+    int bins = worker.registry.get_bins_per_state();
+    const MessageBatch &batch = worker.received;
+    for (size_t i = 0; i < batch.messages.size(); ++i) {
+        add_state(worker, &batch.states[i * bins], batch.messages[i]);
+    }
+    // Only now the messages are done, which may let the search end.
+    num_active -= batch.messages.size();
+}
+
+bool ParallelEagerSearch::expand(Worker &worker, int thread) {
+    while (!worker.open_list->empty()) {
+        StateID id = worker.open_list->remove_min();
+        GlobalState state = worker.registry.lookup_state(id);
+        NodeInfo &info = worker.nodes[state];
+        if (info.status != NodeInfo::OPEN)
+            continue;
+
+        EvaluationContext eval_context(state, info.g, false, &worker.statistics);
+        int f = eval_context.get_evaluator_value_or_infinity(worker.f_evaluator.get());
+        if (f >= incumbent_cost) {
+            /*
+              The open list is ordered by f, so no open state can lead
+              to a cheaper plan.
+            */
+            worker.open_list->clear();
+            return false;
+        }
+
+        info.status = NodeInfo::CLOSED;
+        worker.statistics.inc_expanded();
+        if (task_properties::is_goal_state(task_proxy, state)) {
+            update_incumbent(info.g, thread, id);
+            return true;
+        }
+
+        worker.applicable_ops.clear();
+        successor_generator.generate_applicable_ops(state, worker.applicable_ops);
+        worker.pruning_method->prune_operators(state, worker.applicable_ops);
+        worker.statistics.inc_generated_ops(worker.applicable_ops.size());
+
+        Message message {0, 0, thread, id, OperatorID::no_operator};
+        int g = info.g;
+        int real_g = info.real_g;
+        for (OperatorID op_id : worker.applicable_ops) {
+            OperatorProxy op = task_proxy.get_operators()[op_id];
+            if (real_g + op.get_cost() >= bound)
+                continue;
+            message.g = g + get_adjusted_cost(op);
+            message.real_g = real_g + op.get_cost();
+            if (message.g >= incumbent_cost)
+                continue;
+            message.creating_operator = op_id;
+
+            worker.registry.get_successor_data(state, op, worker.successor.data());
+            worker.statistics.inc_generated();
+            int owner = get_owner(worker.successor.data(), worker.registry);
+            if (owner == thread) {
+                add_state(worker, worker.successor.data(), message);
+            } else {
+                MessageBatch &outbox = worker.outboxes[owner];
+                outbox.states.insert(outbox.states.end(),
+                                     worker.successor.begin(), worker.successor.end());
+                outbox.messages.push_back(message);
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+void ParallelEagerSearch::flush(Worker &worker) {
+    for (int owner = 0; owner < num_threads; ++owner) {
+        MessageBatch &outbox = worker.outboxes[owner];
+        if (outbox.messages.empty())
+            continue;
+        // Count the messages before anyone can see them.
+        num_active += outbox.messages.size();
+        worker.num_sent += outbox.messages.size();
+        Worker &receiver = *workers[owner];
+        {
+            lock_guard<mutex> lock(receiver.inbox_mutex);
+            MessageBatch &inbox = receiver.inbox;
+            inbox.states.insert(inbox.states.end(),
+                                outbox.states.begin(), outbox.states.end());
+            inbox.messages.insert(inbox.messages.end(),
+                                  outbox.messages.begin(), outbox.messages.end());
+            receiver.has_mail = true;
+        }
+        outbox.clear();
+    }
+}
+
+void ParallelEagerSearch::add_state(
+    Worker &worker, const PackedStateBin *buffer, const Message &message) {
+    if (message.g >= incumbent_cost)
+        return;
+    GlobalState state = worker.registry.register_state(buffer);
+    NodeInfo &info = worker.nodes[state];
+    if (info.status == NodeInfo::DEAD_END)
+        return;
+    if (info.status == NodeInfo::NEW) {
+        EvaluationContext eval_context(state, message.g, false, &worker.statistics);
+        worker.statistics.inc_evaluated_states();
+        if (worker.open_list->is_dead_end(eval_context)) {
+            info.status = NodeInfo::DEAD_END;
+            worker.statistics.inc_dead_ends();
+            return;
+        }
+        info.open(message);
+        worker.open_list->insert(eval_context, state.get_id());
+    } else if (message.g < info.g) {
+        // A* needs to reopen closed states if h is not consistent.
+        if (info.status == NodeInfo::CLOSED)
+            worker.statistics.inc_reopened();
+        info.open(message);
+        EvaluationContext eval_context(state, message.g, false, &worker.statistics);
+        worker.open_list->insert(eval_context, state.get_id());
+    }
+}
+
+void ParallelEagerSearch::update_incumbent(int g, int thread, StateID id) {
+    lock_guard<mutex> lock(incumbent_mutex);
+    if (g < incumbent_cost) {
+        incumbent_cost = g;
+        incumbent_thread = thread;
+        incumbent_id = id;
+        cout << "New incumbent with g=" << g << " found by thread "
+             << thread << endl;
+    }
+}
+
+void ParallelEagerSearch::trace_plan() {
+    Plan plan;
+    int thread = incumbent_thread;
+    StateID id = incumbent_id;
+    while (true) {
+        Worker &worker = *workers[thread];
+        const NodeInfo &info = worker.nodes[worker.registry.lookup_state(id)];
+        if (info.parent_thread == -1)
+            break;
+        plan.push_back(info.creating_operator);
+        thread = info.parent_thread;
+        id = info.parent_id;
+    }
+    reverse(plan.begin(), plan.end());
+    set_plan(plan);
+}
+
+void ParallelEagerSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    long long num_sent = 0;
+    for (size_t thread = 0; thread < workers.size(); ++thread) {
+        const Worker &worker = *workers[thread];
+        cout << "Thread " << thread << ": "
+             << worker.statistics.get_expanded() << " expanded, "
+             << worker.registry.size() << " registered, "
+             << worker.num_sent << " sent" << endl;
+        num_sent += worker.num_sent;
+    }
+    cout << "Messages sent: " << num_sent << endl;
+    if (statistics.get_generated() > 0)
+        cout << "Messages per generated state: "
+             << static_cast<double>(num_sent) / statistics.get_generated() << endl;
+}
+
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Hash distributed A* search",
+        "Parallel A* that distributes states to threads by their hash "
+        "(Kishimoto, Fukunaga and Botea, 2013). Every thread expands "
+        "the states it owns in f order with its own open list. "
+        "Closed nodes are re-opened and the plan is optimal for "
+        "admissible heuristics.");
+    parser.document_note(
+        "Evaluators",
+        "Every thread parses its own evaluator from the configuration, "
+        "so the evaluator must be given inline and not as a predefined "
+        "evaluator. Path-dependent evaluators and tasks with axioms are "
+        "not supported.");
+    parser.add_option<ParseTree>("eval", "evaluator for h-value");
+    parser.add_option<ParseTree>(
+        "pruning",
+        "Pruning methods can prune or reorder the set of applicable operators in "
+        "each state and thereby influence the number and order of successor states "
+        "that are considered.",
+        "null()");
+    parser.add_option<int>(
+        "threads", "number of threads", "1", Bounds("1", ""));
+    vector<string> hash_kinds;
+    vector<string> hash_kinds_doc;
+    hash_kinds.push_back("ZOBRIST");
+    hash_kinds_doc.push_back("Zobrist hash over all variable values");
+    hash_kinds.push_back("ABSTRACT_ZOBRIST");
+    hash_kinds_doc.push_back(
+        "Zobrist hash over groups of values that are adjacent in the domain "
+        "transition graph of their variable, which sends fewer states "
+        "to other threads");
+    parser.add_enum_option(
+        "hash", hash_kinds, "hash that assigns states to threads",
+        "ZOBRIST", hash_kinds_doc);
+    parser.add_option<int>(
+        "abstract_values",
+        "number of value groups per variable for ABSTRACT_ZOBRIST",
+        "2", Bounds("1", ""));
+    utils::add_rng_options(parser);
+    SearchEngine::add_options_to_parser(parser);
+    Options opts = parser.parse();
+
+    if (parser.help_mode()) {
+        return nullptr;
+    } else if (parser.dry_run()) {
+        OptionParser eval_parser(opts.get<ParseTree>("eval"), parser.get_registry(),
+                                 parser.get_predefinitions(), true);
+        eval_parser.start_parsing<shared_ptr<Evaluator>>();
+        OptionParser pruning_parser(opts.get<ParseTree>("pruning"), parser.get_registry(),
+                                    parser.get_predefinitions(), true);
+        pruning_parser.start_parsing<shared_ptr<PruningMethod>>();
+        return nullptr;
+    } else {
+        return make_shared<ParallelEagerSearch>(opts, parser.get_registry(),
+                                                parser.get_predefinitions());
+    }
+}
+
+static Plugin<SearchEngine> _plugin("parallel_eager", _parse);
+}
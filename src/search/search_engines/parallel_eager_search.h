@@ -0,0 +1,188 @@
+#ifndef SEARCH_ENGINES_PARALLEL_EAGER_SEARCH_H
+#define SEARCH_ENGINES_PARALLEL_EAGER_SEARCH_H
+
+#include "../open_list.h"
+#include "../option_parser_util.h"
+#include "../per_state_information.h"
+#include "../search_engine.h"
+
+#include "../options/predefinitions.h"
+#include "../options/registries.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class Evaluator;
+class PruningMethod;
+
+namespace options {
+class Options;
+}
+
+namespace utils {
+class RandomNumberGenerator;
+}
+
+namespace parallel_eager_search {
+enum class HashKind {
+    ZOBRIST,
+    ABSTRACT_ZOBRIST
+};
+
+/*
+  Zobrist hash of a state: the xor of one random key per variable value.
+
+  With an abstraction, the values of each variable are split into a few
+  groups of values that are adjacent in the domain transition graph of
+  the variable, and all values of a group share their key. Operators
+  that only move a variable within a group then do not change the hash,
+  so more successors stay with the thread that generated them.
+*/
+class ZobristHash {
+    std::vector<std::vector<uint64_t>> keys;
+public:
+    ZobristHash(const TaskProxy &task_proxy, int abstract_values,
+                utils::RandomNumberGenerator &rng);
+
+    template<typename ValueOf>
+    uint64_t operator()(int num_variables, const ValueOf &value_of) const {
+        uint64_t hash = 0;
+        for (int var = 0; var < num_variables; ++var)
+            hash ^= keys[var][value_of(var)];
+        return hash;
+    }
+};
+
+/*
+  Hash distributed A* (Kishimoto, Fukunaga and Botea, 2013).
+
+  Every state is owned by one thread, chosen by the hash of the state.
+  Each thread has its own state registry, open list and evaluator and
+  only expands the states it owns. Successors owned by other threads are
+  sent to them in batches through a locked inbox.
+
+  A thread that expands a goal state updates the shared incumbent cost.
+  Threads drop all open states with f >= incumbent, which keeps the
+  incumbent optimal for admissible heuristics. The search ends when all
+  threads are idle and no messages are in flight. This is detected with
+  a single counter of busy threads plus unprocessed messages: senders
+  count a message before they send it and receivers only uncount it
+  after processing it, so the counter cannot drop to zero while work
+  remains and cannot leave zero once it got there.
+*/
+class ParallelEagerSearch : public SearchEngine {
+    struct Message {
+        int g;
+        int real_g;
+        int parent_thread;
+        StateID parent_id;
+        OperatorID creating_operator;
+    };
+
+    struct NodeInfo {
+        enum Status : char {NEW, OPEN, CLOSED, DEAD_END};
+        Status status;
+        int g;
+        int real_g;
+        // The parent is a state of the registry of thread parent_thread.
+        int parent_thread;
+        StateID parent_id;
+        OperatorID creating_operator;
+
+        NodeInfo()
+            : status(NEW), g(-1), real_g(-1), parent_thread(-1),
+              parent_id(StateID::no_state),
+              creating_operator(OperatorID::no_operator) {
+        }
+
+        void open(const Message &message) {
+            status = OPEN;
+            g = message.g;
+            real_g = message.real_g;
+            parent_thread = message.parent_thread;
+            parent_id = message.parent_id;
+            creating_operator = message.creating_operator;
+        }
+    };
+
+    // The packed states of a batch are stored back to back.
+    struct MessageBatch {
+        std::vector<PackedStateBin> states;
+        std::vector<Message> messages;
+
+        void clear() {
+            states.clear();
+            messages.clear();
+        }
+    };
+
+    struct Worker {
+        StateRegistry registry;
+        PerStateInformation<NodeInfo> nodes;
+        std::shared_ptr<Evaluator> evaluator;
+        std::shared_ptr<Evaluator> f_evaluator;
+        std::unique_ptr<StateOpenList> open_list;
+        std::shared_ptr<PruningMethod> pruning_method;
+        SearchStatistics statistics;
+        std::vector<OperatorID> applicable_ops;
+        std::vector<PackedStateBin> successor;
+        std::vector<MessageBatch> outboxes;
+        MessageBatch received;
+        long long num_sent;
+
+        std::mutex inbox_mutex;
+        MessageBatch inbox;
+        std::atomic<bool> has_mail;
+
+        explicit Worker(const TaskProxy &task_proxy);
+    };
+
+    const options::ParseTree eval_config;
+    const options::ParseTree pruning_config;
+    options::Registry registry;
+    options::Predefinitions predefinitions;
+    const int num_threads;
+    const HashKind hash_kind;
+    const int abstract_values;
+    std::shared_ptr<utils::RandomNumberGenerator> rng;
+
+    std::unique_ptr<ZobristHash> hash;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::atomic<int> incumbent_cost;
+    std::mutex incumbent_mutex;
+    int incumbent_thread;
+    StateID incumbent_id;
+
+    std::atomic<long long> num_active;
+    std::atomic<bool> timed_out;
+
+    int get_owner(const PackedStateBin *buffer, const StateRegistry &states) const;
+    int get_owner(const GlobalState &state) const;
+
+    void work(int thread);
+    void receive(Worker &worker);
+    bool expand(Worker &worker, int thread);
+    void flush(Worker &worker);
+    void add_state(Worker &worker, const PackedStateBin *buffer,
+                   const Message &message);
+    void update_incumbent(int g, int thread, StateID id);
+    void trace_plan();
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    ParallelEagerSearch(const options::Options &opts, options::Registry &registry,
+                        const options::Predefinitions &predefinitions);
+    virtual ~ParallelEagerSearch() override;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
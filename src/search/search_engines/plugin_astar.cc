@@ -33,6 +33,7 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
         "An evaluator that re-evaluates a state before it is expanded.",
         OptionParser::NONE);
 
+    eager_search::add_expansion_batch_option(parser);
     SearchEngine::add_pruning_option(parser);
     SearchEngine::add_options_to_parser(parser);
     Options opts = parser.parse();
@@ -22,6 +22,7 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
         "preferred",
         "use preferred operators of these evaluators", "[]");
 
+    eager_search::add_expansion_batch_option(parser);
     SearchEngine::add_pruning_option(parser);
     SearchEngine::add_options_to_parser(parser);
     Options opts = parser.parse();
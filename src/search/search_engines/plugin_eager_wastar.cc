@@ -41,6 +41,7 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
         "evaluator weight",
         "1");
 
+    eager_search::add_expansion_batch_option(parser);
     SearchEngine::add_pruning_option(parser);
     SearchEngine::add_options_to_parser(parser);
     Options opts = parser.parse();
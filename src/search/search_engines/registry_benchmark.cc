@@ -0,0 +1,145 @@
+#include "registry_benchmark.h"
+
+#include "../option_parser.h"
+#include "../plugin.h"
+#include "../sharded_state_registry.h"
+
+#include "../task_utils/successor_generator.h"
+#include "../utils/rng.h"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace std;
+
+namespace registry_benchmark {
+RegistryBenchmark::RegistryBenchmark(const Options &opts)
+    : SearchEngine(opts),
+      thread_counts(opts.get_list<int>("threads")),
+      num_shards(opts.get<int>("shards")),
+      insertions_per_thread(opts.get<int>("insertions")),
+      random_seed(opts.get<int>("random_seed")) {
+}
+
+RegistryBenchmark::WalkResult RegistryBenchmark::random_walk(
+    ShardedStateRegistry &registry, int thread) const {
+    OperatorsProxy operators = task_proxy.get_operators();
+    utils::RandomNumberGenerator rng(random_seed + thread);
+    vector<OperatorID> applicable_ops;
+
+    GlobalState state = registry.get_initial_state();
+    WalkResult result;
+    while (result.num_inserted < insertions_per_thread) {
+        applicable_ops.clear();
+        successor_generator.generate_applicable_ops(state, applicable_ops);
+        if (applicable_ops.empty()) {
+            if (state.get_id() == registry.get_initial_state().get_id())
+                break;
+            state = registry.get_initial_state();
+            continue;
+        }
+        int next = rng(applicable_ops.size());
+        GlobalState next_state = state;
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < applicable_ops.size(); ++i) {
+            GlobalState succ_state = registry.get_successor_state(
+                state, operators[applicable_ops[i]]);
+            if (static_cast<int>(i) == next)
+                next_state = succ_state;
+        }
+        result.insertion_time += chrono::steady_clock::now() - start;
+        result.num_inserted += applicable_ops.size();
+        state = next_state;
+    }
+    return result;
+}
+
+double RegistryBenchmark::run(int num_threads) const {
+    ShardedStateRegistry registry(task_proxy, num_shards);
+    registry.get_initial_state();
+
+    vector<WalkResult> results(num_threads);
+    auto start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (int thread = 1; thread < num_threads; ++thread)
+        threads.emplace_back([this, &registry, &results, thread]() {
+                                 results[thread] = random_walk(registry, thread);
+                             });
+    results[0] = random_walk(registry, 0);
+    for (auto &t : threads)
+        t.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    /*
+      The threads register at the same time, so the rate of the
+      registry is the sum of the rates of the threads, each measured
+      over the time it spent registering.
+    */
+    long long total = 0;
+    double throughput = 0;
+    double insertion_seconds = 0;
+    for (const WalkResult &result : results) {
+        double thread_seconds = chrono::duration<double>(result.insertion_time).count();
+        total += result.num_inserted;
+        insertion_seconds += thread_seconds;
+        if (thread_seconds > 0)
+            throughput += result.num_inserted / thread_seconds;
+    }
+    cout << "Threads: " << num_threads << endl;
+    cout << "Insertions: " << total << endl;
+    cout << "Time: " << seconds << "s" << endl;
+    cout << "Registration time per thread: " << insertion_seconds / num_threads << "s" << endl;
+    cout << "Insertions per second: " << throughput << endl;
+    registry.print_statistics();
+    return throughput;
+}
+
+SearchStatus RegistryBenchmark::step() {
+    double baseline = 0;
+    for (int num_threads : thread_counts) {
+        double throughput = run(num_threads);
+        if (baseline == 0)
+            baseline = throughput;
+        if (baseline > 0)
+            cout << "Speedup over " << thread_counts.front() << " thread(s): "
+                 << throughput / baseline << endl;
+    }
+    cout << "Hardware threads: " << thread::hardware_concurrency() << endl;
+    return FAILED;
+}
+
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Sharded state registry benchmark",
+        "Registers states from several threads at once and reports the "
+        "insertion rate for each number of threads, measured over the time "
+        "spent registering. Does not search for a plan.");
+    parser.add_list_option<int>(
+        "threads", "numbers of threads to measure", "[1,2,4,8]");
+    parser.add_option<int>(
+        "shards", "number of registry shards", "64", Bounds("1", ""));
+    parser.add_option<int>(
+        "insertions", "successors registered by each thread", "1000000",
+        Bounds("1", ""));
+    parser.add_option<int>("random_seed", "seed of the random walks", "0");
+    SearchEngine::add_options_to_parser(parser);
+    Options opts = parser.parse();
+
+    if (!parser.dry_run()) {
+        for (int num_threads : opts.get_list<int>("threads")) {
+            if (num_threads < 1)
+                parser.error("numbers of threads must be positive");
+        }
+        if (opts.get_list<int>("threads").empty())
+            parser.error("need at least one number of threads");
+    }
+
+    if (parser.dry_run())
+        return nullptr;
+    else
+        return make_shared<RegistryBenchmark>(opts);
+}
+
+static Plugin<SearchEngine> _plugin("registry_benchmark", _parse);
+}
@@ -0,0 +1,52 @@
+#ifndef SEARCH_ENGINES_REGISTRY_BENCHMARK_H
+#define SEARCH_ENGINES_REGISTRY_BENCHMARK_H
+
+#include "../search_engine.h"
+
+#include <chrono>
+#include <vector>
+
+class ShardedStateRegistry;
+
+namespace options {
+class Options;
+}
+
+namespace registry_benchmark {
+/*
+  Stress test for ShardedStateRegistry, not a planner.
+
+  For every configured number of threads, a fresh registry is filled by
+  that many threads at once. Each thread performs a random walk from the
+  initial state and registers all successors of every state it visits
+  until it has registered the configured number of successors. The walk
+  restarts from the initial state at dead ends, and a thread stops early
+  if the initial state itself has no successors. Only the calls that
+  register successors are timed, not the successor generation of the
+  walk. The benchmark reports the insertion rate for each number of
+  threads and its speedup over the first configuration.
+*/
+class RegistryBenchmark : public SearchEngine {
+    const std::vector<int> thread_counts;
+    const int num_shards;
+    const long long insertions_per_thread;
+    const int random_seed;
+
+    struct WalkResult {
+        long long num_inserted = 0;
+        std::chrono::steady_clock::duration insertion_time{0};
+    };
+
+    WalkResult random_walk(ShardedStateRegistry &registry, int thread) const;
+    // Returns the number of successors registered per second of
+    // registration time, summed over the threads.
+    double run(int num_threads) const;
+protected:
+    virtual SearchStatus step() override;
+public:
+    explicit RegistryBenchmark(const options::Options &opts);
+    virtual ~RegistryBenchmark() override = default;
+};
+}
+
+#endif
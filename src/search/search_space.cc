@@ -125,12 +125,35 @@ void SearchNode::dump(const TaskProxy &task_proxy) const {
     }
 }
 
+static const SearchNodeInfo new_node_info;
+
 SearchSpace::SearchSpace(StateRegistry &state_registry)
-    : state_registry(state_registry) {
+    : epoch(0),
+      state_registry(state_registry) {
+}
+
+const SearchNodeInfo &SearchSpace::get_node_info(const GlobalState &state) const {
+    if (epoch != 0 && node_epochs[state] != epoch)
+        return new_node_info;
+    return search_node_infos[state];
 }
 
 SearchNode SearchSpace::get_node(const GlobalState &state) {
-    return SearchNode(state_registry, state.get_id(), search_node_infos[state]);
+    SearchNodeInfo &info = search_node_infos[state];
+    if (epoch != 0) {
+        unsigned int &node_epoch = node_epochs[state];
+        if (node_epoch != epoch) {
+            node_epoch = epoch;
+            info = SearchNodeInfo();
+        }
+    }
+    return SearchNode(state_registry, state.get_id(), info);
+}
+
+void SearchSpace::reset() {
+    ++epoch;
+    // After 2^32 resets, stale stamps could be mistaken for current ones.
+    assert(epoch != 0);
 }
 
 void SearchSpace::trace_path(const GlobalState &goal_state,
@@ -151,7 +174,7 @@ void SearchSpace::trace_path_rev(const GlobalState &goal_state,
     GlobalState current_state = goal_state;
     assert(path.empty());
     for (;;) {
-        const SearchNodeInfo &info = search_node_infos[current_state];
+        const SearchNodeInfo &info = get_node_info(current_state);
         if (info.creating_operator == OperatorID::no_operator) {
             assert(info.parent_state_id == StateID::no_state);
             break;
@@ -176,7 +199,7 @@ void SearchSpace::trace_path_rev_to(StateID initial_id,
     GlobalState current_state = goal_state;
     assert(path.empty());
     while (initial_id != current_state.get_id()) {
-        const SearchNodeInfo &info = search_node_infos[current_state];
+        const SearchNodeInfo &info = get_node_info(current_state);
         if (info.creating_operator == OperatorID::no_operator) {
             assert(info.parent_state_id == StateID::no_state);
             break;
@@ -192,7 +215,7 @@ void SearchSpace::dump(const TaskProxy &task_proxy) const {
         /* The body duplicates SearchNode::dump() but we cannot create
            a search node without discarding the const qualifier. */
         GlobalState state = state_registry.lookup_state(id);
-        const SearchNodeInfo &node_info = search_node_infos[state];
+        const SearchNodeInfo &node_info = get_node_info(state);
         cout << id << ": ";
         state.dump_fdr();
         if (node_info.creating_operator != OperatorID::no_operator &&
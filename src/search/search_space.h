@@ -57,12 +57,28 @@ public:
 
 class SearchSpace {
     PerStateInformation<SearchNodeInfo> search_node_infos;
+    /*
+      Search spaces that are reused for several searches (see reset())
+      stamp each node with the epoch in which it was last accessed. Nodes
+      with an outdated stamp are treated as new. As long as reset() is
+      never called, the epoch stays 0 and no stamps are stored.
+    */
+    PerStateInformation<unsigned int> node_epochs;
+    unsigned int epoch;
 
     StateRegistry &state_registry;
+
+    const SearchNodeInfo &get_node_info(const GlobalState &state) const;
 public:
     explicit SearchSpace(StateRegistry &state_registry);
 
     SearchNode get_node(const GlobalState &state);
+    /*
+      Forget all nodes in O(1). Nodes are reinitialized lazily the next
+      time they are accessed, so the cost of a search after a reset only
+      depends on the nodes it touches and not on the size of the registry.
+    */
+    void reset();
     void trace_path(const GlobalState &goal_state,
                     std::vector<OperatorID> &path) const;
     void trace_path_rev(const GlobalState &goal_state,
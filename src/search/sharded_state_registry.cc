@@ -0,0 +1,180 @@
+#include "sharded_state_registry.h"
+
+#include "axioms.h"
+#include "task_proxy.h"
+
+#include "task_utils/task_properties.h"
+#include "utils/hash.h"
+#include "utils/memory.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+
+using namespace std;
+
+static int_hash_set::HashType hash_state_data(const PackedStateBin *data, int state_size) {
+    utils::HashState hash_state;
+    for (int i = 0; i < state_size; ++i) {
+        hash_state.feed(data[i]);
+    }
+    return hash_state.get_hash32();
+}
+
+int_hash_set::HashType ShardedStateRegistry::ShardHash::operator()(int id) const {
+    return hash_state_data((*state_data_pool)[id], state_size);
+}
+
+bool ShardedStateRegistry::ShardEqual::operator()(int lhs, int rhs) const {
+    const PackedStateBin *lhs_data = (*state_data_pool)[lhs];
+    const PackedStateBin *rhs_data = (*state_data_pool)[rhs];
+    return equal(lhs_data, lhs_data + state_size, rhs_data);
+}
+
+ShardedStateRegistry::Shard::Shard(int state_size)
+    : state_data_pool(state_size),
+      registered_states(
+          ShardHash {&state_data_pool, state_size},
+          ShardEqual {&state_data_pool, state_size}),
+      num_contended_inserts(0) {
+}
+
+ShardedStateRegistry::ShardedStateRegistry(const TaskProxy &task_proxy, int num_shards)
+    : task_proxy(task_proxy),
+      state_packer(task_properties::g_state_packers[task_proxy]),
+      operator_effects(compiled_effects::g_compiled_effects[task_proxy]),
+      task_has_axioms(task_properties::has_axioms(task_proxy)),
+      num_shards(num_shards),
+      decoder(task_proxy) {
+    assert(num_shards > 0);
+    shards.reserve(num_shards);
+    for (int i = 0; i < num_shards; ++i) {
+        shards.push_back(utils::make_unique_ptr<Shard>(get_bins_per_state()));
+    }
+}
+
+ShardedStateRegistry::~ShardedStateRegistry() {
+}
+
+int ShardedStateRegistry::get_bins_per_state() const {
+    return state_packer.get_num_bins();
+}
+
+int ShardedStateRegistry::get_shard(int_hash_set::HashType hash) const {
+    /*
+      The hash sets of the shards pick buckets by the low bits of the
+      hash, so the shard is picked by the high bits. Otherwise all states
+      of a shard would agree on their low bits and pile up in a fraction
+      of the buckets.
+    */
+    return static_cast<int>((static_cast<uint64_t>(hash) * num_shards) >> 32);
+}
+
+void ShardedStateRegistry::evaluate_axioms(PackedStateBin *buffer, int op_id) {
+    if (!task_has_axioms)
+        return;
+    unique_ptr<AxiomEvaluator> evaluator;
+    {
+        lock_guard<mutex> lock(evaluator_mutex);
+        if (!idle_evaluators.empty()) {
+            evaluator = move(idle_evaluators.back());
+            idle_evaluators.pop_back();
+        }
+    }
+    if (!evaluator)
+        evaluator = utils::make_unique_ptr<AxiomEvaluator>(task_proxy);
+    evaluator->evaluate(buffer, state_packer, op_id);
+    lock_guard<mutex> lock(evaluator_mutex);
+    idle_evaluators.push_back(move(evaluator));
+}
+
+StateID ShardedStateRegistry::insert_state(const PackedStateBin *buffer) {
+    int_hash_set::HashType hash = hash_state_data(buffer, get_bins_per_state());
+    int shard_index = get_shard(hash);
+    Shard &shard = *shards[shard_index];
+    unique_lock<shared_mutex> lock(shard.mutex, defer_lock);
+    if (!lock.try_lock()) {
+        ++shard.num_contended_inserts;
+        lock.lock();
+    }
+    /*
+      Like StateRegistry, we tentatively add the state to the pool and
+      remove it again if it turns out to be a duplicate, because the hash
+      set can only compare states that are in the pool.
+    */
+    shard.state_data_pool.push_back(buffer);
+    int local_id = shard.state_data_pool.size() - 1;
+    pair<int, bool> result = shard.registered_states.insert(local_id, hash);
+    if (!result.second) {
+        shard.state_data_pool.pop_back();
+    }
+    assert(shard.registered_states.size() == static_cast<int>(shard.state_data_pool.size()));
+    return StateID(result.first * num_shards + shard_index);
+}
+
+GlobalState ShardedStateRegistry::lookup_state(StateID id) const {
+    const Shard &shard = *shards[id.value % num_shards];
+    const PackedStateBin *buffer;
+    {
+        shared_lock<shared_mutex> lock(shard.mutex);
+        buffer = shard.state_data_pool[id.value / num_shards];
+    }
+    return GlobalState(buffer, decoder, id);
+}
+
+const GlobalState &ShardedStateRegistry::get_initial_state() {
+    call_once(initial_state_flag, [this]() {
+            vector<PackedStateBin> buffer(get_bins_per_state(), 0);
+            State initial_state = task_proxy.get_initial_state();
+            for (size_t i = 0; i < initial_state.size(); ++i) {
+                state_packer.set(buffer.data(), i, initial_state[i].get_value());
+            }
+            StateID id = insert_state(buffer.data());
+            cached_initial_state = utils::make_unique_ptr<GlobalState>(lookup_state(id));
+        });
+    return *cached_initial_state;
+}
+
+GlobalState ShardedStateRegistry::get_successor_state(
+    const GlobalState &predecessor, const OperatorProxy &op) {
+    assert(!op.is_axiom());
+    assert(&predecessor.get_registry() == &decoder);
+    // Reused across calls to avoid an allocation per successor.
+    thread_local vector<PackedStateBin> buffer;
+    const PackedStateBin *predecessor_data = predecessor.get_packed_buffer();
+    buffer.assign(predecessor_data, predecessor_data + get_bins_per_state());
+    operator_effects.apply(op.get_id(), predecessor_data, buffer.data());
+    evaluate_axioms(buffer.data(), op.get_id());
+    return lookup_state(insert_state(buffer.data()));
+}
+
+size_t ShardedStateRegistry::size() const {
+    size_t total = 0;
+    for (const auto &shard : shards) {
+        shared_lock<shared_mutex> lock(shard->mutex);
+        total += shard->registered_states.size();
+    }
+    return total;
+}
+
+int ShardedStateRegistry::get_state_size_in_bytes() const {
+    return get_bins_per_state() * sizeof(PackedStateBin);
+}
+
+void ShardedStateRegistry::print_statistics() const {
+    size_t min_size = numeric_limits<size_t>::max();
+    size_t max_size = 0;
+    long long contended = 0;
+    for (const auto &shard : shards) {
+        shared_lock<shared_mutex> lock(shard->mutex);
+        size_t shard_size = shard->registered_states.size();
+        min_size = min(min_size, shard_size);
+        max_size = max(max_size, shard_size);
+        contended += shard->num_contended_inserts;
+    }
+    cout << "Number of registered states: " << size() << endl;
+    cout << "Number of registry shards: " << num_shards << endl;
+    cout << "States per shard: " << min_size << " to " << max_size << endl;
+    cout << "Contended inserts: " << contended << endl;
+}
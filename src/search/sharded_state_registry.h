@@ -0,0 +1,147 @@
+#ifndef SHARDED_STATE_REGISTRY_H
+#define SHARDED_STATE_REGISTRY_H
+
+#include "abstract_task.h"
+#include "global_state.h"
+#include "state_id.h"
+#include "state_registry.h"
+
+#include "algorithms/int_hash_set.h"
+#include "algorithms/int_packer.h"
+#include "algorithms/segmented_vector.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+class AxiomEvaluator;
+
+/*
+  A state registry that can be used from several threads at the same time.
+
+  States are partitioned into shards by the hash of their packed data.
+  Each shard has its own state pool and hash set, protected by its own
+  lock, so threads only contend when they register states that fall into
+  the same shard. Successor states are built and hashed in a per-thread
+  buffer before any lock is taken; the exclusive lock of a shard is only
+  held to insert into its hash set. Lookups take the shared lock just
+  long enough to find the state data, which never moves once it is
+  registered.
+
+  The ID of the i-th state of shard s is i * num_shards + s, so IDs are
+  unique across all shards and stay roughly dense.
+
+  The GlobalStates returned by this class refer to an empty StateRegistry
+  for the same task, which they use to decode their values. This keeps
+  GlobalState and everything that reads states unchanged, but it also
+  means that PerStateInformation cannot be used with these states.
+  Per-state data of a parallel search has to be kept by the threads
+  themselves, keyed by StateID.
+
+  So far only the registry_benchmark search engine uses this class.
+*/
+class ShardedStateRegistry {
+    struct ShardHash {
+        const segmented_vector::SegmentedArrayVector<PackedStateBin> *state_data_pool;
+        int state_size;
+        int_hash_set::HashType operator()(int id) const;
+    };
+
+    struct ShardEqual {
+        const segmented_vector::SegmentedArrayVector<PackedStateBin> *state_data_pool;
+        int state_size;
+        bool operator()(int lhs, int rhs) const;
+    };
+
+    using StateIDSet = int_hash_set::IntHashSet<ShardHash, ShardEqual>;
+
+    // Shards are aligned to cache lines so that threads working on
+    // different shards do not share the lines holding the locks.
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        segmented_vector::SegmentedArrayVector<PackedStateBin> state_data_pool;
+        StateIDSet registered_states;
+        std::atomic<long long> num_contended_inserts;
+
+        explicit Shard(int state_size);
+    };
+
+    TaskProxy task_proxy;
+    const int_packer::IntPacker &state_packer;
+    const compiled_effects::CompiledEffects &operator_effects;
+    const bool task_has_axioms;
+    const int num_shards;
+    // Only used by the GlobalStates of this registry to decode values.
+    StateRegistry decoder;
+    std::vector<std::unique_ptr<Shard>> shards;
+
+    /*
+      AxiomEvaluator keeps scratch data in its members, so every thread
+      needs its own. Evaluators are handed out from a pool that grows to
+      the number of threads evaluating axioms at the same time.
+    */
+    std::mutex evaluator_mutex;
+    std::vector<std::unique_ptr<AxiomEvaluator>> idle_evaluators;
+
+    std::once_flag initial_state_flag;
+    std::unique_ptr<GlobalState> cached_initial_state;
+
+    int get_bins_per_state() const;
+    int get_shard(int_hash_set::HashType hash) const;
+    void evaluate_axioms(PackedStateBin *buffer, int op_id);
+    // Registers the state in the buffer unless it is already known.
+    StateID insert_state(const PackedStateBin *buffer);
+public:
+    ShardedStateRegistry(const TaskProxy &task_proxy, int num_shards);
+    ~ShardedStateRegistry();
+
+    ShardedStateRegistry(const ShardedStateRegistry &) = delete;
+    ShardedStateRegistry &operator=(const ShardedStateRegistry &) = delete;
+
+    const TaskProxy &get_task_proxy() const {
+        return task_proxy;
+    }
+
+    int get_num_variables() const {
+        return decoder.get_num_variables();
+    }
+
+    int get_num_shards() const {
+        return num_shards;
+    }
+
+    // All of the following methods may be called concurrently.
+
+    /*
+      Returns the state that was registered at the given ID. The ID must
+      refer to a state in this registry.
+    */
+    GlobalState lookup_state(StateID id) const;
+
+    /*
+      Returns a reference to the initial state and registers it if this
+      was not done before.
+    */
+    const GlobalState &get_initial_state();
+
+    /*
+      Returns the state that results from applying op to predecessor and
+      registers it if this was not done before. The predecessor must be a
+      state of this registry.
+    */
+    GlobalState get_successor_state(const GlobalState &predecessor, const OperatorProxy &op);
+
+    /*
+      Returns the number of states registered so far. While other threads
+      register states, the result is only a snapshot.
+    */
+    size_t size() const;
+
+    int get_state_size_in_bytes() const;
+
+    void print_statistics() const;
+};
+
+#endif
@@ -5,6 +5,8 @@
 
 #include "task_utils/task_properties.h"
 
+#include <algorithm>
+
 // #define TRACKSTATEREG
 
 #ifdef TRACKSTATEREG
@@ -20,33 +22,44 @@ using namespace std;
 
 StateRegistry::StateIDSemanticHash::StateIDSemanticHash(
             const segmented_vector::SegmentedArrayVector<PackedStateBin> *state_data_pool,
+            const segmented_vector::SegmentedVector<int_hash_set::HashType> *state_hashes,
             int state_size)
             : state_data_pool(state_data_pool),
+              state_hashes(state_hashes),
               state_size(state_size)
 {
 }
 
 StateRegistry::StateIDSemanticHash::StateIDSemanticHash(const StateIDSemanticHash &sh)
 		    :state_data_pool(sh.state_data_pool),
+		     state_hashes(sh.state_hashes),
 		     state_size(sh.state_size)
 {
 }
 
 
+static int_hash_set::HashType hash_state_data(const PackedStateBin *data, int state_size)
+{
+	utils::HashState hash_state;
+	for (int i = 0; i < state_size; ++i) {
+		hash_state.feed(data[i]);
+	}
+	return hash_state.get_hash32();
+}
+
 int_hash_set::HashType StateRegistry::StateIDSemanticHash::operator()(int id) const
  {
-	 const PackedStateBin *data = (*state_data_pool)[id];
-	 utils::HashState hash_state;
-	 for (int i = 0; i < state_size; ++i) {
-		 hash_state.feed(data[i]);
-	 }
-	 return hash_state.get_hash32();
+	 if (state_hashes)
+		 return (*state_hashes)[id];
+	 return hash_state_data((*state_data_pool)[id], state_size);
  }
 
 StateRegistry::StateIDSemanticHash &StateRegistry::StateIDSemanticHash::operator=(StateIDSemanticHash &&sh)
 {
 	state_data_pool = sh.state_data_pool;
 	sh.state_data_pool = nullptr;
+	state_hashes = sh.state_hashes;
+	sh.state_hashes = nullptr;
 	state_size = std::move(sh.state_size);
 	return *this;
 }
@@ -80,14 +93,17 @@ StateRegistry::StateIDSemanticEqual &StateRegistry::StateIDSemanticEqual::operat
 	return *this;
 }
 
-StateRegistry::StateRegistry(const TaskProxy &task_proxy)
+StateRegistry::StateRegistry(const TaskProxy &task_proxy, bool incremental_hashing)
     : task_proxy(task_proxy),
       state_packer(task_properties::g_state_packers[task_proxy]),
+      operator_effects(&compiled_effects::g_compiled_effects[task_proxy]),
       axiom_evaluator(g_axiom_evaluators[task_proxy]),
       num_variables(task_proxy.get_variables().size()),
+      zobrist_hash(incremental_hashing ? &zobrist_hash::g_zobrist_hashes[task_proxy] : nullptr),
       state_data_pool(get_bins_per_state()),
       registered_states(
-          StateIDSemanticHash(&state_data_pool, get_bins_per_state()),
+          StateIDSemanticHash(&state_data_pool, incremental_hashing ? &state_hashes : nullptr,
+                              get_bins_per_state()),
           StateIDSemanticEqual(&state_data_pool, get_bins_per_state())),
       cached_initial_state(0) {
 }
@@ -100,14 +116,19 @@ StateRegistry &StateRegistry::operator=(StateRegistry &&sr)
 
 	task_proxy = std::move(sr.task_proxy);
 	const_cast<int_packer::IntPacker &>(state_packer) = std::move(sr.state_packer);
+	operator_effects = sr.operator_effects;
 	axiom_evaluator = sr.axiom_evaluator;
 	*(const_cast<int*>(&num_variables)) = std::move(sr.num_variables);
+	zobrist_hash = sr.zobrist_hash;
 	state_data_pool = std::move(sr.state_data_pool);
+	state_hashes = std::move(sr.state_hashes);
 	registered_states = std::move(sr.registered_states);
 	// 'hasher' and 'equal' both have a pointer to the
 	// state_data_pool in the registry itself, which has to be
 	// updated seperately here.
 	registered_states.get_hasher().state_data_pool = &state_data_pool;
+	if (zobrist_hash)
+		registered_states.get_hasher().state_hashes = &state_hashes;
 	registered_states.get_equal().state_data_pool = &state_data_pool;
 	cached_initial_state = std::move(sr.cached_initial_state);
 
@@ -130,15 +151,59 @@ StateID StateRegistry::insert_id_or_pop_state() {
       state data pool.
     */
     StateID id(state_data_pool.size() - 1);
-    pair<int, bool> result = registered_states.insert(id.value);
+    return insert_id_or_pop_state(registered_states.get_hasher()(id.value));
+}
+
+StateID StateRegistry::insert_id_or_pop_state(int_hash_set::HashType hash) {
+    StateID id(state_data_pool.size() - 1);
+    pair<int, bool> result = registered_states.insert(id.value, hash);
     bool is_new_entry = result.second;
     if (!is_new_entry) {
         state_data_pool.pop_back();
+        if (zobrist_hash)
+            state_hashes.pop_back();
     }
     assert(registered_states.size() == static_cast<int>(state_data_pool.size()));
     return StateID(result.first);
 }
 
+void StateRegistry::push_full_hash() {
+    if (zobrist_hash) {
+        state_hashes.push_back(
+            zobrist_hash->hash(state_data_pool[state_data_pool.size() - 1]));
+    }
+}
+
+void StateRegistry::push_successor_hash(const GlobalState &predecessor, const OperatorProxy &op) {
+    if (!zobrist_hash)
+        return;
+    if (&predecessor.get_registry() != this) {
+        push_full_hash();
+        return;
+    }
+    state_hashes.push_back(get_successor_hash(
+        state_hashes[predecessor.get_id().value], predecessor.get_packed_buffer(),
+        state_data_pool[state_data_pool.size() - 1], op.get_id()));
+}
+
+int_hash_set::HashType StateRegistry::get_successor_hash(
+    int_hash_set::HashType predecessor_hash, const PackedStateBin *predecessor_data,
+    const PackedStateBin *buffer, int op_id) const {
+    assert(zobrist_hash);
+    int_hash_set::HashType hash = predecessor_hash;
+    compiled_effects::CompiledEffects::BinRange written =
+        operator_effects->get_written_bins(op_id);
+    for (int bin : written)
+        hash = zobrist_hash->update(hash, predecessor_data, buffer, bin);
+    // The axioms may change further bins; those the operator may write
+    // are already up to date.
+    for (int bin : zobrist_hash->get_derived_bins()) {
+        if (find(written.begin(), written.end(), bin) == written.end())
+            hash = zobrist_hash->update(hash, predecessor_data, buffer, bin);
+    }
+    return hash;
+}
+
 GlobalState StateRegistry::lookup_state(StateID id) const {
     return GlobalState(state_data_pool[id.value], *this, id);
 }
@@ -156,6 +221,7 @@ const GlobalState &StateRegistry::get_initial_state() {
         state_data_pool.push_back(buffer);
         // buffer is copied by push_back
         delete[] buffer;
+        push_full_hash();
         StateID id = insert_id_or_pop_state();
         cached_initial_state = new GlobalState(lookup_state(id));
     }
@@ -167,15 +233,69 @@ const GlobalState &StateRegistry::get_initial_state() {
 //     operating on state buffers (PackedStateBin *).
 GlobalState StateRegistry::get_successor_state(const GlobalState &predecessor, const OperatorProxy &op) {
     assert(!op.is_axiom());
-    state_data_pool.push_back(predecessor.get_packed_buffer());
+    const PackedStateBin *predecessor_data = predecessor.get_packed_buffer();
+    state_data_pool.push_back(predecessor_data);
     PackedStateBin *buffer = state_data_pool[state_data_pool.size() - 1];
-    for (EffectProxy effect : op.get_effects()) {
-        if (does_fire(effect, predecessor)) {
-            FactPair effect_pair = effect.get_fact().get_pair();
-            state_packer.set(buffer, effect_pair.var, effect_pair.value);
+    operator_effects->apply(op.get_id(), predecessor_data, buffer);
+    axiom_evaluator.evaluate(buffer, state_packer, op.get_id());
+    push_successor_hash(predecessor, op);
+    StateID id = insert_id_or_pop_state();
+    return lookup_state(id);
+}
+
+void StateRegistry::get_successor_states(
+    const vector<StateID> &parents, const vector<OperatorID> &operators,
+    const vector<int> &operator_offsets, vector<StateID> &successors) {
+    assert(operator_offsets.size() == parents.size() + 1);
+    assert(operator_offsets.back() == static_cast<int>(operators.size()));
+    int bins_per_state = get_bins_per_state();
+    batch_data.resize(operators.size() * bins_per_state);
+    batch_hashes.resize(operators.size());
+
+    /*
+      Build and hash all successors first, prefetching the bucket of
+      each, so that the buckets are in cache by the time the successors
+      are inserted.
+    */
+    for (size_t i = 0; i < parents.size(); ++i) {
+        const PackedStateBin *parent_data = state_data_pool[parents[i].value];
+        for (int j = operator_offsets[i]; j < operator_offsets[i + 1]; ++j) {
+            int op_id = operators[j].get_index();
+            PackedStateBin *buffer = &batch_data[j * bins_per_state];
+            copy(parent_data, parent_data + bins_per_state, buffer);
+            operator_effects->apply(op_id, parent_data, buffer);
+            axiom_evaluator.evaluate(buffer, state_packer, op_id);
+            if (zobrist_hash)
+                batch_hashes[j] = get_successor_hash(
+                    state_hashes[parents[i].value], parent_data, buffer, op_id);
+            else
+                batch_hashes[j] = hash_state_data(buffer, bins_per_state);
+            registered_states.prefetch(batch_hashes[j]);
         }
     }
-    axiom_evaluator.evaluate(buffer, state_packer);
+
+    successors.clear();
+    successors.reserve(operators.size());
+    for (size_t j = 0; j < operators.size(); ++j) {
+        state_data_pool.push_back(&batch_data[j * bins_per_state]);
+        if (zobrist_hash)
+            state_hashes.push_back(batch_hashes[j]);
+        successors.push_back(insert_id_or_pop_state(batch_hashes[j]));
+    }
+}
+
+void StateRegistry::get_successor_data(
+    const GlobalState &predecessor, const OperatorProxy &op, PackedStateBin *buffer) const {
+    assert(!op.is_axiom());
+    const PackedStateBin *predecessor_data = predecessor.get_packed_buffer();
+    copy(predecessor_data, predecessor_data + get_bins_per_state(), buffer);
+    operator_effects->apply(op.get_id(), predecessor_data, buffer);
+    axiom_evaluator.evaluate(buffer, state_packer, op.get_id());
+}
+
+GlobalState StateRegistry::register_state(const PackedStateBin *buffer) {
+    state_data_pool.push_back(buffer);
+    push_full_hash();
     StateID id = insert_id_or_pop_state();
     return lookup_state(id);
 }
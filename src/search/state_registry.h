@@ -12,7 +12,11 @@
 #include "algorithms/subscriber.h"
 #include "utils/hash.h"
 
+#include "task_utils/compiled_effects.h"
+#include "task_utils/zobrist_hash.h"
+
 #include <set>
+#include <vector>
 
 /*
   Overview of classes relevant to storing and working with registered states.
@@ -114,12 +118,17 @@ class StateRegistry : public subscriber::SubscriberService<StateRegistry>
 	// state_data_pool instead of a reference.  I changed it to a
 	// pointer for better move semantics.  Moving a reference
 	// would call the copy assignment.
+	//
+	// With incremental hashing, the hashes of the states are kept
+	// in state_hashes and only looked up here.
 	struct StateIDSemanticHash
 	{
 		segmented_vector::SegmentedArrayVector<PackedStateBin> const *state_data_pool;
+		segmented_vector::SegmentedVector<int_hash_set::HashType> const *state_hashes;
 		int state_size;
 		StateIDSemanticHash(
 			segmented_vector::SegmentedArrayVector<PackedStateBin> const *state_data_pool,
+			segmented_vector::SegmentedVector<int_hash_set::HashType> const *state_hashes,
 			int state_size);
 		StateIDSemanticHash(const StateIDSemanticHash &sh);
 
@@ -153,18 +162,43 @@ class StateRegistry : public subscriber::SubscriberService<StateRegistry>
 
     TaskProxy task_proxy;
     const int_packer::IntPacker &state_packer;
+    // A pointer rather than a reference so that move assignment can reseat it.
+    const compiled_effects::CompiledEffects *operator_effects;
     AxiomEvaluator &axiom_evaluator;
     const int num_variables;
+    // Null unless the states are hashed incrementally.
+    const zobrist_hash::ZobristHash *zobrist_hash;
 
     segmented_vector::SegmentedArrayVector<PackedStateBin> state_data_pool;
+    // The hash of every state in state_data_pool, if hashed incrementally.
+    segmented_vector::SegmentedVector<int_hash_set::HashType> state_hashes;
     StateIDSet registered_states;
 
     GlobalState *cached_initial_state;
 
+    // Scratch space of get_successor_states, kept to reuse the memory.
+    std::vector<PackedStateBin> batch_data;
+    std::vector<int_hash_set::HashType> batch_hashes;
+
     StateID insert_id_or_pop_state();
-    int get_bins_per_state() const;
+    // Like insert_id_or_pop_state, given the hash of the last state.
+    StateID insert_id_or_pop_state(int_hash_set::HashType hash);
+    // Adds the hash of the last state of state_data_pool if hashed incrementally.
+    void push_full_hash();
+    void push_successor_hash(const GlobalState &predecessor, const OperatorProxy &op);
+    int_hash_set::HashType get_successor_hash(
+        int_hash_set::HashType predecessor_hash, const PackedStateBin *predecessor,
+        const PackedStateBin *buffer, int op_id) const;
 public:
-    explicit StateRegistry(const TaskProxy &task_proxy);
+    /*
+      With incremental_hashing, registered states are hashed with Zobrist
+      keys (see ZobristHash) and the hashes are stored alongside the
+      states, 4 bytes per state. The hash of a successor then follows
+      from the hash of its predecessor and the bins the operator and the
+      axioms may write, which saves rehashing the whole state for tasks
+      with many variables.
+    */
+    explicit StateRegistry(const TaskProxy &task_proxy, bool incremental_hashing = false);
     ~StateRegistry();
 
 	StateRegistry &operator=(StateRegistry &&sr);
@@ -200,6 +234,45 @@ public:
     */
     GlobalState get_successor_state(const GlobalState &predecessor, const OperatorProxy &op);
 
+    /*
+      Registers the successors of several states in one pass. For the
+      i-th state of parents, the operators in positions
+      [operator_offsets[i], operator_offsets[i + 1]) of operators are
+      applied, so operator_offsets has one entry more than parents (see
+      SuccessorGenerator::generate_applicable_ops). The IDs of the
+      successors are written to successors, in the order of operators.
+
+      This has the same result as calling get_successor_state for every
+      parent and operator in turn. All successors are built and hashed
+      before the first one is inserted, so the lookups of their hash
+      buckets can overlap. That only pays off for batches of many parents
+      whose buckets are not in cache; for a single parent, prefer
+      get_successor_state, which does not copy the successors.
+    */
+    void get_successor_states(const std::vector<StateID> &parents,
+                              const std::vector<OperatorID> &operators,
+                              const std::vector<int> &operator_offsets,
+                              std::vector<StateID> &successors);
+
+    /*
+      Writes the packed data of the state that results from applying op to
+      predecessor into buffer, without registering it. The buffer must hold
+      get_bins_per_state() bins. Together with register_state, this allows
+      parallel searches to hand states over between the registries of
+      different threads.
+    */
+    void get_successor_data(const GlobalState &predecessor, const OperatorProxy &op,
+                            PackedStateBin *buffer) const;
+
+    /*
+      Returns the state with the given packed data and registers it if this
+      was not done before. The data must have been packed for the task of
+      this registry.
+    */
+    GlobalState register_state(const PackedStateBin *buffer);
+
+    int get_bins_per_state() const;
+
     /*
       Returns the number of states registered so far.
     */
@@ -0,0 +1,108 @@
+#include "compiled_effects.h"
+
+#include "task_properties.h"
+
+#include "../task_proxy.h"
+
+#include "../utils/memory.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+using namespace std;
+
+namespace compiled_effects {
+CompiledEffects::CompiledEffects(const TaskProxy &task_proxy) {
+    const int_packer::IntPacker &state_packer =
+        task_properties::g_state_packers[task_proxy];
+    OperatorsProxy operators = task_proxy.get_operators();
+    write_offsets.reserve(operators.size() + 1);
+    conditional_offsets.reserve(operators.size() + 1);
+    written_bin_offsets.reserve(operators.size() + 1);
+    write_offsets.push_back(0);
+    conditional_offsets.push_back(0);
+    written_bin_offsets.push_back(0);
+
+    for (OperatorProxy op : operators) {
+        EffectsProxy effects = op.get_effects();
+
+        // The last unconditional effect on each variable; an earlier
+        // conditional effect on it is overwritten in any case.
+        unordered_map<int, int> last_unconditional;
+        for (size_t i = 0; i < effects.size(); ++i) {
+            EffectProxy effect = effects[i];
+            if (effect.get_conditions().empty())
+                last_unconditional[effect.get_fact().get_variable().get_id()] = i;
+        }
+
+        // Index into writes of the merged write for each bin.
+        unordered_map<int, int> bin_writes;
+        for (size_t i = 0; i < effects.size(); ++i) {
+            EffectProxy effect = effects[i];
+            FactPair fact = effect.get_fact().get_pair();
+            const int_packer::VariableInfo &info = state_packer.get_variable_info(fact.var);
+            Bin value_bits = static_cast<Bin>(fact.value) << info.get_shift();
+            EffectConditionsProxy effect_conditions = effect.get_conditions();
+
+            if (effect_conditions.empty()) {
+                auto inserted = bin_writes.emplace(info.get_bin_index(), writes.size());
+                if (inserted.second)
+                    writes.push_back({info.get_bin_index(), ~Bin(0), 0});
+                BinWrite &write = writes[inserted.first->second];
+                write.keep_mask &= info.get_clear_mask();
+                write.set_bits = (write.set_bits & info.get_clear_mask()) | value_bits;
+                continue;
+            }
+
+            auto overwritten = last_unconditional.find(fact.var);
+            if (overwritten != last_unconditional.end() &&
+                overwritten->second > static_cast<int>(i))
+                continue;
+
+            ConditionalWrite conditional;
+            conditional.write = {info.get_bin_index(), info.get_clear_mask(), value_bits};
+            conditional.conditions_begin = conditions.size();
+            for (FactProxy condition : effect_conditions) {
+                FactPair condition_pair = condition.get_pair();
+                const int_packer::VariableInfo &condition_info =
+                    state_packer.get_variable_info(condition_pair.var);
+                conditions.push_back(
+                    {condition_info.get_bin_index(), condition_info.get_read_mask(),
+                     static_cast<Bin>(condition_pair.value) << condition_info.get_shift()});
+            }
+            conditional.conditions_end = conditions.size();
+            conditional_writes.push_back(conditional);
+        }
+
+        int first_written_bin = written_bins.size();
+        auto add_written_bin = [&](int bin) {
+                auto begin = written_bins.begin() + first_written_bin;
+                if (find(begin, written_bins.end(), bin) == written_bins.end())
+                    written_bins.push_back(bin);
+            };
+        for (int i = write_offsets.back(); i < static_cast<int>(writes.size()); ++i)
+            add_written_bin(writes[i].bin);
+        for (int i = conditional_offsets.back(); i < static_cast<int>(conditional_writes.size()); ++i)
+            add_written_bin(conditional_writes[i].write.bin);
+
+        write_offsets.push_back(writes.size());
+        conditional_offsets.push_back(conditional_writes.size());
+        written_bin_offsets.push_back(written_bins.size());
+    }
+}
+
+bool CompiledEffects::holds(const ConditionalWrite &effect, const Bin *predecessor) const {
+    for (int i = effect.conditions_begin; i < effect.conditions_end; ++i) {
+        const BinTest &test = conditions[i];
+        if ((predecessor[test.bin] & test.read_mask) != test.bits)
+            return false;
+    }
+    return true;
+}
+
+PerTaskInformation<CompiledEffects> g_compiled_effects(
+    [](const TaskProxy &task_proxy) {
+        return utils::make_unique_ptr<CompiledEffects>(task_proxy);
+    }
+    );
+}
@@ -0,0 +1,112 @@
+#ifndef TASK_UTILS_COMPILED_EFFECTS_H
+#define TASK_UTILS_COMPILED_EFFECTS_H
+
+#include "../per_task_information.h"
+
+#include "../algorithms/int_packer.h"
+
+#include <vector>
+
+class TaskProxy;
+
+namespace compiled_effects {
+using Bin = int_packer::Bin;
+
+/*
+  The effects of all operators of a task, translated into writes on the
+  bins of packed states so that operators can be applied to a packed
+  buffer without going through the task interface.
+
+  For every operator, the unconditional effects are merged into one
+  write per bin they touch: bin = (bin & keep_mask) | set_bits.
+  Conditional effects keep one write each, together with the range of
+  their conditions in a shared table. A condition is a (bin, read_mask,
+  bits) test on the predecessor, which is the data the effect conditions
+  refer to.
+
+  Applying an operator this way has the same result as setting the
+  values of the firing effects one after another. In particular, a
+  conditional effect on a variable that a later unconditional effect of
+  the same operator overwrites has no effect and is dropped.
+*/
+class CompiledEffects {
+    struct BinWrite {
+        int bin;
+        Bin keep_mask;
+        Bin set_bits;
+    };
+
+    struct BinTest {
+        int bin;
+        Bin read_mask;
+        Bin bits;
+    };
+
+    struct ConditionalWrite {
+        BinWrite write;
+        int conditions_begin;
+        int conditions_end;
+    };
+
+    // The entries of operator i are those in [offsets[i], offsets[i + 1]).
+    std::vector<int> write_offsets;
+    std::vector<BinWrite> writes;
+    std::vector<int> conditional_offsets;
+    std::vector<ConditionalWrite> conditional_writes;
+    std::vector<BinTest> conditions;
+    // The bins each operator may write, without duplicates.
+    std::vector<int> written_bin_offsets;
+    std::vector<int> written_bins;
+
+    static void apply_write(const BinWrite &write, Bin *buffer) {
+        Bin &bin = buffer[write.bin];
+        bin = (bin & write.keep_mask) | write.set_bits;
+    }
+
+    bool holds(const ConditionalWrite &effect, const Bin *predecessor) const;
+public:
+    explicit CompiledEffects(const TaskProxy &task_proxy);
+
+    class BinRange {
+        const int *first;
+        const int *last;
+    public:
+        BinRange(const int *first, const int *last)
+            : first(first), last(last) {
+        }
+        const int *begin() const {return first;}
+        const int *end() const {return last;}
+    };
+
+    /*
+      The bins that applying the operator with the given ID may change,
+      for code that needs to know where a successor differs from its
+      predecessor.
+    */
+    BinRange get_written_bins(int op_id) const {
+        const int *data = written_bins.data();
+        return BinRange(data + written_bin_offsets[op_id],
+                        data + written_bin_offsets[op_id + 1]);
+    }
+
+    /*
+      Applies the effects of the operator with the given ID to buffer,
+      which must hold a copy of the predecessor's data. The conditions
+      of conditional effects are tested on predecessor, so the two must
+      not be the same.
+    */
+    void apply(int op_id, const Bin *predecessor, Bin *buffer) const {
+        for (int i = write_offsets[op_id]; i < write_offsets[op_id + 1]; ++i)
+            apply_write(writes[i], buffer);
+        for (int i = conditional_offsets[op_id]; i < conditional_offsets[op_id + 1]; ++i) {
+            const ConditionalWrite &effect = conditional_writes[i];
+            if (holds(effect, predecessor))
+                apply_write(effect.write, buffer);
+        }
+    }
+};
+
+extern PerTaskInformation<CompiledEffects> g_compiled_effects;
+}
+
+#endif
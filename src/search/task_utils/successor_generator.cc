@@ -5,12 +5,18 @@
 
 #include "../abstract_task.h"
 #include "../global_state.h"
+#include "../state_registry.h"
+
+#include "../utils/memory.h"
+#include "../utils/system.h"
+
+#include <iostream>
 
 using namespace std;
 
 namespace successor_generator {
-SuccessorGenerator::SuccessorGenerator(const TaskProxy &task_proxy)
-    : root(SuccessorGeneratorFactory(task_proxy).create()) {
+SuccessorGenerator::SuccessorGenerator(const TaskProxy &task_proxy, GeneratorKind kind)
+    : root(SuccessorGeneratorFactory(task_proxy).create(kind)) {
 }
 
 SuccessorGenerator::~SuccessorGenerator() = default;
@@ -25,5 +31,44 @@ void SuccessorGenerator::generate_applicable_ops(
     root->generate_applicable_ops(state, applicable_ops);
 }
 
+void SuccessorGenerator::generate_applicable_ops(
+    const StateRegistry &registry, const vector<StateID> &states,
+    vector<OperatorID> &applicable_ops, vector<int> &offsets) const {
+    applicable_ops.clear();
+    offsets.clear();
+    offsets.reserve(states.size() + 1);
+    offsets.push_back(0);
+    for (StateID id : states) {
+        root->generate_applicable_ops(registry.lookup_state(id), applicable_ops);
+        offsets.push_back(applicable_ops.size());
+    }
+}
+
 PerTaskInformation<SuccessorGenerator> g_successor_generators;
+
+static PerTaskInformation<SuccessorGenerator> g_flat_successor_generators(
+    [](const TaskProxy &task_proxy) {
+        return utils::make_unique_ptr<SuccessorGenerator>(
+            task_proxy, GeneratorKind::FLAT);
+    });
+
+static PerTaskInformation<SuccessorGenerator> g_bitset_successor_generators(
+    [](const TaskProxy &task_proxy) {
+        return utils::make_unique_ptr<SuccessorGenerator>(
+            task_proxy, GeneratorKind::BITSET);
+    });
+
+SuccessorGenerator &get_successor_generator(
+    const TaskProxy &task_proxy, GeneratorKind kind) {
+    switch (kind) {
+    case GeneratorKind::TREE:
+        return g_successor_generators[task_proxy];
+    case GeneratorKind::FLAT:
+        return g_flat_successor_generators[task_proxy];
+    case GeneratorKind::BITSET:
+        return g_bitset_successor_generators[task_proxy];
+    }
+    cerr << "unknown successor generator kind" << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+}
 }
@@ -9,16 +9,38 @@
 class GlobalState;
 class OperatorID;
 class State;
+class StateID;
+class StateRegistry;
 class TaskProxy;
 
 namespace successor_generator {
 class GeneratorBase;
 
+/*
+  How the successor generator is represented (see
+  successor_generator_internals.h). All kinds generate the same operators
+  in the same order.
+
+  TREE: a tree of polymorphic nodes. This is the default since it was
+    the fastest of the three on the tasks we measured.
+  FLAT: the same tree, flattened into one array of tagged nodes.
+  BITSET: for every fact, a bitset of the operators whose preconditions
+    it is compatible with; the applicable operators are the
+    intersection over the facts of the state. Falls back to FLAT if the
+    bitsets would be large.
+*/
+enum class GeneratorKind {
+    TREE,
+    FLAT,
+    BITSET
+};
+
 class SuccessorGenerator {
     std::unique_ptr<GeneratorBase> root;
 
 public:
-    explicit SuccessorGenerator(const TaskProxy &task_proxy);
+    explicit SuccessorGenerator(
+        const TaskProxy &task_proxy, GeneratorKind kind = GeneratorKind::TREE);
     /*
       We cannot use the default destructor (implicitly or explicitly)
       here because GeneratorBase is a forward declaration and the
@@ -31,9 +53,24 @@ public:
     // Transitional method, used until the search is switched to the new task interface.
     void generate_applicable_ops(
         const GlobalState &state, std::vector<OperatorID> &applicable_ops) const;
+
+    /*
+      Generates the applicable operators of several registered states in
+      one pass. The operators of the i-th state end up in positions
+      [offsets[i], offsets[i + 1]) of applicable_ops, so offsets gets one
+      entry more than states. Both vectors are cleared first. The result
+      is in the form StateRegistry::get_successor_states expects.
+    */
+    void generate_applicable_ops(
+        const StateRegistry &registry, const std::vector<StateID> &states,
+        std::vector<OperatorID> &applicable_ops, std::vector<int> &offsets) const;
 };
 
 extern PerTaskInformation<SuccessorGenerator> g_successor_generators;
+
+// The successor generator of the given kind, built on first use.
+extern SuccessorGenerator &get_successor_generator(
+    const TaskProxy &task_proxy, GeneratorKind kind);
 }
 
 #endif
@@ -107,6 +107,10 @@ public:
     int get_value(int depth) const {
         return precondition[depth].value;
     }
+
+    const vector<FactPair> &get_precondition() const {
+        return precondition;
+    }
 };
 
 
@@ -270,6 +274,174 @@ GeneratorPtr SuccessorGeneratorFactory::construct_recursive(
     return construct_fork(move(nodes));
 }
 
+int SuccessorGeneratorFactory::construct_flat_recursive(
+    int depth, OperatorRange range, vector<int> &code) const {
+    /*
+      This makes the same decisions as construct_recursive, except that
+      there is only one kind of leaf and sparse switches keep sorted
+      values instead of a hash map. Children are appended before their
+      parents, so their positions are known when the parent is written.
+    */
+    vector<int> nodes;
+    OperatorGrouper grouper_by_var(
+        operator_infos, depth, GroupOperatorsBy::VAR, range);
+    while (!grouper_by_var.done()) {
+        auto var_group = grouper_by_var.next();
+        int var = var_group.first;
+        OperatorRange var_range = var_group.second;
+
+        if (var == -1) {
+            if (var_range.span() == 1) {
+                nodes.push_back(GeneratorFlat::get_operator_child(
+                                    operator_infos[var_range.begin].get_op()));
+                continue;
+            }
+            nodes.push_back(code.size());
+            code.push_back(GeneratorFlat::LEAF);
+            code.push_back(var_range.span());
+            for (int i = var_range.begin; i < var_range.end; ++i)
+                code.push_back(operator_infos[i].get_op().get_index());
+            continue;
+        }
+
+        vector<pair<int, int>> values_and_children;
+        OperatorGrouper grouper_by_value(
+            operator_infos, depth, GroupOperatorsBy::VALUE, var_range);
+        while (!grouper_by_value.done()) {
+            auto value_group = grouper_by_value.next();
+            values_and_children.emplace_back(
+                value_group.first,
+                construct_flat_recursive(depth + 1, value_group.second, code));
+        }
+
+        int num_children = values_and_children.size();
+        int var_domain = task_proxy.get_variables()[var].get_domain_size();
+        nodes.push_back(code.size());
+        if (num_children == 1) {
+            code.push_back(GeneratorFlat::SINGLE_SWITCH);
+            code.push_back(var);
+            code.push_back(values_and_children[0].first);
+            code.push_back(values_and_children[0].second);
+        } else if (var_domain <= 2 * num_children) {
+            code.push_back(GeneratorFlat::VECTOR_SWITCH);
+            code.push_back(var);
+            code.push_back(var_domain);
+            int children_begin = code.size();
+            code.resize(code.size() + var_domain, GeneratorFlat::NO_CHILD);
+            for (const auto &item : values_and_children)
+                code[children_begin + item.first] = item.second;
+        } else {
+            code.push_back(GeneratorFlat::SORTED_SWITCH);
+            code.push_back(var);
+            code.push_back(num_children);
+            // The grouper visits the values in increasing order.
+            for (const auto &item : values_and_children)
+                code.push_back(item.first);
+            for (const auto &item : values_and_children)
+                code.push_back(item.second);
+        }
+    }
+
+    if (nodes.size() == 1)
+        return nodes[0];
+    /* As in construct_fork, this includes the case of no children,
+       which can (only) happen for the root for tasks with no operators. */
+    int fork = code.size();
+    code.push_back(GeneratorFlat::FORK);
+    code.push_back(nodes.size());
+    code.insert(code.end(), nodes.begin(), nodes.end());
+    return fork;
+}
+
+GeneratorPtr SuccessorGeneratorFactory::construct_flat() const {
+    vector<int> code;
+    int root = construct_flat_recursive(
+        0, OperatorRange(0, operator_infos.size()), code);
+    code.shrink_to_fit();
+    return utils::make_unique_ptr<GeneratorFlat>(move(code), root);
+}
+
+vector<int> SuccessorGeneratorFactory::get_precondition_vars() const {
+    vector<bool> has_precondition(task_proxy.get_variables().size(), false);
+    for (const OperatorInfo &op_info : operator_infos) {
+        for (const FactPair &fact : op_info.get_precondition())
+            has_precondition[fact.var] = true;
+    }
+    vector<int> precondition_vars;
+    for (size_t var = 0; var < has_precondition.size(); ++var) {
+        if (has_precondition[var])
+            precondition_vars.push_back(var);
+    }
+    return precondition_vars;
+}
+
+/*
+  The bitset generator ANDs one bitset per variable with preconditions
+  for every state and keeps one per fact of these variables. We use it
+  if the former stays below what the tree traversal typically costs and
+  the latter is small enough to stay in cache.
+*/
+static const int MAX_BITSET_WORDS_PER_STATE = 256;
+static const int MAX_BITSET_WORDS = 1 << 15;
+
+bool SuccessorGeneratorFactory::bitsets_are_small() const {
+    long long num_words = (operator_infos.size() + GeneratorBitset::BITS_PER_WORD - 1) /
+        GeneratorBitset::BITS_PER_WORD;
+    long long num_facts = 0;
+    vector<int> precondition_vars = get_precondition_vars();
+    for (int var : precondition_vars)
+        num_facts += task_proxy.get_variables()[var].get_domain_size();
+    return !operator_infos.empty() &&
+           precondition_vars.size() * num_words <= MAX_BITSET_WORDS_PER_STATE &&
+           num_facts * num_words <= MAX_BITSET_WORDS;
+}
+
+GeneratorPtr SuccessorGeneratorFactory::construct_bitset() const {
+    using Word = GeneratorBitset::Word;
+    const int bits_per_word = GeneratorBitset::BITS_PER_WORD;
+    VariablesProxy variables = task_proxy.get_variables();
+    int num_operators = operator_infos.size();
+    int num_words = (num_operators + bits_per_word - 1) / bits_per_word;
+
+    vector<int> precondition_vars = get_precondition_vars();
+    vector<int> value_offsets;
+    vector<int> offset_by_var(variables.size(), -1);
+    int num_bitset_words = 0;
+    for (int var : precondition_vars) {
+        value_offsets.push_back(num_bitset_words);
+        offset_by_var[var] = num_bitset_words;
+        num_bitset_words += variables[var].get_domain_size() * num_words;
+    }
+
+    // Start with all operators compatible with all facts and rule out
+    // the values that contradict a precondition.
+    vector<Word> bitsets(num_bitset_words, ~Word(0));
+    vector<OperatorID> operators;
+    operators.reserve(num_operators);
+    for (int op = 0; op < num_operators; ++op) {
+        const OperatorInfo &op_info = operator_infos[op];
+        operators.push_back(op_info.get_op());
+        Word op_bit = Word(1) << (op % bits_per_word);
+        int op_word = op / bits_per_word;
+        for (const FactPair &fact : op_info.get_precondition()) {
+            int domain_size = variables[fact.var].get_domain_size();
+            for (int value = 0; value < domain_size; ++value) {
+                if (value != fact.value)
+                    bitsets[offset_by_var[fact.var] + value * num_words + op_word] &= ~op_bit;
+            }
+        }
+    }
+    // Clear the bits past the last operator.
+    if (num_operators % bits_per_word != 0) {
+        Word used_bits = (Word(1) << (num_operators % bits_per_word)) - 1;
+        for (size_t word = num_words - 1; word < bitsets.size(); word += num_words)
+            bitsets[word] &= used_bits;
+    }
+
+    return utils::make_unique_ptr<GeneratorBitset>(
+        move(operators), move(precondition_vars), move(value_offsets), move(bitsets));
+}
+
 static vector<FactPair> build_sorted_precondition(const OperatorProxy &op) {
     vector<FactPair> precond;
     precond.reserve(op.get_preconditions().size());
@@ -280,7 +452,7 @@ static vector<FactPair> build_sorted_precondition(const OperatorProxy &op) {
     return precond;
 }
 
-GeneratorPtr SuccessorGeneratorFactory::create() {
+GeneratorPtr SuccessorGeneratorFactory::create(GeneratorKind kind) {
     OperatorsProxy operators = task_proxy.get_operators();
     operator_infos.reserve(operators.size());
     for (OperatorProxy op : operators) {
@@ -291,8 +463,23 @@ GeneratorPtr SuccessorGeneratorFactory::create() {
        This amounts to breaking ties by operator ID. */
     stable_sort(operator_infos.begin(), operator_infos.end());
 
-    OperatorRange full_range(0, operator_infos.size());
-    GeneratorPtr root = construct_recursive(0, full_range);
+    /* All kinds generate the applicable operators in the order of
+       operator_infos: the tree visits the groups of operators in the
+       order in which they appear there. */
+    if (kind == GeneratorKind::BITSET && !bitsets_are_small()) {
+        kind = GeneratorKind::FLAT;
+    }
+
+    GeneratorPtr root;
+    if (kind == GeneratorKind::TREE) {
+        OperatorRange full_range(0, operator_infos.size());
+        root = construct_recursive(0, full_range);
+    } else if (kind == GeneratorKind::FLAT) {
+        root = construct_flat();
+    } else {
+        assert(kind == GeneratorKind::BITSET);
+        root = construct_bitset();
+    }
     operator_infos.clear();
     return root;
 }
@@ -1,6 +1,8 @@
 #ifndef TASK_UTILS_SUCCESSOR_GENERATOR_FACTORY_H
 #define TASK_UTILS_SUCCESSOR_GENERATOR_FACTORY_H
 
+#include "successor_generator.h"
+
 #include <memory>
 #include <vector>
 
@@ -26,11 +28,20 @@ class SuccessorGeneratorFactory {
     GeneratorPtr construct_switch(
         int switch_var_id, ValuesAndGenerators values_and_generators) const;
     GeneratorPtr construct_recursive(int depth, OperatorRange range) const;
+
+    // Appends the nodes for the range to code and returns the position
+    // of the topmost one, see GeneratorFlat.
+    int construct_flat_recursive(
+        int depth, OperatorRange range, std::vector<int> &code) const;
+    GeneratorPtr construct_flat() const;
+    std::vector<int> get_precondition_vars() const;
+    bool bitsets_are_small() const;
+    GeneratorPtr construct_bitset() const;
 public:
     explicit SuccessorGeneratorFactory(const TaskProxy &task_proxy);
     // Destructor cannot be implicit because OperatorInfo is forward-declared.
     ~SuccessorGeneratorFactory();
-    GeneratorPtr create();
+    GeneratorPtr create(GeneratorKind kind = GeneratorKind::TREE);
 };
 }
 
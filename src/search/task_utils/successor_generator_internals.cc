@@ -3,6 +3,7 @@
 #include "../global_state.h"
 #include "../task_proxy.h"
 
+#include <algorithm>
 #include <cassert>
 
 using namespace std;
@@ -22,7 +23,9 @@ using namespace std;
   - Going further down this route, on the more extreme end of the
     spectrum, we could use a "byte-code" style representation, where
     the successor generator is just a long vector of ints combining
-    information about node type with node payload.
+    information about node type with node payload. (GeneratorFlat now
+    does this, along the lines of the first encoding below, with the
+    hash switches replaced by sorted switches.)
 
     For example, we could represent different node types as follows,
     where BINARY_FORK etc. are symbolic constants for tagging node
@@ -225,4 +228,160 @@ void GeneratorLeafSingle::generate_applicable_ops(
     const GlobalState &, vector<OperatorID> &applicable_ops) const {
     applicable_ops.push_back(applicable_operator);
 }
+
+static inline int get_value(const State &state, int var_id) {
+    return state[var_id].get_value();
+}
+
+static inline int get_value(const GlobalState &state, int var_id) {
+    return state[var_id];
+}
+
+// Index of the lowest set bit; bits must be nonzero.
+static inline int get_lowest_bit(uint64_t bits) {
+    assert(bits);
+#ifdef __GNUC__
+    return __builtin_ctzll(bits);
+#else
+    int bit = 0;
+    for (; !(bits & 1); bits >>= 1)
+        ++bit;
+    return bit;
+#endif
+}
+
+const int GeneratorFlat::NO_CHILD;
+
+GeneratorFlat::GeneratorFlat(vector<int> &&code, int root)
+    : code(move(code)),
+      root(root) {
+}
+
+template<typename StateType>
+void GeneratorFlat::generate(
+    int node, const StateType &state, vector<OperatorID> &applicable_ops) const {
+    /*
+      The children of forks wait on a stack, in reverse order so that
+      they are visited in order. Forks with more children than fit on
+      the stack visit them recursively.
+    */
+    const int max_pending = 256;
+    int pending[max_pending];
+    int num_pending = 0;
+    while (true) {
+        if (node < 0) {
+            if (node != NO_CHILD)
+                applicable_ops.emplace_back(get_child_operator_index(node));
+        } else {
+            const int *data = &code[node];
+            switch (data[0]) {
+            case FORK: {
+                int num_children = data[1];
+                if (num_pending + num_children <= max_pending) {
+                    for (int i = num_children - 1; i >= 0; --i)
+                        pending[num_pending++] = data[2 + i];
+                } else {
+                    for (int i = 0; i < num_children; ++i)
+                        generate(data[2 + i], state, applicable_ops);
+                }
+                break;
+            }
+            case VECTOR_SWITCH:
+                node = data[3 + get_value(state, data[1])];
+                continue;
+            case SORTED_SWITCH: {
+                int value = get_value(state, data[1]);
+                int num_children = data[2];
+                const int *values = data + 3;
+                const int *values_end = values + num_children;
+                const int *pos = lower_bound(values, values_end, value);
+                if (pos != values_end && *pos == value) {
+                    node = values_end[pos - values];
+                    continue;
+                }
+                break;
+            }
+            case SINGLE_SWITCH:
+                if (get_value(state, data[1]) == data[2]) {
+                    node = data[3];
+                    continue;
+                }
+                break;
+            case LEAF:
+                // See GeneratorLeafVector for the reason for using push_back.
+                for (int i = 0; i < data[1]; ++i)
+                    applicable_ops.emplace_back(data[2 + i]);
+                break;
+            default:
+                assert(false);
+            }
+        }
+        if (num_pending == 0)
+            return;
+        node = pending[--num_pending];
+    }
+}
+
+void GeneratorFlat::generate_applicable_ops(
+    const State &state, vector<OperatorID> &applicable_ops) const {
+    generate(root, state, applicable_ops);
+}
+
+void GeneratorFlat::generate_applicable_ops(
+    const GlobalState &state, vector<OperatorID> &applicable_ops) const {
+    generate(root, state, applicable_ops);
+}
+
+const int GeneratorBitset::BITS_PER_WORD;
+
+GeneratorBitset::GeneratorBitset(
+    vector<OperatorID> &&operators,
+    vector<int> &&precondition_vars,
+    vector<int> &&value_offsets,
+    vector<Word> &&bitsets)
+    : operators(move(operators)),
+      num_words((this->operators.size() + BITS_PER_WORD - 1) / BITS_PER_WORD),
+      precondition_vars(move(precondition_vars)),
+      value_offsets(move(value_offsets)),
+      bitsets(move(bitsets)) {
+}
+
+template<typename StateType>
+void GeneratorBitset::generate(
+    const StateType &state, vector<OperatorID> &applicable_ops) const {
+    if (precondition_vars.empty()) {
+        applicable_ops.insert(applicable_ops.end(), operators.begin(), operators.end());
+        return;
+    }
+    // Reused across calls (and per thread) to avoid an allocation per state.
+    thread_local vector<Word> applicable;
+    const Word *first = &bitsets[value_offsets[0] +
+                                 get_value(state, precondition_vars[0]) * num_words];
+    applicable.assign(first, first + num_words);
+    Word *result = applicable.data();
+    for (size_t i = 1; i < precondition_vars.size(); ++i) {
+        const Word *bits = &bitsets[value_offsets[i] +
+                                    get_value(state, precondition_vars[i]) * num_words];
+        for (int word = 0; word < num_words; ++word)
+            result[word] &= bits[word];
+    }
+    for (int word = 0; word < num_words; ++word) {
+        Word bits = result[word];
+        while (bits) {
+            int bit = get_lowest_bit(bits);
+            applicable_ops.push_back(operators[word * BITS_PER_WORD + bit]);
+            bits &= bits - 1;
+        }
+    }
+}
+
+void GeneratorBitset::generate_applicable_ops(
+    const State &state, vector<OperatorID> &applicable_ops) const {
+    generate(state, applicable_ops);
+}
+
+void GeneratorBitset::generate_applicable_ops(
+    const GlobalState &state, vector<OperatorID> &applicable_ops) const {
+    generate(state, applicable_ops);
+}
 }
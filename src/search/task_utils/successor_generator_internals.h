@@ -3,6 +3,7 @@
 
 #include "../operator_id.h"
 
+#include <cstdint>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -111,6 +112,96 @@ public:
     virtual void generate_applicable_ops(
         const GlobalState &state, std::vector<OperatorID> &applicable_ops) const override;
 };
+
+/*
+  A whole successor generator tree in one vector of ints, so that it is
+  traversed without virtual calls and with good locality. A node is a
+  type tag followed by its payload:
+
+  - fork:          [FORK, n, child_1, ..., child_n]
+  - vector switch: [VECTOR_SWITCH, var_id, domain_size,
+                    child_for_value_0, ..., child_for_value_{domain_size - 1}]
+  - sorted switch: [SORTED_SWITCH, var_id, k, value_1, ..., value_k,
+                    child_1, ..., child_k] with increasing values
+  - single switch: [SINGLE_SWITCH, var_id, value, child]
+  - leaf:          [LEAF, n, op_id_1, ..., op_id_n]
+
+  A child is the position of a node in the vector, NO_CHILD, or, for a
+  leaf with a single operator, the operator itself, encoded as a
+  negative number by get_operator_child. Most leaves hold a single
+  operator, so this saves visiting a node for most of them.
+*/
+class GeneratorFlat : public GeneratorBase {
+public:
+    enum NodeType {
+        FORK,
+        VECTOR_SWITCH,
+        SORTED_SWITCH,
+        SINGLE_SWITCH,
+        LEAF
+    };
+    static const int NO_CHILD = -1;
+
+    static int get_operator_child(OperatorID op) {
+        return -2 - op.get_index();
+    }
+private:
+    static int get_child_operator_index(int child) {
+        return -2 - child;
+    }
+
+    std::vector<int> code;
+    int root;
+
+    template<typename StateType>
+    void generate(int node, const StateType &state,
+                  std::vector<OperatorID> &applicable_ops) const;
+public:
+    GeneratorFlat(std::vector<int> &&code, int root);
+    virtual void generate_applicable_ops(
+        const State &state, std::vector<OperatorID> &applicable_ops) const override;
+    // Transitional method, used until the search is switched to the new task interface.
+    virtual void generate_applicable_ops(
+        const GlobalState &state, std::vector<OperatorID> &applicable_ops) const override;
+};
+
+/*
+  Tests the preconditions of all operators at once. The operators are
+  numbered in the order in which they are generated. For every value of
+  every variable that occurs in a precondition, there is a bitset of
+  the operators that do not require a different value of that variable.
+  The applicable operators are the intersection of these bitsets for
+  the values of the state, which is a loop of word-wise ANDs that the
+  compiler vectorizes. This only pays off as long as the bitsets are
+  short, i.e. for tasks with few operators.
+*/
+class GeneratorBitset : public GeneratorBase {
+public:
+    using Word = std::uint64_t;
+    static const int BITS_PER_WORD = 64;
+private:
+    std::vector<OperatorID> operators;
+    int num_words;
+    std::vector<int> precondition_vars;
+    // The bitset for value v of precondition_vars[i] starts at
+    // bitsets[value_offsets[i] + v * num_words].
+    std::vector<int> value_offsets;
+    std::vector<Word> bitsets;
+
+    template<typename StateType>
+    void generate(const StateType &state, std::vector<OperatorID> &applicable_ops) const;
+public:
+    GeneratorBitset(
+        std::vector<OperatorID> &&operators,
+        std::vector<int> &&precondition_vars,
+        std::vector<int> &&value_offsets,
+        std::vector<Word> &&bitsets);
+    virtual void generate_applicable_ops(
+        const State &state, std::vector<OperatorID> &applicable_ops) const override;
+    // Transitional method, used until the search is switched to the new task interface.
+    virtual void generate_applicable_ops(
+        const GlobalState &state, std::vector<OperatorID> &applicable_ops) const override;
+};
 }
 
 #endif
@@ -0,0 +1,57 @@
+#include "zobrist_hash.h"
+
+#include "task_properties.h"
+
+#include "../task_proxy.h"
+
+#include "../utils/memory.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace std;
+
+namespace zobrist_hash {
+static const unsigned int KEY_SEED = 2011;
+
+ZobristHash::ZobristHash(const TaskProxy &task_proxy) {
+    const int_packer::IntPacker &state_packer =
+        task_properties::g_state_packers[task_proxy];
+    mt19937 rng(KEY_SEED);
+    bin_variables.resize(state_packer.get_num_bins());
+    bit_owners.resize(state_packer.get_num_bins());
+    VariablesProxy variables = task_proxy.get_variables();
+    key_offsets.reserve(variables.size());
+    for (VariableProxy var : variables) {
+        key_offsets.push_back(keys.size());
+        for (int value = 0; value < var.get_domain_size(); ++value)
+            keys.push_back(rng());
+
+        const int_packer::VariableInfo &info = state_packer.get_variable_info(var.get_id());
+        vector<PackedVariable> &packed = bin_variables[info.get_bin_index()];
+        for (size_t bit = 0; bit < sizeof(Bin) * 8; ++bit) {
+            if (info.get_read_mask() & (Bin(1) << bit))
+                bit_owners[info.get_bin_index()][bit] = packed.size();
+        }
+        packed.push_back({var.get_id(), info.get_shift(), info.get_read_mask()});
+        if (var.is_derived() &&
+            find(derived_bins.begin(), derived_bins.end(), info.get_bin_index()) == derived_bins.end())
+            derived_bins.push_back(info.get_bin_index());
+    }
+}
+
+HashType ZobristHash::hash(const Bin *buffer) const {
+    HashType hash = 0;
+    for (size_t bin = 0; bin < bin_variables.size(); ++bin) {
+        for (const PackedVariable &variable : bin_variables[bin])
+            hash ^= get_key(variable, buffer[bin]);
+    }
+    return hash;
+}
+
+PerTaskInformation<ZobristHash> g_zobrist_hashes(
+    [](const TaskProxy &task_proxy) {
+        return utils::make_unique_ptr<ZobristHash>(task_proxy);
+    }
+    );
+}
@@ -0,0 +1,93 @@
+#ifndef TASK_UTILS_ZOBRIST_HASH_H
+#define TASK_UTILS_ZOBRIST_HASH_H
+
+#include "../per_task_information.h"
+
+#include "../algorithms/int_hash_set.h"
+#include "../algorithms/int_packer.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+class TaskProxy;
+
+namespace zobrist_hash {
+using Bin = int_packer::Bin;
+using HashType = int_hash_set::HashType;
+
+/*
+  Zobrist hashing of packed states: every fact of the task gets a random
+  key and the hash of a state is the XOR of the keys of its facts.
+
+  Since XOR is its own inverse, the hash of a successor follows from the
+  hash of its predecessor by swapping the keys of the variables that
+  changed, so only the bins that an operator (or the axioms) can write
+  have to be looked at instead of the whole state.
+
+  The keys are drawn from a fixed seed, so hashes and thus the layout of
+  hash tables do not change between runs.
+*/
+class ZobristHash {
+    struct PackedVariable {
+        int var;
+        int shift;
+        Bin read_mask;
+    };
+
+    std::vector<int> key_offsets;
+    std::vector<HashType> keys;
+    // The variables packed into each bin.
+    std::vector<std::vector<PackedVariable>> bin_variables;
+    // For each bin and bit, the index in bin_variables of the variable
+    // that bit belongs to.
+    std::vector<std::array<std::uint8_t, sizeof(Bin) * 8>> bit_owners;
+    // The bins that hold derived variables.
+    std::vector<int> derived_bins;
+
+    // Index of the lowest set bit; bits must not be 0.
+    static int get_lowest_bit(Bin bits) {
+#ifdef __GNUC__
+        static_assert(sizeof(Bin) == sizeof(unsigned int), "Bin is not an unsigned int");
+        return __builtin_ctz(bits);
+#else
+        int bit = 0;
+        for (; !(bits & 1); bits >>= 1)
+            ++bit;
+        return bit;
+#endif
+    }
+
+    HashType get_key(const PackedVariable &variable, Bin bin) const {
+        return keys[key_offsets[variable.var] +
+                    ((bin & variable.read_mask) >> variable.shift)];
+    }
+public:
+    explicit ZobristHash(const TaskProxy &task_proxy);
+
+    HashType hash(const Bin *buffer) const;
+
+    /*
+      Updates the hash of predecessor to the hash of buffer, given that
+      the two can only differ in the given bin.
+    */
+    HashType update(HashType hash, const Bin *predecessor, const Bin *buffer, int bin) const {
+        Bin changed = predecessor[bin] ^ buffer[bin];
+        while (changed) {
+            int bit = get_lowest_bit(changed);
+            const PackedVariable &variable = bin_variables[bin][bit_owners[bin][bit]];
+            hash ^= get_key(variable, predecessor[bin]) ^ get_key(variable, buffer[bin]);
+            changed &= ~variable.read_mask;
+        }
+        return hash;
+    }
+
+    const std::vector<int> &get_derived_bins() const {
+        return derived_bins;
+    }
+};
+
+extern PerTaskInformation<ZobristHash> g_zobrist_hashes;
+}
+
+#endif
@@ -0,0 +1,63 @@
+#! /usr/bin/env python3
+import argparse
+import struct
+import sys
+
+argparser = argparse.ArgumentParser(description="convert aggregated h* data to the binary format read by the planner")
+argparser.add_argument("input", help="aggregated data file written by combine_hstar.py, combine_phstar.py, or combine_post.py")
+argparser.add_argument("output", help="binary output file")
+argparser.add_argument("--with-parent-h", action="store_true", help="the data was generated with combine_phstar.py")
+argparser.add_argument("--post", action="store_true", help="the data was generated with combine_post.py")
+args = argparser.parse_args()
+
+# These have to match the definitions in src/search/real_time/belief_data.h
+MAGIC = b"NANCYHS\0"
+VERSION = 1
+JUST_H, WITH_PARENT_H = 0, 1
+HEADER = struct.Struct("<8sIIIIQQ")
+FEATURE = struct.Struct("<iiqQQ")
+# h* data uses int counts, post expansion data long long counts.  The
+# samples are padded like HStarSample<CountT>.
+SAMPLE_INT = struct.Struct("<ii")
+SAMPLE_LONG = struct.Struct("<i4xq")
+
+kind = WITH_PARENT_H if args.with_parent_h else JUST_H
+sample = SAMPLE_LONG if args.post else SAMPLE_INT
+count_size = 8 if args.post else 4
+num_feature_values = 2 if args.with_parent_h else 1
+
+entries = {}
+with open(args.input) as f:
+    for line in f:
+        values = [int(s) for s in line.split()]
+        if not values:
+            continue
+        feature = tuple(values[:num_feature_values])
+        value_count = values[num_feature_values]
+        samples = values[num_feature_values + 1:]
+        if value_count == 0:
+            # the post expansion belief script sometimes generates empty
+            # distributions, the planner skips these as well
+            continue
+        if len(samples) % 2 != 0:
+            sys.exit("error: odd number of sample values for feature {}".format(feature))
+        if feature in entries:
+            sys.exit("error: duplicate feature {}".format(feature))
+        entries[feature] = (value_count, list(zip(samples[0::2], samples[1::2])))
+
+features = sorted(entries)
+with open(args.output, "wb") as f:
+    num_samples = sum(len(entries[feature][1]) for feature in features)
+    f.write(HEADER.pack(MAGIC, VERSION, kind, count_size, sample.size, len(features), num_samples))
+    first_sample = 0
+    for feature in features:
+        value_count, samples = entries[feature]
+        h = feature[0]
+        ph = feature[1] if args.with_parent_h else 0
+        f.write(FEATURE.pack(h, ph, value_count, first_sample, len(samples)))
+        first_sample += len(samples)
+    for feature in features:
+        for hstar, count in entries[feature][1]:
+            f.write(sample.pack(hstar, count))
+
+print("wrote {:d} features and {:d} samples to {}".format(len(features), num_samples, args.output), file=sys.stderr)
@@ -0,0 +1,324 @@
+// Aggregates the binary sample files written by the h* solvers with
+// sample_format=BINARY (see src/search/real_time/sample_file.h).
+//
+//   merge_samples hstar [-m RECORDS] FILE...
+//     Prints the aggregated h* data, like combine_hstar.py (or
+//     combine_phstar.py for files written with collect_parent_h=true).
+//
+//   merge_samples post HSTAR_DATA FILE...
+//     Prints the post-expansion data for the successors data files,
+//     like combine_post.py.  HSTAR_DATA is aggregated h* data without
+//     parent h.
+//
+// The h* samples are aggregated with an external merge sort, so memory
+// does not grow with the number of samples: the input is read in
+// chunks of at most RECORDS records, each chunk is sorted, collapsed to
+// counts and written to a temporary run, and all runs are combined
+// with a k-way merge.  Files that end in an incomplete record, e.g.
+// because the solver was killed, are read up to the last complete one.
+
+#include "../src/search/real_time/sample_file.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace real_time;
+
+namespace
+{
+
+[[noreturn]] void fail(std::string const &message)
+{
+	std::cerr << "merge_samples: " << message << std::endl;
+	std::exit(1);
+}
+
+// Sequential reader of the records of one sample file or run.
+template<typename Record>
+class RecordReader
+{
+	std::FILE *file;
+	std::vector<Record> buffer;
+	std::size_t position;
+public:
+	explicit RecordReader(std::FILE *file) : file(file), position(0) {}
+
+	bool next(Record &record)
+	{
+		if (position == buffer.size()) {
+			buffer.resize(1 << 14);
+			buffer.resize(std::fread(buffer.data(), sizeof(Record), buffer.size(), file));
+			position = 0;
+			if (buffer.empty())
+				return false;
+		}
+		record = buffer[position++];
+		return true;
+	}
+};
+
+std::FILE *open_sample_file(std::string const &file_name, SampleKind kind, SampleFileHeader &header)
+{
+	std::FILE *file = std::fopen(file_name.c_str(), "rb");
+	if (!file)
+		fail("could not open " + file_name);
+	if (std::fread(&header, sizeof(header), 1, file) != 1
+	    || std::memcmp(header.magic, sample_file_magic, sizeof(header.magic)) != 0)
+		fail(file_name + " is not a binary sample file");
+	if (header.version != sample_file_version)
+		fail(file_name + " has unsupported version " + std::to_string(header.version));
+	if (header.kind != kind)
+		fail(file_name + (kind == HStarSamples ? " does not hold h* samples" : " does not hold successors data"));
+	return file;
+}
+
+// A distinct (h, ph, h*) sample and how often it occurs.
+struct RunEntry
+{
+	std::int32_t h;
+	std::int32_t ph;
+	std::int32_t hstar;
+	std::int32_t unused;
+	long long count;
+
+	auto key() const { return std::make_tuple(h, ph, hstar); }
+};
+
+void write_run(std::vector<HStarRecord> &chunk, std::vector<std::FILE *> &runs)
+{
+	std::sort(chunk.begin(), chunk.end(), [](auto const &lhs, auto const &rhs) {
+		return std::tie(lhs.h, lhs.ph, lhs.hstar) < std::tie(rhs.h, rhs.ph, rhs.hstar);
+	});
+	std::vector<RunEntry> entries;
+	for (auto const &record : chunk) {
+		if (!entries.empty()
+		    && entries.back().key() == std::make_tuple(record.h, record.ph, record.hstar))
+			++entries.back().count;
+		else
+			entries.push_back({record.h, record.ph, record.hstar, 0, 1});
+	}
+	std::FILE *run = std::tmpfile();
+	if (!run || std::fwrite(entries.data(), sizeof(RunEntry), entries.size(), run) != entries.size())
+		fail("could not write a temporary run");
+	std::rewind(run);
+	runs.push_back(run);
+	chunk.clear();
+}
+
+void print_histogram_line(int h, int ph, bool with_parent_h, std::vector<std::pair<int, long long>> const &counts)
+{
+	long long value_count = 0;
+	for (auto const &[hstar, count] : counts)
+		value_count += count;
+	std::cout << h;
+	if (with_parent_h)
+		std::cout << " " << ph;
+	std::cout << " " << value_count;
+	for (auto const &[hstar, count] : counts)
+		std::cout << " " << hstar << " " << count;
+	std::cout << "\n";
+}
+
+int merge_hstar(std::size_t chunk_size, std::vector<std::string> const &file_names)
+{
+	std::vector<std::FILE *> runs;
+	std::vector<HStarRecord> chunk;
+	chunk.reserve(chunk_size);
+	bool with_parent_h = false;
+	long long num_records = 0;
+	for (std::size_t i = 0; i < file_names.size(); ++i) {
+		SampleFileHeader header;
+		std::FILE *file = open_sample_file(file_names[i], HStarSamples, header);
+		if (i == 0)
+			with_parent_h = header.with_parent_h;
+		else if (with_parent_h != bool(header.with_parent_h))
+			fail("the files mix samples with and without parent h");
+		RecordReader<HStarRecord> reader(file);
+		HStarRecord record;
+		while (reader.next(record)) {
+			if (!with_parent_h)
+				record.ph = 0;
+			chunk.push_back(record);
+			++num_records;
+			if (chunk.size() == chunk_size)
+				write_run(chunk, runs);
+		}
+		std::fclose(file);
+	}
+	if (!chunk.empty())
+		write_run(chunk, runs);
+	std::cerr << "merging " << num_records << " samples from " << runs.size() << " runs" << std::endl;
+
+	std::vector<RecordReader<RunEntry>> readers;
+	for (auto run : runs)
+		readers.emplace_back(run);
+	using Head = std::pair<RunEntry, std::size_t>;
+	auto const later = [](Head const &lhs, Head const &rhs) { return lhs.first.key() > rhs.first.key(); };
+	std::priority_queue<Head, std::vector<Head>, decltype(later)> heads(later);
+	for (std::size_t i = 0; i < readers.size(); ++i) {
+		RunEntry entry;
+		if (readers[i].next(entry))
+			heads.emplace(entry, i);
+	}
+
+	// entries arrive sorted by (h, ph, h*), so each line is complete
+	// once the next (h, ph) shows up
+	std::vector<std::pair<int, long long>> counts;
+	int h = 0;
+	int ph = 0;
+	while (!heads.empty()) {
+		auto const [entry, run] = heads.top();
+		heads.pop();
+		RunEntry next;
+		if (readers[run].next(next))
+			heads.emplace(next, run);
+		if (!counts.empty() && (entry.h != h || entry.ph != ph)) {
+			print_histogram_line(h, ph, with_parent_h, counts);
+			counts.clear();
+		}
+		h = entry.h;
+		ph = entry.ph;
+		if (!counts.empty() && counts.back().first == entry.hstar)
+			counts.back().second += entry.count;
+		else
+			counts.emplace_back(entry.hstar, entry.count);
+	}
+	if (!counts.empty())
+		print_histogram_line(h, ph, with_parent_h, counts);
+
+	for (auto run : runs)
+		std::fclose(run);
+	return 0;
+}
+
+// average h* per h value of aggregated h* data
+std::map<int, double> read_hstar_averages(std::string const &file_name, std::map<int, std::map<int, long long>> &hstar_data)
+{
+	std::ifstream in(file_name);
+	if (!in)
+		fail("could not open " + file_name);
+	std::string line;
+	while (std::getline(in, line)) {
+		std::istringstream ss(line);
+		int h;
+		long long value_count;
+		if (!(ss >> h >> value_count))
+			continue;
+		int hstar;
+		long long count;
+		while (ss >> hstar >> count)
+			hstar_data[h][hstar] += count;
+	}
+	std::map<int, double> averages;
+	for (auto const &[h, counts] : hstar_data) {
+		long long total = 0;
+		for (auto const &[hstar, count] : counts)
+			total += count;
+		double average = 0;
+		for (auto const &[hstar, count] : counts)
+			average += hstar * (static_cast<double>(count) / total);
+		averages[h] = average;
+	}
+	return averages;
+}
+
+int merge_post(std::string const &hstar_file, std::vector<std::string> const &file_names)
+{
+	std::map<int, std::map<int, long long>> hstar_data;
+	auto const averages = read_hstar_averages(hstar_file, hstar_data);
+
+	// h -> successor h -> action cost -> count of the successors a
+	// Nancy backup with the average h* values would pick
+	std::map<int, std::map<int, std::map<int, long long>>> best_successors;
+	long long num_states = 0;
+	for (auto const &file_name : file_names) {
+		SampleFileHeader header;
+		std::FILE *file = open_sample_file(file_name, SuccessorSamples, header);
+		RecordReader<SuccessorRecord> reader(file);
+		SuccessorRecord state;
+		while (reader.next(state)) {
+			double best_f = std::numeric_limits<double>::infinity();
+			int best_h = 0;
+			int best_cost = 0;
+			int i = 0;
+			SuccessorRecord successor;
+			for (; i < state.second && reader.next(successor); ++i) {
+				auto const it = averages.find(successor.second);
+				if (it == averages.end())
+					continue;
+				double const f = successor.first + it->second;
+				if (f < best_f) {
+					best_f = f;
+					best_h = successor.second;
+					best_cost = successor.first;
+				}
+			}
+			if (i < state.second)
+				break;
+			++num_states;
+			if (!std::isinf(best_f))
+				++best_successors[state.first][best_h][best_cost];
+		}
+		std::fclose(file);
+	}
+	std::cerr << "read the successors of " << num_states << " states" << std::endl;
+
+	for (auto const &[h, successors] : best_successors) {
+		std::map<int, long long> f_counts;
+		for (auto const &[succ_h, costs] : successors) {
+			for (auto const &[hstar, num_samples] : hstar_data.at(succ_h)) {
+				for (auto const &[cost, count] : costs)
+					f_counts[hstar + cost] += num_samples * count;
+			}
+		}
+		print_histogram_line(h, 0, false, std::vector<std::pair<int, long long>>(f_counts.begin(), f_counts.end()));
+	}
+	return 0;
+}
+
+void usage()
+{
+	std::cerr << "usage: merge_samples hstar [-m RECORDS] FILE...\n"
+		  << "       merge_samples post HSTAR_DATA FILE..." << std::endl;
+	std::exit(2);
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+	std::ios::sync_with_stdio(false);
+	if (argc < 3)
+		usage();
+	std::string const mode = argv[1];
+	int arg = 2;
+	if (mode == "hstar") {
+		std::size_t chunk_size = 1 << 22;
+		if (std::string(argv[arg]) == "-m") {
+			if (arg + 1 >= argc || std::atoll(argv[arg + 1]) <= 0)
+				usage();
+			chunk_size = std::atoll(argv[arg + 1]);
+			arg += 2;
+		}
+		if (arg >= argc)
+			usage();
+		return merge_hstar(chunk_size, std::vector<std::string>(argv + arg, argv + argc));
+	} else if (mode == "post") {
+		if (argc < 4)
+			usage();
+		return merge_post(argv[2], std::vector<std::string>(argv + 3, argv + argc));
+	}
+	usage();
+}